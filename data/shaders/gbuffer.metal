@@ -82,33 +82,38 @@ fragment GBufferData gbuffer_fragment(ColorInOut            in
                           constant    TextureInfo*          diffuseTextureInfos [[buffer(BufferIndexDiffuseInfo),   function_constant(hasTextures)]],
                           constant    TextureInfo*          normalTextureInfos  [[buffer(BufferIndexNormalInfo),    function_constant(hasTextures)]]) {
 
+	// Atlas pages are padded with wrapped texels, so the page itself is clamped
+	// and repeat addressing is done by wrapping the UV before the atlas transform
 	constexpr sampler linearSampler(mip_filter::linear,
 									mag_filter::linear,
 									min_filter::linear,
-									address::repeat);
+									address::clamp_to_edge);
 
-	// Sample the base color from the diffuse texture array
+	float2 wrappedUV = fract(in.tex_coord);
+	float2 uvDx = dfdx(in.tex_coord);
+	float2 uvDy = dfdy(in.tex_coord);
+
+	// Sample the base color from the diffuse texture atlas
 	half4 base_color_sample;
-	if (in.diffuseTextureIndex >= 0 && (uint)in.diffuseTextureIndex < baseColorMap.get_array_size()) {
-		int idx = in.diffuseTextureIndex;
-		float2 transformedUV = in.tex_coord *
-			(float2(diffuseTextureInfos[idx].width, diffuseTextureInfos[idx].height) /
-			 float2(baseColorMap.get_width(0), baseColorMap.get_height(0)));
+	if (hasTextures && in.diffuseTextureIndex >= 0 && in.diffuseTextureIndex < diffuseTextureInfos[0].count) {
+		TextureInfo info = diffuseTextureInfos[in.diffuseTextureIndex];
+		float2 atlasUV = info.uvOffset + wrappedUV * info.uvScale;
 
-		base_color_sample = baseColorMap.sample(linearSampler, transformedUV, in.diffuseTextureIndex);
+		// Gradients come from the unwrapped UV so the fract() seam doesn't force the smallest mip
+		base_color_sample = baseColorMap.sample(linearSampler, atlasUV, info.layer,
+												gradient2d(uvDx * info.uvScale, uvDy * info.uvScale));
 	} else {
         base_color_sample =  half4(half3(noTexColor), 1.0h);
 	}
 
-	// Sample the normal from the normal map texture array
+	// Sample the normal from the normal map texture atlas
 	half3 eye_normal = normalize(in.normal.xyz); // Default normal
-	if (hasTextures && in.normalTextureIndex >= 0 && (uint)in.normalTextureIndex < normalMap.get_array_size()) {
-		int idx = in.normalTextureIndex;
-		float2 transformedUV = in.tex_coord *
-			(float2(normalTextureInfos[idx].width, normalTextureInfos[idx].height) /
-			 float2(normalMap.get_width(0), normalMap.get_height(0)));
+	if (hasTextures && in.normalTextureIndex >= 0 && in.normalTextureIndex < normalTextureInfos[0].count) {
+		TextureInfo info = normalTextureInfos[in.normalTextureIndex];
+		float2 atlasUV = info.uvOffset + wrappedUV * info.uvScale;
 
-		half4 normal_sample = normalMap.sample(linearSampler, transformedUV, in.normalTextureIndex);
+		half4 normal_sample = normalMap.sample(linearSampler, atlasUV, info.layer,
+											   gradient2d(uvDx * info.uvScale, uvDy * info.uvScale));
 
 		// Calculate the tangent-space normal, and transform it to eye space
 		half3 tangent_normal = normalize((normal_sample.xyz * 2.0) - 1.0);
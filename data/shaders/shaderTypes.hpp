@@ -18,14 +18,16 @@ struct FrameData {
 	float sun_specular_intensity;
     float near_plane;
     float far_plane;
-    uint padding;
+    // Frames rendered before this one, for anything that changes from frame to frame
+    uint frame_index;
 	
 	// Vector group
 	simd::float4 sun_color;
 	simd::float4 sun_eye_direction;
 	
 	// Matrix group
-	simd::float4x4 _pad2;
+	// projection_matrix * view_matrix of the frame before, for reprojecting history
+	simd::float4x4 previous_view_projection_matrix;
 	simd::float4x4 _pad3;
     simd::float4x4 view_matrix_inverse;
 	simd::float4x4 scene_model_matrix;
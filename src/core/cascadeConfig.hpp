@@ -0,0 +1,9 @@
+#pragma once
+
+// Cascade layout shared by the renderer and the CPU reference engine
+
+// You can try different max cascade levels
+constexpr int MAX_CASCADE_LEVEL = 6;
+// You can't put any value of probe spacing and base ray
+constexpr int PROBE_SPACING = 4;
+constexpr int BASE_RAY = 16;
@@ -0,0 +1,325 @@
+#include "assetStreamer.hpp"
+#include "../taskScheduler.hpp"
+
+#include <cmath>
+
+bool AssetRequest::await_ready() {
+    // Completed before anyone awaited it
+    auto parked = streamer.parked.find(requestId);
+    if (parked == streamer.parked.end()) return false;
+
+    result = std::move(parked->second->result);
+    streamer.parked.erase(parked);
+    return true;
+}
+
+bool AssetRequest::await_suspend(std::coroutine_handle<> handle) {
+    AssetStreamer::RequestPtr request = streamer.find(requestId);
+    if (!request || request->waiter || request->callback) {
+        std::cerr << "Asset request #" << requestId << " cannot be awaited, it is unknown or already has a receiver" << std::endl;
+        result.id = requestId;
+        result.status = AssetStatus::Failed;
+        return false;
+    }
+
+    request->waiter = handle;
+    request->waiterResult = &result;
+    return true;
+}
+
+AssetStreamer::AssetStreamer(MTL::Device* device, MTL::VertexDescriptor* vertexDescriptor, int maxInFlight)
+: device(device)
+, vertexDescriptor(vertexDescriptor)
+, maxInFlight(std::max(maxInFlight, 1)) {
+}
+
+AssetStreamer::~AssetStreamer() {
+    for (auto& [id, request] : requests) {
+        cancel(id);
+    }
+    TaskScheduler::shared().waitUntil([this]() { return running.load() == 0; });
+
+    // Not update, a callback that makes a new request must not start a load any more
+    std::vector<RequestPtr> finished;
+    completed.drain([&](RequestPtr&& request) {
+        finished.push_back(std::move(request));
+    });
+    finished.insert(finished.end(), cancelledQueued.begin(), cancelledQueued.end());
+    cancelledQueued.clear();
+    inFlight = 0;
+
+    for (const RequestPtr& request : finished) {
+        complete(request);
+    }
+
+    for (auto& [id, request] : parked) {
+        delete request->result.mesh;
+    }
+}
+
+AssetRequestId AssetStreamer::requestMesh(const std::string& filePath, const MeshInfo& info, AssetPriority priority, Callback callback) {
+    RequestPtr request = std::make_shared<Request>();
+    request->kind = Kind::Mesh;
+    request->priority = priority;
+    request->filePath = filePath;
+    request->meshInfo = info;
+    request->callback = std::move(callback);
+    return submit(request);
+}
+
+AssetRequestId AssetStreamer::requestTextures(const std::vector<std::string>& filePaths, TextureType type, AssetPriority priority, Callback callback) {
+    RequestPtr request = std::make_shared<Request>();
+    request->kind = Kind::Textures;
+    request->priority = priority;
+    request->texturePaths = filePaths;
+    request->textureType = type;
+    request->callback = std::move(callback);
+    return submit(request);
+}
+
+AssetRequest AssetStreamer::loadMesh(const std::string& filePath, const MeshInfo& info, AssetPriority priority) {
+    return AssetRequest(*this, requestMesh(filePath, info, priority, nullptr));
+}
+
+AssetRequest AssetStreamer::loadTextures(const std::vector<std::string>& filePaths, TextureType type, AssetPriority priority) {
+    return AssetRequest(*this, requestTextures(filePaths, type, priority, nullptr));
+}
+
+AssetRequestId AssetStreamer::submit(RequestPtr request) {
+    request->id = nextId++;
+    requests[request->id] = request;
+    queues[static_cast<int>(request->priority)].push_back(request);
+    return request->id;
+}
+
+AssetStreamer::RequestPtr AssetStreamer::find(AssetRequestId id) const {
+    auto it = requests.find(id);
+    return it == requests.end() ? nullptr : it->second;
+}
+
+void AssetStreamer::setInterest(AssetRequestId id, simd::float3 center, float radius) {
+    if (RequestPtr request = find(id)) {
+        request->hasInterest = true;
+        request->interestCenter = center;
+        request->interestRadius = radius;
+    }
+}
+
+void AssetStreamer::setPriority(AssetRequestId id, AssetPriority priority) {
+    RequestPtr request = find(id);
+    if (!request || request->status != AssetStatus::Queued || request->priority == priority) return;
+
+    // The entry in the old queue is skipped once it comes up
+    request->priority = priority;
+    queues[static_cast<int>(priority)].push_back(request);
+}
+
+void AssetStreamer::cancel(AssetRequestId id) {
+    RequestPtr request = find(id);
+    if (!request || request->cancelRequested.load()) return;
+
+    request->cancelRequested = true;
+    if (request->status == AssetStatus::Queued) {
+        request->status = AssetStatus::Cancelled;
+        cancelledQueued.push_back(request);
+    }
+}
+
+void AssetStreamer::updateInterest(const Camera& camera) {
+    float tanHalfFov = std::tan(camera.fov * 0.5f * float(M_PI) / 180.0f);
+    // Same cone around the frustum diagonal the texture streamer uses
+    float halfDiagonal = std::atan(tanHalfFov * std::sqrt(1.0f + camera.aspectRatio * camera.aspectRatio));
+
+    std::vector<AssetRequestId> outOfRange;
+    for (auto& [id, request] : requests) {
+        if (!request->hasInterest || request->cancelRequested.load()) continue;
+
+        simd::float3 toCenter = request->interestCenter - camera.position;
+        float distance = simd::length(toCenter);
+        float radius = request->interestRadius;
+        float nearest = std::max(distance - radius, 0.0f);
+
+        if (nearest > ASSET_CANCEL_DISTANCE) {
+            outOfRange.push_back(id);
+            continue;
+        }
+
+        bool inView = distance <= radius;
+        if (!inView) {
+            float angle = std::acos(std::clamp(simd::dot(toCenter / distance, camera.front), -1.0f, 1.0f));
+            inView = angle <= halfDiagonal + std::asin(radius / distance);
+        }
+
+        AssetPriority priority = inView ? AssetPriority::Visible
+                               : nearest < ASSET_PREFETCH_DISTANCE ? AssetPriority::Prefetch
+                               : AssetPriority::Background;
+        setPriority(id, priority);
+    }
+
+    for (AssetRequestId id : outOfRange) {
+        cancel(id);
+    }
+}
+
+void AssetStreamer::update() {
+    std::vector<RequestPtr> finished;
+    completed.drain([&](RequestPtr&& request) {
+        inFlight--;
+        finished.push_back(std::move(request));
+    });
+    finished.insert(finished.end(), cancelledQueued.begin(), cancelledQueued.end());
+    cancelledQueued.clear();
+
+    // Fill the slots first, so loads freed this frame are not idle while the callbacks run
+    while (inFlight < maxInFlight) {
+        RequestPtr request = nextQueued(maxInFlight > 1 && inFlight >= maxInFlight - 1);
+        if (!request) break;
+        start(request);
+    }
+
+    // Callbacks and resumed coroutines may make or cancel requests, so nothing here
+    // iterates the request tables while they run
+    for (const RequestPtr& request : finished) {
+        complete(request);
+    }
+
+    updateStats();
+}
+
+AssetStreamer::RequestPtr AssetStreamer::nextQueued(bool visibleOnly) {
+    int classes = visibleOnly ? 1 : ASSET_PRIORITY_COUNT;
+    for (int priority = 0; priority < classes; priority++) {
+        std::deque<RequestPtr>& queue = queues[priority];
+        while (!queue.empty()) {
+            RequestPtr request = std::move(queue.front());
+            queue.pop_front();
+            if (request->status == AssetStatus::Queued && static_cast<int>(request->priority) == priority) {
+                return request;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void AssetStreamer::start(RequestPtr request) {
+    request->status = AssetStatus::Loading;
+    request->startTime = std::chrono::steady_clock::now();
+    inFlight++;
+    running++;
+    load(std::move(request));
+}
+
+AssetTask AssetStreamer::load(RequestPtr request) {
+    // The render thread only queues the task, everything below runs on a worker
+    co_await TaskScheduler::shared().schedule();
+
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+    if (!request->cancelRequested.load()) {
+        try {
+            if (request->kind == Kind::Mesh) {
+                loadMeshResult(*request);
+            } else {
+                loadTexturesResult(*request);
+            }
+        } catch (const std::exception& e) {
+            request->result.status = AssetStatus::Failed;
+            request->result.error = e.what();
+        }
+    }
+    pool->release();
+
+    completed.push(std::move(request));
+    // Last use of the streamer, the destructor may go ahead as soon as this drops to zero
+    running--;
+}
+
+void AssetStreamer::loadMeshResult(Request& request) {
+    Mesh* mesh = new Mesh(device, request.meshInfo);
+    try {
+        mesh->loadObj(request.filePath);
+    } catch (...) {
+        delete mesh;
+        throw;
+    }
+
+    if (mesh->vertexIndices.empty()) {
+        delete mesh;
+        request.result.status = AssetStatus::Failed;
+        request.result.error = "No geometry in " + request.filePath;
+        return;
+    }
+
+    // Parsing is the slow part, skip the buffers if the request was dropped meanwhile
+    if (request.cancelRequested.load()) {
+        delete mesh;
+        return;
+    }
+
+    mesh->createBuffers(vertexDescriptor);
+    mesh->defaultVertexAttributes();
+    request.result.mesh = mesh;
+    request.result.status = AssetStatus::Ready;
+}
+
+void AssetStreamer::loadTexturesResult(Request& request) {
+    std::vector<std::string> filePaths = request.texturePaths;
+    request.result.textures = TextureArray::acquire(filePaths, device, request.textureType);
+    if (request.result.textures && request.result.textures->texture) {
+        request.result.status = AssetStatus::Ready;
+    } else {
+        request.result.status = AssetStatus::Failed;
+        request.result.error = "No textures loaded";
+    }
+}
+
+void AssetStreamer::complete(const RequestPtr& request) {
+    AssetResult& result = request->result;
+    result.id = request->id;
+
+    // A result that arrives after its request was cancelled is not wanted any more
+    if (request->cancelRequested.load()) {
+        delete result.mesh;
+        result.mesh = nullptr;
+        result.textures.reset();
+        result.status = AssetStatus::Cancelled;
+    }
+    request->status = result.status;
+
+    if (result.status == AssetStatus::Ready) {
+        stats.completed++;
+        stats.lastLoadMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - request->startTime).count();
+    } else if (result.status == AssetStatus::Failed) {
+        stats.failed++;
+        std::cerr << "Error streaming asset #" << request->id << ": " << result.error << std::endl;
+    } else {
+        stats.cancelled++;
+    }
+
+    deliver(request);
+}
+
+void AssetStreamer::deliver(const RequestPtr& request) {
+    requests.erase(request->id);
+
+    if (request->callback) {
+        Callback callback = std::move(request->callback);
+        callback(std::move(request->result));
+    } else if (request->waiter) {
+        *request->waiterResult = std::move(request->result);
+        request->waiter.resume();
+    } else {
+        parked[request->id] = request;
+    }
+}
+
+void AssetStreamer::updateStats() {
+    for (int& count : stats.queued) {
+        count = 0;
+    }
+    for (const auto& [id, request] : requests) {
+        if (request->status == AssetStatus::Queued) {
+            stats.queued[static_cast<int>(request->priority)]++;
+        }
+    }
+    stats.loadsInFlight = inFlight;
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include <Metal/Metal.hpp>
+#include <coroutine>
+#include <functional>
+
+#include "mesh.hpp"
+#include "camera.hpp"
+#include "textureArray.hpp"
+#include "textureRegistry.hpp"
+#include "../mpscQueue.hpp"
+
+// Requests that load at the same time. The last slot only ever goes to a visible request,
+// so something that comes into view never waits behind a full queue of prefetches.
+constexpr int   ASSET_STREAMING_MAX_IN_FLIGHT = 4;
+// Out of view requests closer than this are prefetched, further ones load in the background
+constexpr float ASSET_PREFETCH_DISTANCE = 30.0f;
+// Requests further away than this are cancelled by updateInterest
+constexpr float ASSET_CANCEL_DISTANCE = 60.0f;
+
+// Lower values are started first
+enum class AssetPriority : uint8_t {
+    Visible,
+    Prefetch,
+    Background,
+};
+constexpr int ASSET_PRIORITY_COUNT = 3;
+
+enum class AssetStatus : uint8_t {
+    Queued,
+    Loading,
+    Ready,
+    Failed,
+    Cancelled,
+};
+
+using AssetRequestId = uint64_t;
+
+// What a request hands back on the render thread. Only the member of the requested kind is
+// set, and only when the status is Ready. The receiver owns the mesh.
+struct AssetResult {
+    AssetRequestId  id = 0;
+    AssetStatus     status = AssetStatus::Queued;
+    Mesh*           mesh = nullptr;
+    TextureHandle   textures;
+    std::string     error;
+};
+
+struct AssetStreamingStats {
+    int     queued[ASSET_PRIORITY_COUNT] = {};
+    int     loadsInFlight = 0;
+    int     completed = 0;
+    int     failed = 0;
+    int     cancelled = 0;
+    float   lastLoadMs = 0.0f;  // From the start of the load until the result reached the render thread
+};
+
+// Coroutine that starts right away and frees itself once it returns. The streamer runs its
+// loads as these, and callers use them to co_await assets.
+struct AssetTask {
+    struct promise_type {
+        AssetTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {
+            std::cerr << "Unhandled exception in an asset coroutine" << std::endl;
+            std::terminate();
+        }
+    };
+};
+
+class AssetStreamer;
+
+// Returned by AssetStreamer::loadMesh and loadTextures. co_await suspends until the request
+// completes and resumes on the render thread, inside AssetStreamer::update. Failed and
+// cancelled requests resume as well, so check the status of the result.
+class AssetRequest {
+public:
+    AssetRequestId id() const { return requestId; }
+
+    bool await_ready();
+    bool await_suspend(std::coroutine_handle<> handle);
+    AssetResult await_resume() { return std::move(result); }
+
+private:
+    friend class AssetStreamer;
+
+    AssetRequest(AssetStreamer& streamer, AssetRequestId requestId)
+    : streamer(streamer), requestId(requestId) {}
+
+    AssetStreamer&  streamer;
+    AssetRequestId  requestId;
+    AssetResult     result;
+};
+
+// Loads meshes and texture arrays at runtime without ever blocking the frame.
+//
+// Requests wait in one queue per priority class until a slot is free, then load as a
+// coroutine on the task scheduler. Parsing and buffer creation happen there, the finished
+// resources come back through a lock-free queue that update drains once a frame on the
+// render thread, which is also where completion callbacks run and awaiting coroutines
+// resume. Requests can be given a bounding sphere, updateInterest then moves them between
+// the priority classes as the camera moves and cancels the ones that fall out of range.
+//
+// Everything except the loads themselves happens on the render thread: making, awaiting
+// and cancelling requests, and update.
+class AssetStreamer {
+public:
+    using Callback = std::function<void(AssetResult)>;
+
+    AssetStreamer(MTL::Device* device, MTL::VertexDescriptor* vertexDescriptor, int maxInFlight = ASSET_STREAMING_MAX_IN_FLIGHT);
+    // Cancels everything and waits for loads in flight. Awaiting coroutines resume with
+    // their requests cancelled, results nobody picked up are released.
+    ~AssetStreamer();
+
+    AssetRequestId requestMesh(const std::string& filePath, const MeshInfo& info, AssetPriority priority, Callback callback);
+    AssetRequestId requestTextures(const std::vector<std::string>& filePaths, TextureType type, AssetPriority priority, Callback callback);
+
+    AssetRequest loadMesh(const std::string& filePath, const MeshInfo& info, AssetPriority priority);
+    AssetRequest loadTextures(const std::vector<std::string>& filePaths, TextureType type, AssetPriority priority);
+
+    // World space bounds the request is for, used by updateInterest
+    void setInterest(AssetRequestId id, simd::float3 center, float radius);
+    // Only changes requests that have not started loading yet
+    void setPriority(AssetRequestId id, AssetPriority priority);
+    // A queued request never starts, a loading one is dropped at its next stage or once it
+    // finishes. Either way it completes as cancelled in a following update.
+    void cancel(AssetRequestId id);
+
+    // Visible if the bounds are in view, prefetch or background by distance otherwise, and
+    // cancelled beyond ASSET_CANCEL_DISTANCE
+    void updateInterest(const Camera& camera);
+    // Hands back finished requests and starts queued ones. Never waits.
+    void update();
+
+    const AssetStreamingStats& getStats() const { return stats; }
+
+private:
+    friend class AssetRequest;
+
+    enum class Kind : uint8_t {
+        Mesh,
+        Textures,
+    };
+
+    struct Request {
+        AssetRequestId              id;
+        Kind                        kind;
+        AssetPriority               priority;
+        AssetStatus                 status = AssetStatus::Queued;
+        std::string                 filePath;
+        MeshInfo                    meshInfo;
+        std::vector<std::string>    texturePaths;
+        TextureType                 textureType = DIFFUSE;
+
+        bool                        hasInterest = false;
+        simd::float3                interestCenter = simd::float3{0.0f, 0.0f, 0.0f};
+        float                       interestRadius = 0.0f;
+
+        // Whoever receives the result, a callback or an awaiting coroutine. Requests that
+        // have neither when they complete are parked until they are awaited.
+        Callback                    callback;
+        std::coroutine_handle<>     waiter;
+        AssetResult*                waiterResult = nullptr;
+
+        // Set on the render thread, checked by the load between its stages
+        std::atomic<bool>           cancelRequested{false};
+        // Written by the load before it pushes the request onto the completion queue
+        AssetResult                 result;
+        std::chrono::steady_clock::time_point   startTime;
+    };
+
+    using RequestPtr = std::shared_ptr<Request>;
+
+    AssetRequestId submit(RequestPtr request);
+    RequestPtr find(AssetRequestId id) const;
+    RequestPtr nextQueued(bool visibleOnly);
+    void start(RequestPtr request);
+    AssetTask load(RequestPtr request);
+    void loadMeshResult(Request& request);
+    void loadTexturesResult(Request& request);
+    void complete(const RequestPtr& request);
+    void deliver(const RequestPtr& request);
+    void updateStats();
+
+    MTL::Device*            device;
+    MTL::VertexDescriptor*  vertexDescriptor;
+    int                     maxInFlight;
+
+    AssetRequestId                                      nextId = 1;
+    std::unordered_map<AssetRequestId, RequestPtr>      requests;
+    // May hold requests that moved to another class or already started, they are skipped
+    std::deque<RequestPtr>                              queues[ASSET_PRIORITY_COUNT];
+    std::vector<RequestPtr>                             cancelledQueued;
+    std::unordered_map<AssetRequestId, RequestPtr>      parked;
+    int                                                 inFlight = 0;
+
+    MpscQueue<RequestPtr>   completed;
+    // Loads that have not pushed their result yet, the destructor waits for these
+    std::atomic<int>        running{0};
+
+    AssetStreamingStats     stats;
+};
@@ -1,4 +1,6 @@
 #include "gltfLoader.hpp"
+#include "textureCache.hpp"
+#include "../fileReader.hpp"
 
 GLTFLoader::GLTFLoader(MTL::Device* device) : _device(device) {}
 
@@ -11,12 +13,21 @@ GLTFLoader::GLTFModel GLTFLoader::loadModel(const std::string& filepath) {
 	// Set up the callbacks before loading
 	loader.SetImageLoader(&GLTFLoader::LoadImageData, nullptr);
 	
+	// Buffers and images the file refers to are still loaded by tinygltf itself
+	std::vector<unsigned char> bytes;
+	if (!FileReader::shared().read(filepath, bytes)) {
+		throw std::runtime_error("Failed to read GLTF model: " + filepath);
+	}
+	
 	bool ret;
+	std::string baseDirectory = filepath.substr(0, filepath.find_last_of("/\\") + 1);
 	std::string extension = filepath.substr(filepath.find_last_of(".") + 1);
 	if (extension == "glb") {
-		ret = loader.LoadBinaryFromFile(&gltfModel, &err, &warn, filepath);
+		ret = loader.LoadBinaryFromMemory(&gltfModel, &err, &warn, bytes.data(),
+										  static_cast<unsigned int>(bytes.size()), baseDirectory);
 	} else {
-		ret = loader.LoadASCIIFromFile(&gltfModel, &err, &warn, filepath);
+		ret = loader.LoadASCIIFromString(&gltfModel, &err, &warn, reinterpret_cast<const char*>(bytes.data()),
+										 static_cast<unsigned int>(bytes.size()), baseDirectory);
 	}
 	
 	if (!ret) {
@@ -156,7 +167,9 @@ GLTFLoader::ProcessedMeshData GLTFLoader::processMesh(const tinygltf::Model& mod
 			};
 		}
 		
-		vertex.diffuseTextureIndex = primitive.material;
+		// Materials are not packed into an atlas, so there is no slot to point at
+		vertex.diffuseTextureIndex = -1;
+		vertex.normalTextureIndex = -1;
 		result.vertices.push_back(vertex);
 	}
 	
@@ -200,27 +213,38 @@ GLTFLoader::GLTFMaterial GLTFLoader::processMaterial(
     
     GLTFMaterial result;
     
+    // Color data is sRGB encoded, everything else is linear
+    MipSettings colorMips;
+    colorMips.srgb = true;
+    
+    MipSettings linearMips;
+    linearMips.srgb = false;
+    
+    MipSettings normalMips;
+    normalMips.srgb = false;
+    normalMips.normalMap = true;
+    
     // Process PBR Metallic Roughness
     if (material.pbrMetallicRoughness.baseColorTexture.index >= 0) {
         const auto& texture = model.textures[material.pbrMetallicRoughness.baseColorTexture.index];
-        result.baseColorTexture = loadTexture(model, texture);
+        result.baseColorTexture = loadTexture(model, texture, colorMips);
     }
     
     if (material.pbrMetallicRoughness.metallicRoughnessTexture.index >= 0) {
         const auto& texture = model.textures[material.pbrMetallicRoughness.metallicRoughnessTexture.index];
-        result.metallicRoughnessTexture = loadTexture(model, texture);
+        result.metallicRoughnessTexture = loadTexture(model, texture, linearMips);
     }
     
     // Normal map
     if (material.normalTexture.index >= 0) {
         const auto& texture = model.textures[material.normalTexture.index];
-        result.normalTexture = loadTexture(model, texture);
+        result.normalTexture = loadTexture(model, texture, normalMips);
     }
     
     // Emissive map
     if (material.emissiveTexture.index >= 0) {
         const auto& texture = model.textures[material.emissiveTexture.index];
-        result.emissiveTexture = loadTexture(model, texture);
+        result.emissiveTexture = loadTexture(model, texture, colorMips);
     }
     
     // Material factors
@@ -276,26 +300,40 @@ bool GLTFLoader::LoadImageData(tinygltf::Image* image, const int imageIndex,
 		return true;
 	}
 
-NS::SharedPtr<MTL::Texture> GLTFLoader::loadTexture(
+TextureHandle GLTFLoader::loadTexture(
     const tinygltf::Model& model,
-    const tinygltf::Texture& texture) {
+    const tinygltf::Texture& texture,
+    const MipSettings& mipSettings) {
     
     const tinygltf::Image& image = model.images[texture.source];
     
-    MTL::TextureDescriptor* textureDesc = MTL::TextureDescriptor::alloc()->init();
-    textureDesc->setPixelFormat(MTL::PixelFormatRGBA8Unorm);
-    textureDesc->setWidth(image.width);
-    textureDesc->setHeight(image.height);
-    textureDesc->setStorageMode(MTL::StorageModeShared);
-    textureDesc->setUsage(MTL::TextureUsageShaderRead);
+    uint64_t contentHash = TextureCache::makeKey(image.image.data(), image.image.size(), mipSettings);
+    std::string key = TextureRegistry::contentKey("gltf" + std::to_string(image.width) + "x" + std::to_string(image.height), contentHash);
     
-    NS::SharedPtr<MTL::Texture> metalTexture = NS::TransferPtr(_device->newTexture(textureDesc));
+    return TextureRegistry::shared().acquire(key, [&]() {
+        MipChain mipChain = MipGenerator::generate(image.image.data(), image.width, image.height, mipSettings);
+        
+        MTL::TextureDescriptor* textureDesc = MTL::TextureDescriptor::alloc()->init();
+        textureDesc->setPixelFormat(MTL::PixelFormatRGBA8Unorm);
+        textureDesc->setWidth(image.width);
+        textureDesc->setHeight(image.height);
+        textureDesc->setMipmapLevelCount(mipChain.levelCount());
+        textureDesc->setStorageMode(MTL::StorageModeShared);
+        textureDesc->setUsage(MTL::TextureUsageShaderRead);
+        
+        RegisteredTexture registered;
+        registered.texture = _device->newTexture(textureDesc);
+        registered.bytes = mipChain.data.size();
 
-    textureDesc->release();
-    
-    MTL::Region region(0, 0, image.width, image.height);
-    metalTexture->replaceRegion(region, 0, image.image.data(), 
-                               image.width * 4);
-    
-    return metalTexture;
+        textureDesc->release();
+        
+        for (int level = 0; level < mipChain.levelCount(); level++) {
+            const MipChain::Level& mip = mipChain.levels[level];
+            MTL::Region region(0, 0, mip.width, mip.height);
+            registered.texture->replaceRegion(region, level, mipChain.level(level),
+                                              mipChain.bytesPerRow(level));
+        }
+        
+        return registered;
+    });
 }
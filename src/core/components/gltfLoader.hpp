@@ -2,6 +2,8 @@
 #include "pch.hpp"
 #include "mesh.hpp"
 #include "textureArray.hpp"
+#include "mipGenerator.hpp"
+#include "textureRegistry.hpp"
 #include <tinyGLTF/tiny_gltf.h>
 
 class GLTFLoader {
@@ -12,10 +14,10 @@ public:
     };
     
     struct GLTFMaterial {
-		NS::SharedPtr<MTL::Texture> baseColorTexture;
-		NS::SharedPtr<MTL::Texture> metallicRoughnessTexture;
-		NS::SharedPtr<MTL::Texture> normalTexture;
-		NS::SharedPtr<MTL::Texture> emissiveTexture;
+		TextureHandle baseColorTexture;
+		TextureHandle metallicRoughnessTexture;
+		TextureHandle normalTexture;
+		TextureHandle emissiveTexture;
         
         // PBR material properties
         simd::float4 baseColorFactor = {1.0f, 1.0f, 1.0f, 1.0f};
@@ -49,8 +51,10 @@ private:
     GLTFMaterial processMaterial(const tinygltf::Model& model,
                                 const tinygltf::Material& material);
                                 
-    NS::SharedPtr<MTL::Texture> loadTexture(const tinygltf::Model& model,
-                                           const tinygltf::Texture& texture);
+    // Materials that reference the same image with the same settings share one texture
+    TextureHandle loadTexture(const tinygltf::Model& model,
+                              const tinygltf::Texture& texture,
+                              const MipSettings& mipSettings);
 
     static bool LoadImageData(tinygltf::Image* image, const int imageIndex,
                             std::string* error, std::string* warning, 
@@ -1,19 +1,46 @@
 #include "mesh.hpp"
 #include "../../data/shaders/shaderTypes.hpp"
 
+#include "../fileReader.hpp"
+
 #include <iostream>
 #include <unordered_map>
 #include <string>
 
+namespace {
+
+// Lets tinyobj parse a file that was already read, without copying it into a string stream
+struct MemoryStreamBuffer : std::streambuf {
+    explicit MemoryStreamBuffer(const std::vector<unsigned char>& bytes) {
+        char* begin = const_cast<char*>(reinterpret_cast<const char*>(bytes.data()));
+        setg(begin, begin, begin + bytes.size());
+    }
+};
+
+}
+
 // For tinyobjloader
-Mesh::Mesh(std::string filePath, MTL::Device* metalDevice, MTL::VertexDescriptor* vertexDescriptor, const MeshInfo info) {
-    device = metalDevice;
-    meshInfo = info;
-    
+Mesh::Mesh(std::string filePath, MTL::Device* metalDevice, MTL::VertexDescriptor* vertexDescriptor, const MeshInfo info)
+: Mesh(metalDevice, info) {
     loadObj(filePath);
     createBuffers(vertexDescriptor);
 }
 
+// For parallel scene loading
+Mesh::Mesh(MTL::Device* metalDevice, const MeshInfo info)
+: device(metalDevice)
+, vertexBuffer(nullptr)
+, indexBuffer(nullptr)
+, indexCount(0)
+, triangleCount(0)
+, hasTextures(false)
+, diffuseTextures(nullptr)
+, normalTextures(nullptr)
+, diffuseTextureInfos(nullptr)
+, normalTextureInfos(nullptr) {
+    meshInfo = info;
+}
+
 // For tinyGLTF
 Mesh::Mesh(MTL::Device* device, const Vertex* vertexData, size_t vertexCount, const uint32_t* indexData, size_t indexCount, const MeshInfo info)
 : device(device) {
@@ -29,20 +56,61 @@ Mesh::Mesh(MTL::Device* device, const Vertex* vertexData, size_t vertexCount, co
     this->indexCount = indexCount;
     indexBuffer = device->newBuffer(indexData, indexCount * sizeof(uint32_t), MTL::ResourceStorageModeShared);
     indexBuffer->setLabel(NS::String::string("Mesh Index Buffer", NS::ASCIIStringEncoding));
+    
+    computeBounds(vertexData, vertexCount);
+}
+
+// For scene reloads and repeated objects
+Mesh::Mesh(const Mesh& source, const MeshInfo info)
+: device(source.device) {
+    meshInfo = info;
+    
+    vertices = source.vertices;
+    vertexIndices = source.vertexIndices;
+    indexCount = source.indexCount;
+    triangleCount = source.triangleCount;
+    hasTextures = source.hasTextures;
+    boundsMin = source.boundsMin;
+    boundsMax = source.boundsMax;
+    
+    // The source may have failed to create some of its buffers
+    vertexBuffer = source.vertexBuffer;
+    if (vertexBuffer) vertexBuffer->retain();
+    indexBuffer = source.indexBuffer;
+    if (indexBuffer) indexBuffer->retain();
+    
+    diffuseTextureHandle = source.diffuseTextureHandle;
+    normalTextureHandle = source.normalTextureHandle;
+    // The source may be bound to streamed mips, start from the resident ones
+    diffuseTextures = diffuseTextureHandle ? diffuseTextureHandle->texture : source.diffuseTextures;
+    normalTextures = normalTextureHandle ? normalTextureHandle->texture : source.normalTextures;
+    diffuseTextureInfos = source.diffuseTextureInfos;
+    normalTextureInfos = source.normalTextureInfos;
+    if (meshInfo.hasTextures) {
+        if (diffuseTextureInfos) diffuseTextureInfos->retain();
+        if (normalTextureInfos) normalTextureInfos->retain();
+    }
 }
 
 Mesh::~Mesh() {
+    // The textures themselves belong to the registry and go away with the last handle
     if (meshInfo.hasTextures) {
-        normalTextures->release();
-        normalTextureInfos->release();
-        diffuseTextures->release();
-        diffuseTextureInfos->release();
+        if (normalTextureInfos) normalTextureInfos->release();
+        if (diffuseTextureInfos) diffuseTextureInfos->release();
     }
-    vertexBuffer->release();
-    indexBuffer->release();
+    if (vertexBuffer) vertexBuffer->release();
+    if (indexBuffer) indexBuffer->release();
 }
 
 void Mesh::loadObj(std::string filePath) {
+    std::vector<unsigned char> bytes;
+    if (!FileReader::shared().read(filePath, bytes)) {
+        throw std::runtime_error("Failed to read " + filePath);
+    }
+    loadObj(filePath, bytes);
+}
+
+void Mesh::loadObj(const std::string& filePath, const std::vector<unsigned char>& bytes) {
     tinyobj::attrib_t vertexArrays;
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
@@ -51,8 +119,12 @@ void Mesh::loadObj(std::string filePath) {
     std::string warning;
     std::string error;
     
+    // The material library is small and still read by tinyobj itself
+    MemoryStreamBuffer buffer(bytes);
+    std::istream stream(&buffer);
+    tinyobj::MaterialFileReader materialReader(baseDirectory);
     bool ret = tinyobj::LoadObj(&vertexArrays, &shapes, &materials, &error,
-                                filePath.c_str(), baseDirectory.c_str(), true);
+                                &stream, &materialReader, true);
     
     // Create texture mappings for both diffuse and normal textures
     std::unordered_map<std::string, int> diffuseTextureIndexMap;
@@ -94,9 +166,9 @@ void Mesh::loadObj(std::string filePath) {
             }
         }
         
-        // Create texture arrays
-        diffuseTexturesArray = new TextureArray(diffuseFilePaths, device, TextureType::DIFFUSE);
-        normalTexturesArray = new TextureArray(normalFilePaths, device, TextureType::NORMAL);
+        // Create texture arrays, or share the ones another mesh already built from the same files
+        diffuseTextureHandle = TextureArray::acquire(diffuseFilePaths, device, TextureType::DIFFUSE);
+        normalTextureHandle = TextureArray::acquire(normalFilePaths, device, TextureType::NORMAL);
     }
     
     // Process geometry
@@ -202,6 +274,33 @@ void Mesh::loadObj(std::string filePath) {
     if (meshInfo.hasTextures) {
         calculateTangentSpace(vertices, vertexIndices);
     }
+    
+    computeBounds(vertices.data(), vertices.size());
+}
+
+void Mesh::computeBounds(const Vertex* vertexData, size_t vertexCount) {
+    boundsMin = simd::float3{0.0f, 0.0f, 0.0f};
+    boundsMax = simd::float3{0.0f, 0.0f, 0.0f};
+    if (vertexCount == 0) return;
+    
+    boundsMin = vertexData[0].position.xyz;
+    boundsMax = vertexData[0].position.xyz;
+    for (size_t i = 1; i < vertexCount; i++) {
+        boundsMin = simd::min(boundsMin, vertexData[i].position.xyz);
+        boundsMax = simd::max(boundsMax, vertexData[i].position.xyz);
+    }
+}
+
+void Mesh::getWorldBoundingSphere(simd::float3& center, float& radius) const {
+    matrix_float4x4 transform = getTransformMatrix();
+    
+    simd::float3 localCenter = (boundsMin + boundsMax) * 0.5f;
+    simd::float4 worldCenter = matrix_multiply(transform, simd::float4{localCenter.x, localCenter.y, localCenter.z, 1.0f});
+    center = worldCenter.xyz;
+    
+    // Scale the local radius by the largest axis scale so rotation can't make it too small
+    float maxScale = std::max({std::abs(meshInfo.scale.x), std::abs(meshInfo.scale.y), std::abs(meshInfo.scale.z)});
+    radius = simd::length(boundsMax - boundsMin) * 0.5f * maxScale;
 }
 
 void Mesh::calculateTangentSpace(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
@@ -253,6 +352,18 @@ void Mesh::createBuffers(MTL::VertexDescriptor* vertexDescriptor) {
         return;
     }
     
+    // The shader only reads the info buffers behind a valid index, and the buffers are not
+    // created without an atlas (a failed load, for example), so indices without an info
+    // entry fall back to the untextured path
+    int diffuseInfoCount = (meshInfo.hasTextures && diffuseTextureHandle && diffuseTextureHandle->texture)
+        ? static_cast<int>(diffuseTextureHandle->infos.size()) : 0;
+    int normalInfoCount = (meshInfo.hasTextures && normalTextureHandle && normalTextureHandle->texture)
+        ? static_cast<int>(normalTextureHandle->infos.size()) : 0;
+    for (Vertex& vertex : vertices) {
+        if (vertex.diffuseTextureIndex >= diffuseInfoCount) vertex.diffuseTextureIndex = -1;
+        if (vertex.normalTextureIndex >= normalInfoCount) vertex.normalTextureIndex = -1;
+    }
+    
     // Create Vertex Buffer with safety checks
     unsigned long vertexBufferSize = sizeof(Vertex) * vertices.size();
     if (vertexBufferSize > 0 && vertices.data() != nullptr) {
@@ -287,16 +398,16 @@ void Mesh::createBuffers(MTL::VertexDescriptor* vertexDescriptor) {
     // Handle textures only if we have them
     if (meshInfo.hasTextures) {
         // Check diffuse textures
-        if (diffuseTexturesArray && diffuseTexturesArray->diffuseTextureArray) {
-            diffuseTextures = diffuseTexturesArray->diffuseTextureArray;
+        if (diffuseTextureHandle && diffuseTextureHandle->texture) {
+            diffuseTextures = diffuseTextureHandle->texture;
             diffuseTextures->setLabel(NS::String::string("Diffuse Texture Array", NS::ASCIIStringEncoding));
             
             // Create Diffuse Texture Info with safety checks
-            if (!diffuseTexturesArray->diffuseTextureInfos.empty()) {
-                size_t diffuseBufferSize = diffuseTexturesArray->diffuseTextureInfos.size() * sizeof(TextureInfo);
-                if (diffuseBufferSize > 0 && diffuseTexturesArray->diffuseTextureInfos.data() != nullptr) {
+            if (!diffuseTextureHandle->infos.empty()) {
+                size_t diffuseBufferSize = diffuseTextureHandle->infos.size() * sizeof(TextureInfo);
+                if (diffuseBufferSize > 0 && diffuseTextureHandle->infos.data() != nullptr) {
                     diffuseTextureInfos = device->newBuffer(
-                        diffuseTexturesArray->diffuseTextureInfos.data(),
+                        diffuseTextureHandle->infos.data(),
                         diffuseBufferSize,
                         MTL::ResourceStorageModeShared
                     );
@@ -316,16 +427,16 @@ void Mesh::createBuffers(MTL::VertexDescriptor* vertexDescriptor) {
         }
         
         // Check normal textures
-        if (normalTexturesArray && normalTexturesArray->normalTextureArray) {
-            normalTextures = normalTexturesArray->normalTextureArray;
+        if (normalTextureHandle && normalTextureHandle->texture) {
+            normalTextures = normalTextureHandle->texture;
             normalTextures->setLabel(NS::String::string("Normal Texture Array", NS::ASCIIStringEncoding));
             
             // Create normal Texture Info with safety checks
-            if (!normalTexturesArray->normalTextureInfos.empty()) {
-                size_t normalBufferSize = normalTexturesArray->normalTextureInfos.size() * sizeof(TextureInfo);
-                if (normalBufferSize > 0 && normalTexturesArray->normalTextureInfos.data() != nullptr) {
+            if (!normalTextureHandle->infos.empty()) {
+                size_t normalBufferSize = normalTextureHandle->infos.size() * sizeof(TextureInfo);
+                if (normalBufferSize > 0 && normalTextureHandle->infos.data() != nullptr) {
                     normalTextureInfos = device->newBuffer(
-                        normalTexturesArray->normalTextureInfos.data(),
+                        normalTextureHandle->infos.data(),
                         normalBufferSize,
                         MTL::ResourceStorageModeShared
                     );
@@ -15,6 +15,7 @@ using namespace simd;
 
 #include "camera.hpp"
 #include "vertexData.hpp"
+#include "sceneDescription.hpp"
 #include "textureArray.hpp"
 
 inline bool operator==(const Vertex& lhs, const Vertex& rhs) {
@@ -61,7 +62,13 @@ namespace std {
 
 struct Mesh {
     Mesh(std::string filePath, MTL::Device* metalDevice, MTL::VertexDescriptor* vertexDescriptor, const MeshInfo info);
+    // Empty mesh that is filled in later by loadObj and createBuffers, so the file can be
+    // parsed on a loader thread and the GPU buffers created afterwards in a fixed order
+    Mesh(MTL::Device* metalDevice, const MeshInfo info);
     Mesh(MTL::Device* device, const Vertex* vertexData, size_t vertexCount, const uint32_t* indexData, size_t indexCount, const MeshInfo info);
+    // Another instance of already loaded geometry. GPU buffers and textures are shared with
+    // the source, only the CPU vertices are copied since the acceleration structure needs them.
+    Mesh(const Mesh& source, const MeshInfo info);
 
     ~Mesh();
     
@@ -69,60 +76,23 @@ struct Mesh {
 
 public:
     void loadObj(std::string filePath);
+    // Parses a file that was already read, filePath only locates the materials and textures
+    void loadObj(const std::string& filePath, const std::vector<unsigned char>& bytes);
     void calculateTangentSpace(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
     void createBuffers(MTL::VertexDescriptor* vertexDescriptor);
     void defaultVertexAttributes();
+    void computeBounds(const Vertex* vertexData, size_t vertexCount);
+    
+    // Sphere around the transformed bounds, used for culling and texture streaming
+    void getWorldBoundingSphere(simd::float3& center, float& radius) const;
     
     std::vector<Vertex>                     vertices;
     std::vector<uint32_t>                   vertexIndices;
-    TextureArray*                           diffuseTexturesArray;
-    TextureArray*                           normalTexturesArray;
+    TextureHandle                           diffuseTextureHandle;
+    TextureHandle                           normalTextureHandle;
     std::unordered_map<Vertex, uint32_t>    vertexMap;
     
-    matrix_float4x4 getTransformMatrix() const {
-        // Create scaling matrix
-        matrix_float4x4 scaleMatrix{simd::float4{meshInfo.scale.x, 0.0f, 0.0f, 0.0f},
-                                    simd::float4{0.0f, meshInfo.scale.y, 0.0f, 0.0f},
-                                    simd::float4{0.0f, 0.0f, meshInfo.scale.z, 0.0f},
-                                    simd::float4{0.0f, 0.0f, 0.0f, 1.0f}};
-        
-        float cosX = cos(radians_from_degrees(meshInfo.rotation.x));
-        float sinX = sin(radians_from_degrees(meshInfo.rotation.x));
-        float cosY = cos(radians_from_degrees(meshInfo.rotation.y));
-        float sinY = sin(radians_from_degrees(meshInfo.rotation.y));
-        float cosZ = cos(radians_from_degrees(meshInfo.rotation.z));
-        float sinZ = sin(radians_from_degrees(meshInfo.rotation.z));
-        
-        // Rotation around X axis
-        matrix_float4x4 rotX{simd::float4{1.0f, 0.0f, 0.0f, 0.0f},
-                             simd::float4{0.0f, cosX, sinX, 0.0f},
-                             simd::float4{0.0f, -sinX, cosX, 0.0f},
-                             simd::float4{0.0f, 0.0f, 0.0f, 1.0f}};
-        
-        // Rotation around Y axis
-        matrix_float4x4 rotY{simd::float4{cosY, 0.0f, -sinY, 0.0f},
-                             simd::float4{0.0f, 1.0f, 0.0f, 0.0f},
-                             simd::float4{sinY, 0.0f, cosY, 0.0f},
-                             simd::float4{0.0f, 0.0f, 0.0f, 1.0f}};
-        
-        // Rotation around Z axis
-        matrix_float4x4 rotZ{simd::float4{cosZ, sinZ, 0.0f, 0.0f},
-                             simd::float4{-sinZ, cosZ, 0.0f, 0.0f},
-                             simd::float4{0.0f, 0.0f, 1.0f, 0.0f},
-                             simd::float4{0.0f, 0.0f, 0.0f, 1.0f}};
-        
-        // First Z, then Y, then X
-        matrix_float4x4 rotationMatrix = matrix_multiply(matrix_multiply(rotZ, rotY), rotX);
-        
-        matrix_float4x4 posMatrix{simd::float4{1.0f, 0.0f, 0.0f, 0.0f},
-                                  simd::float4{0.0f, 1.0f, 0.0f, 0.0f},
-                                  simd::float4{0.0f, 0.0f, 1.0f, 0.0f},
-                                  simd::float4{meshInfo.position.x, meshInfo.position.y, meshInfo.position.z, 1.0f}};
-        
-
-        matrix_float4x4 rotateScale = matrix_multiply(rotationMatrix, scaleMatrix);
-        return matrix_multiply(posMatrix, rotateScale);
-    }
+    matrix_float4x4 getTransformMatrix() const { return meshTransformMatrix(meshInfo); }
     
 public:
     MTL::Device*    device;
@@ -138,4 +108,8 @@ public:
     MTL::Buffer*    normalTextureInfos;
     
     MeshInfo        meshInfo;
+    
+    // Object space bounds of the vertices
+    simd::float3    boundsMin;
+    simd::float3    boundsMax;
 };
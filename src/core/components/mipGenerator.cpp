@@ -0,0 +1,308 @@
+#include "mipGenerator.hpp"
+#include "../taskScheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+    // Rows per parallel work item when filtering a level
+    constexpr int ROW_BAND = 32;
+    constexpr int KAISER_RADIUS = 3;
+    constexpr float KAISER_ALPHA = 4.0f;
+    constexpr int LINEAR_TO_SRGB_STEPS = 4096;
+
+    struct ColorTables {
+        float srgbToLinear[256];
+        unsigned char linearToSrgb[LINEAR_TO_SRGB_STEPS + 1];
+
+        ColorTables() {
+            for (int i = 0; i < 256; i++) {
+                float c = i / 255.0f;
+                srgbToLinear[i] = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (int i = 0; i <= LINEAR_TO_SRGB_STEPS; i++) {
+                float l = float(i) / LINEAR_TO_SRGB_STEPS;
+                float c = (l <= 0.0031308f) ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                linearToSrgb[i] = static_cast<unsigned char>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+            }
+        }
+    };
+
+    const ColorTables& colorTables() {
+        static const ColorTables tables;
+        return tables;
+    }
+
+    void forEachRowBand(int rows, const std::function<void(int, int)>& body) {
+        int bands = (rows + ROW_BAND - 1) / ROW_BAND;
+        TaskScheduler::shared().parallelFor(bands, [&](size_t band) {
+            int begin = int(band) * ROW_BAND;
+            body(begin, std::min(rows, begin + ROW_BAND));
+        });
+    }
+
+    void decodeLevel(const unsigned char* rgba, int width, int height, const MipSettings& settings, float* out) {
+        const ColorTables& tables = colorTables();
+
+        forEachRowBand(height, [&](int rowBegin, int rowEnd) {
+            for (size_t i = size_t(rowBegin) * width * 4; i < size_t(rowEnd) * width * 4; i += 4) {
+                for (int c = 0; c < 3; c++) {
+                    if (settings.normalMap) {
+                        out[i + c] = rgba[i + c] / 255.0f * 2.0f - 1.0f;
+                    } else if (settings.srgb) {
+                        out[i + c] = tables.srgbToLinear[rgba[i + c]];
+                    } else {
+                        out[i + c] = rgba[i + c] / 255.0f;
+                    }
+                }
+                out[i + 3] = rgba[i + 3] / 255.0f;
+            }
+        });
+    }
+
+    void encodeLevel(const float* in, int width, int height, const MipSettings& settings, unsigned char* rgba) {
+        const ColorTables& tables = colorTables();
+
+        auto unorm = [](float v) {
+            return static_cast<unsigned char>(std::clamp(v * 255.0f + 0.5f, 0.0f, 255.0f));
+        };
+
+        forEachRowBand(height, [&](int rowBegin, int rowEnd) {
+            for (size_t i = size_t(rowBegin) * width * 4; i < size_t(rowEnd) * width * 4; i += 4) {
+                for (int c = 0; c < 3; c++) {
+                    if (settings.normalMap) {
+                        rgba[i + c] = unorm(in[i + c] * 0.5f + 0.5f);
+                    } else if (settings.srgb) {
+                        float l = std::clamp(in[i + c], 0.0f, 1.0f);
+                        rgba[i + c] = tables.linearToSrgb[int(l * LINEAR_TO_SRGB_STEPS + 0.5f)];
+                    } else {
+                        rgba[i + c] = unorm(in[i + c]);
+                    }
+                }
+                rgba[i + 3] = unorm(in[i + 3]);
+            }
+        });
+    }
+
+    // One output row of an exact 2x2 reduction. Pixels are four floats, so a pixel is one
+    // 128-bit register and AVX2 handles two output pixels per iteration.
+    void boxReduceRow(const float* row0, const float* row1, float* dst, int dstWidth) {
+        int x = 0;
+#if defined(__AVX2__)
+        const __m256 quarter8 = _mm256_set1_ps(0.25f);
+        for (; x + 2 <= dstWidth; x += 2) {
+            __m256 sumA = _mm256_add_ps(_mm256_loadu_ps(row0 + x * 8),     _mm256_loadu_ps(row1 + x * 8));
+            __m256 sumB = _mm256_add_ps(_mm256_loadu_ps(row0 + x * 8 + 8), _mm256_loadu_ps(row1 + x * 8 + 8));
+            __m256 left  = _mm256_permute2f128_ps(sumA, sumB, 0x20);
+            __m256 right = _mm256_permute2f128_ps(sumA, sumB, 0x31);
+            _mm256_storeu_ps(dst + x * 4, _mm256_mul_ps(_mm256_add_ps(left, right), quarter8));
+        }
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+        const __m128 quarter = _mm_set1_ps(0.25f);
+        for (; x < dstWidth; x++) {
+            __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(row0 + x * 8), _mm_loadu_ps(row0 + x * 8 + 4)),
+                                    _mm_add_ps(_mm_loadu_ps(row1 + x * 8), _mm_loadu_ps(row1 + x * 8 + 4)));
+            _mm_storeu_ps(dst + x * 4, _mm_mul_ps(sum, quarter));
+        }
+#elif defined(__ARM_NEON)
+        for (; x < dstWidth; x++) {
+            float32x4_t sum = vaddq_f32(vaddq_f32(vld1q_f32(row0 + x * 8), vld1q_f32(row0 + x * 8 + 4)),
+                                        vaddq_f32(vld1q_f32(row1 + x * 8), vld1q_f32(row1 + x * 8 + 4)));
+            vst1q_f32(dst + x * 4, vmulq_n_f32(sum, 0.25f));
+        }
+#else
+        for (; x < dstWidth; x++) {
+            for (int c = 0; c < 4; c++) {
+                dst[x * 4 + c] = 0.25f * (row0[x * 8 + c] + row0[x * 8 + 4 + c] + row1[x * 8 + c] + row1[x * 8 + 4 + c]);
+            }
+        }
+#endif
+    }
+
+    struct Tap {
+        int     index;
+        float   weight;
+    };
+
+    float besselI0(float x) {
+        float sum = 1.0f, term = 1.0f;
+        for (int k = 1; k < 16; k++) {
+            term *= (x / (2.0f * k)) * (x / (2.0f * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    float kaiserSinc(float t) {
+        if (std::fabs(t) >= KAISER_RADIUS) return 0.0f;
+        float sinc = (t == 0.0f) ? 1.0f : std::sin(float(M_PI) * t) / (float(M_PI) * t);
+        float r = t / KAISER_RADIUS;
+        return sinc * besselI0(KAISER_ALPHA * std::sqrt(1.0f - r * r)) / besselI0(KAISER_ALPHA);
+    }
+
+    // Taps for every output texel along one axis. Source indices wrap because the
+    // textures are sampled with repeat addressing.
+    std::vector<std::vector<Tap>> buildTaps(int srcSize, int dstSize, MipFilter filter) {
+        std::vector<std::vector<Tap>> taps(dstSize);
+        float scale = float(srcSize) / float(dstSize);
+
+        for (int x = 0; x < dstSize; x++) {
+            std::vector<Tap>& list = taps[x];
+            float sum = 0.0f;
+
+            if (filter == MipFilter::Box) {
+                // Exact coverage of [x, x + 1) in destination space
+                float begin = x * scale;
+                float end = (x + 1) * scale;
+                for (int s = int(std::floor(begin)); s < int(std::ceil(end)); s++) {
+                    float weight = std::min(end, float(s + 1)) - std::max(begin, float(s));
+                    if (weight > 0.0f) {
+                        list.push_back({s, weight});
+                        sum += weight;
+                    }
+                }
+            } else {
+                float center = (x + 0.5f) * scale - 0.5f;
+                float radius = KAISER_RADIUS * scale * 0.5f;
+                for (int s = int(std::ceil(center - radius)); s <= int(std::floor(center + radius)); s++) {
+                    float weight = kaiserSinc((s - center) / (scale * 0.5f));
+                    if (weight != 0.0f) {
+                        list.push_back({s, weight});
+                        sum += weight;
+                    }
+                }
+            }
+
+            for (Tap& tap : list) {
+                tap.index = ((tap.index % srcSize) + srcSize) % srcSize;
+                tap.weight /= sum;
+            }
+        }
+
+        return taps;
+    }
+
+    void resampleLevel(const float* src, int srcWidth, int srcHeight, float* dst, int dstWidth, int dstHeight, MipFilter filter) {
+        if (filter == MipFilter::Box && srcWidth == dstWidth * 2 && srcHeight == dstHeight * 2) {
+            forEachRowBand(dstHeight, [&](int rowBegin, int rowEnd) {
+                for (int y = rowBegin; y < rowEnd; y++) {
+                    boxReduceRow(src + size_t(2 * y) * srcWidth * 4,
+                                 src + size_t(2 * y + 1) * srcWidth * 4,
+                                 dst + size_t(y) * dstWidth * 4,
+                                 dstWidth);
+                }
+            });
+            return;
+        }
+
+        // Odd sizes and the Kaiser filter go through a separable resampler
+        std::vector<std::vector<Tap>> horizontal = buildTaps(srcWidth, dstWidth, filter);
+        std::vector<std::vector<Tap>> vertical = buildTaps(srcHeight, dstHeight, filter);
+        std::vector<float> rows(size_t(dstWidth) * srcHeight * 4);
+
+        forEachRowBand(srcHeight, [&](int rowBegin, int rowEnd) {
+            for (int y = rowBegin; y < rowEnd; y++) {
+                const float* in = src + size_t(y) * srcWidth * 4;
+                float* out = rows.data() + size_t(y) * dstWidth * 4;
+                for (int x = 0; x < dstWidth; x++) {
+                    float pixel[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+                    for (const Tap& tap : horizontal[x]) {
+                        for (int c = 0; c < 4; c++) pixel[c] += in[tap.index * 4 + c] * tap.weight;
+                    }
+                    std::memcpy(out + x * 4, pixel, sizeof(pixel));
+                }
+            }
+        });
+
+        forEachRowBand(dstHeight, [&](int rowBegin, int rowEnd) {
+            for (int y = rowBegin; y < rowEnd; y++) {
+                float* out = dst + size_t(y) * dstWidth * 4;
+                std::fill(out, out + size_t(dstWidth) * 4, 0.0f);
+                for (const Tap& tap : vertical[y]) {
+                    const float* in = rows.data() + size_t(tap.index) * dstWidth * 4;
+                    for (int i = 0; i < dstWidth * 4; i++) out[i] += in[i] * tap.weight;
+                }
+            }
+        });
+    }
+
+    void renormalize(float* pixels, int width, int height) {
+        forEachRowBand(height, [&](int rowBegin, int rowEnd) {
+            for (size_t i = size_t(rowBegin) * width * 4; i < size_t(rowEnd) * width * 4; i += 4) {
+                float length = std::sqrt(pixels[i] * pixels[i] + pixels[i + 1] * pixels[i + 1] + pixels[i + 2] * pixels[i + 2]);
+                if (length > 1e-6f) {
+                    pixels[i] /= length;
+                    pixels[i + 1] /= length;
+                    pixels[i + 2] /= length;
+                } else {
+                    pixels[i] = 0.0f;
+                    pixels[i + 1] = 0.0f;
+                    pixels[i + 2] = 1.0f;
+                }
+            }
+        });
+    }
+}
+
+int MipGenerator::fullLevelCount(int width, int height) {
+    int levels = 1;
+    while ((width >> levels) > 0 || (height >> levels) > 0) {
+        levels++;
+    }
+    return levels;
+}
+
+MipChain MipGenerator::generate(const unsigned char* rgba, int width, int height, const MipSettings& settings) {
+    MipChain chain;
+
+    int levelCount = fullLevelCount(width, height);
+    if (settings.maxLevels > 0) {
+        levelCount = std::min(levelCount, settings.maxLevels);
+    }
+
+    size_t totalBytes = 0;
+    for (int level = 0; level < levelCount; level++) {
+        int levelWidth = std::max(1, width >> level);
+        int levelHeight = std::max(1, height >> level);
+        chain.levels.push_back({levelWidth, levelHeight, totalBytes});
+        totalBytes += size_t(levelWidth) * levelHeight * 4;
+    }
+    chain.data.resize(totalBytes);
+
+    // The top level is kept bit exact
+    std::memcpy(chain.data.data(), rgba, size_t(width) * height * 4);
+    if (levelCount == 1) {
+        return chain;
+    }
+
+    std::vector<float> current(size_t(width) * height * 4);
+    std::vector<float> next;
+    decodeLevel(rgba, width, height, settings, current.data());
+
+    for (int level = 1; level < levelCount; level++) {
+        const MipChain::Level& src = chain.levels[level - 1];
+        const MipChain::Level& dst = chain.levels[level];
+
+        next.resize(size_t(dst.width) * dst.height * 4);
+        resampleLevel(current.data(), src.width, src.height, next.data(), dst.width, dst.height, settings.filter);
+
+        if (settings.normalMap) {
+            renormalize(next.data(), dst.width, dst.height);
+        }
+
+        encodeLevel(next.data(), dst.width, dst.height, settings, chain.data.data() + dst.offset);
+        std::swap(current, next);
+    }
+
+    return chain;
+}
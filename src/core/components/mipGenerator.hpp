@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+enum class MipFilter : uint8_t {
+    Box,    // 2x2 average, widened to cover odd sizes
+    Kaiser  // Windowed sinc, sharper at the cost of a 6 tap footprint
+};
+
+struct MipSettings {
+    bool        srgb = true;        // Average in linear space and re-encode
+    bool        normalMap = false;  // Decode to [-1, 1], average and renormalize
+    int         maxLevels = 0;      // 0 means the full chain down to 1x1
+    MipFilter   filter = MipFilter::Box;
+};
+
+// RGBA8 mip chain with every level stored back to back in one allocation, which is
+// the layout both the texture uploaders and the on-disk texture cache consume
+struct MipChain {
+    struct Level {
+        int     width;
+        int     height;
+        size_t  offset;
+    };
+
+    std::vector<Level>          levels;
+    std::vector<unsigned char>  data;
+
+    int width() const { return levels.empty() ? 0 : levels[0].width; }
+    int height() const { return levels.empty() ? 0 : levels[0].height; }
+    int levelCount() const { return static_cast<int>(levels.size()); }
+    const unsigned char* level(int index) const { return data.data() + levels[index].offset; }
+    size_t bytesPerRow(int index) const { return size_t(levels[index].width) * 4; }
+};
+
+class MipGenerator {
+public:
+    static int fullLevelCount(int width, int height);
+
+    static MipChain generate(const unsigned char* rgba, int width, int height, const MipSettings& settings);
+};
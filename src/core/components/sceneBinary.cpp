@@ -0,0 +1,268 @@
+#include "sceneBinary.hpp"
+#include "sceneDescription.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint32_t SCENE_MAGIC          = 0x4E534352; // "RCSN"
+constexpr uint32_t SCENE_VERSION        = 1;
+constexpr size_t   SCENE_SECTION_ALIGN  = 16;
+
+enum Section {
+    SectionInstanceMeshes,
+    SectionPositions,
+    SectionRotations,
+    SectionScales,
+    SectionColors,
+    SectionEmissiveColors,
+    SectionFlags,
+    SectionCount
+};
+
+struct SceneFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t meshCount;
+    uint32_t instanceCount;
+    uint64_t stringsOffset;
+    uint64_t stringsBytes;
+    uint64_t meshTableOffset;
+    uint64_t sectionOffsets[SectionCount];
+    uint64_t fileSize;
+};
+
+struct MeshRecord {
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t fileOffset;
+    uint32_t fileLength;
+};
+
+size_t sectionBytes(Section section, uint32_t instanceCount) {
+    switch (section) {
+        case SectionInstanceMeshes: return size_t(instanceCount) * sizeof(uint32_t);
+        case SectionFlags:          return size_t(instanceCount) * sizeof(uint8_t);
+        default:                    return size_t(instanceCount) * sizeof(float) * 3;
+    }
+}
+
+size_t alignSection(size_t offset) {
+    return (offset + SCENE_SECTION_ALIGN - 1) & ~(SCENE_SECTION_ALIGN - 1);
+}
+
+// Offsets of everything after the header, shared by the writer and the validation in open()
+void layoutFile(SceneFileHeader& header) {
+    size_t offset = alignSection(sizeof(SceneFileHeader));
+    header.meshTableOffset = offset;
+    offset = alignSection(offset + sizeof(MeshRecord) * header.meshCount);
+    header.stringsOffset = offset;
+    offset = alignSection(offset + header.stringsBytes);
+    for (int section = 0; section < SectionCount; section++) {
+        header.sectionOffsets[section] = offset;
+        offset = alignSection(offset + sectionBytes(Section(section), header.instanceCount));
+    }
+    header.fileSize = offset;
+}
+
+void writeFloat3(std::vector<unsigned char>& file, size_t offset, uint32_t index, simd::float3 value) {
+    float components[3] = {value.x, value.y, value.z};
+    std::memcpy(file.data() + offset + sizeof(components) * index, components, sizeof(components));
+}
+
+simd::float3 readFloat3(const float* values, uint32_t index) {
+    return simd::float3{values[index * 3], values[index * 3 + 1], values[index * 3 + 2]};
+}
+
+}
+
+BinaryScene::~BinaryScene() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+    }
+}
+
+std::unique_ptr<BinaryScene> BinaryScene::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open scene file: " << path << std::endl;
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(SceneFileHeader)) {
+        close(fd);
+        std::cerr << "Invalid binary scene file: " << path << std::endl;
+        return nullptr;
+    }
+
+    size_t fileSize = size_t(info.st_size);
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map scene file: " << path << std::endl;
+        return nullptr;
+    }
+
+    std::unique_ptr<BinaryScene> scene(new BinaryScene());
+    scene->mapping = mapping;
+    scene->mappingSize = fileSize;
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(mapping);
+    SceneFileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+
+    // Every offset is derived from the counts, so recomputing the layout checks all of them
+    SceneFileHeader expected = header;
+    if (header.magic == SCENE_MAGIC && header.version == SCENE_VERSION) {
+        layoutFile(expected);
+    }
+    if (header.magic != SCENE_MAGIC || header.version != SCENE_VERSION ||
+        std::memcmp(&header, &expected, sizeof(header)) != 0 || header.fileSize != fileSize) {
+        std::cerr << "Invalid binary scene file: " << path << std::endl;
+        return nullptr;
+    }
+
+    scene->meshes = header.meshCount;
+    scene->instances = header.instanceCount;
+    scene->meshRecords = reinterpret_cast<const MeshRecord*>(bytes + header.meshTableOffset);
+    scene->strings = reinterpret_cast<const char*>(bytes + header.stringsOffset);
+
+    // The mesh table is small, checking it here keeps the accessors free of bounds checks
+    for (uint32_t i = 0; i < header.meshCount; i++) {
+        const MeshRecord& record = scene->meshRecords[i];
+        if (uint64_t(record.nameOffset) + record.nameLength > header.stringsBytes ||
+            uint64_t(record.fileOffset) + record.fileLength > header.stringsBytes) {
+            std::cerr << "Invalid binary scene file: " << path << std::endl;
+            return nullptr;
+        }
+    }
+
+    scene->instanceMeshes = reinterpret_cast<const uint32_t*>(bytes + header.sectionOffsets[SectionInstanceMeshes]);
+    scene->positions = reinterpret_cast<const float*>(bytes + header.sectionOffsets[SectionPositions]);
+    scene->rotations = reinterpret_cast<const float*>(bytes + header.sectionOffsets[SectionRotations]);
+    scene->scales = reinterpret_cast<const float*>(bytes + header.sectionOffsets[SectionScales]);
+    scene->colors = reinterpret_cast<const float*>(bytes + header.sectionOffsets[SectionColors]);
+    scene->emissiveColors = reinterpret_cast<const float*>(bytes + header.sectionOffsets[SectionEmissiveColors]);
+    scene->flags = bytes + header.sectionOffsets[SectionFlags];
+
+    // Instances are read front to back while the meshes are created
+    madvise(mapping, fileSize, MADV_SEQUENTIAL);
+
+    return scene;
+}
+
+bool BinaryScene::write(const std::string& path, const SceneDescription& scene) {
+    SceneFileHeader header{};
+    header.magic = SCENE_MAGIC;
+    header.version = SCENE_VERSION;
+    header.meshCount = static_cast<uint32_t>(scene.meshNames.size());
+    header.instanceCount = static_cast<uint32_t>(scene.instanceCount());
+
+    std::vector<MeshRecord> records(header.meshCount);
+    std::string strings;
+    for (uint32_t i = 0; i < header.meshCount; i++) {
+        records[i].nameOffset = static_cast<uint32_t>(strings.size());
+        records[i].nameLength = static_cast<uint32_t>(scene.meshNames[i].size());
+        strings += scene.meshNames[i];
+        records[i].fileOffset = static_cast<uint32_t>(strings.size());
+        records[i].fileLength = static_cast<uint32_t>(scene.meshFiles[i].size());
+        strings += scene.meshFiles[i];
+    }
+    header.stringsBytes = strings.size();
+    layoutFile(header);
+
+    std::vector<unsigned char> file(header.fileSize, 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    if (!records.empty()) {
+        std::memcpy(file.data() + header.meshTableOffset, records.data(), sizeof(MeshRecord) * records.size());
+    }
+    std::memcpy(file.data() + header.stringsOffset, strings.data(), strings.size());
+
+    for (uint32_t i = 0; i < header.instanceCount; i++) {
+        const MeshInfo& info = scene.instances[i];
+        uint32_t mesh = scene.instanceMeshes[i];
+        std::memcpy(file.data() + header.sectionOffsets[SectionInstanceMeshes] + sizeof(uint32_t) * i, &mesh, sizeof(mesh));
+
+        writeFloat3(file, header.sectionOffsets[SectionPositions], i, info.position);
+        writeFloat3(file, header.sectionOffsets[SectionRotations], i, info.rotation);
+        writeFloat3(file, header.sectionOffsets[SectionScales], i, info.scale);
+        writeFloat3(file, header.sectionOffsets[SectionColors], i, info.color);
+        writeFloat3(file, header.sectionOffsets[SectionEmissiveColors], i, info.emissiveColor);
+
+        uint8_t instanceFlags = 0;
+        if (info.hasTextures) instanceFlags |= SceneInstanceHasTextures;
+        if (info.isEmissive) instanceFlags |= SceneInstanceIsEmissive;
+        file[header.sectionOffsets[SectionFlags] + i] = instanceFlags;
+    }
+
+    // Written next to the file and renamed over it, so a mapping of the old file keeps
+    // its contents and the watcher never sees a half written scene
+    std::string temporaryPath = path + ".tmp";
+    std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (output) {
+        output.write(reinterpret_cast<const char*>(file.data()), file.size());
+        output.close();
+    }
+    if (!output || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        std::cerr << "Failed to write scene file: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string_view BinaryScene::meshName(uint32_t index) const {
+    const MeshRecord& record = meshRecords[index];
+    return std::string_view(strings + record.nameOffset, record.nameLength);
+}
+
+std::string_view BinaryScene::meshFile(uint32_t index) const {
+    const MeshRecord& record = meshRecords[index];
+    return std::string_view(strings + record.fileOffset, record.fileLength);
+}
+
+MeshInfo BinaryScene::instance(uint32_t index) const {
+    MeshInfo info;
+    info.hasTextures = (flags[index] & SceneInstanceHasTextures) != 0;
+    info.isEmissive = (flags[index] & SceneInstanceIsEmissive) != 0;
+    info.position = readFloat3(positions, index);
+    info.rotation = readFloat3(rotations, index);
+    info.scale = readFloat3(scales, index);
+    info.color = readFloat3(colors, index);
+    info.emissiveColor = readFloat3(emissiveColors, index);
+    return info;
+}
+
+void BinaryScene::toDescription(SceneDescription& scene) const {
+    scene.clear();
+
+    scene.meshNames.reserve(meshes);
+    scene.meshFiles.reserve(meshes);
+    scene.meshPaths.reserve(meshes);
+    for (uint32_t i = 0; i < meshes; i++) {
+        scene.meshNames.emplace_back(meshName(i));
+        scene.meshFiles.emplace_back(meshFile(i));
+        scene.meshPaths.push_back(SceneReader::processPath(scene.meshFiles.back()));
+    }
+
+    scene.instanceMeshes.reserve(instances);
+    scene.instances.reserve(instances);
+    for (uint32_t i = 0; i < instances; i++) {
+        if (instanceMeshes[i] >= meshes) {
+            std::cerr << "Mesh not found: #" << instanceMeshes[i] << ", skipping object" << std::endl;
+            continue;
+        }
+        scene.instanceMeshes.push_back(instanceMeshes[i]);
+        scene.instances.push_back(instance(i));
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "vertexData.hpp"
+
+struct SceneDescription;
+
+constexpr const char* SCENE_BINARY_EXTENSION = ".rcscene";
+
+// Per instance flag bits in the binary instance table
+enum SceneInstanceFlags : uint8_t {
+    SceneInstanceHasTextures    = 1 << 0,
+    SceneInstanceIsEmissive     = 1 << 1,
+};
+
+// Read-only view of a binary scene. The file holds a string table with the mesh
+// declarations followed by one array per MeshInfo field, so opening it only maps the file
+// and checks the header; nothing is parsed or copied until an instance is read.
+//
+// Files are little endian, which covers every machine the renderer runs on.
+class BinaryScene {
+public:
+    ~BinaryScene();
+
+    BinaryScene(const BinaryScene&) = delete;
+    BinaryScene& operator=(const BinaryScene&) = delete;
+
+    // Returns nullptr and reports on std::cerr if the file is missing or damaged
+    static std::unique_ptr<BinaryScene> open(const std::string& path);
+    // Replaces the file instead of rewriting it, open mappings keep the old version
+    static bool write(const std::string& path, const SceneDescription& scene);
+
+    uint32_t meshCount() const { return meshes; }
+    std::string_view meshName(uint32_t index) const;
+    // As written in the source scene, macros included
+    std::string_view meshFile(uint32_t index) const;
+
+    uint32_t instanceCount() const { return instances; }
+    // May be out of range in a hand edited file, callers check against meshCount()
+    uint32_t instanceMesh(uint32_t index) const { return instanceMeshes[index]; }
+    MeshInfo instance(uint32_t index) const;
+
+    // Copies everything into a SceneDescription, resolving mesh paths on the way.
+    // Instances with an out of range mesh index are reported and skipped.
+    void toDescription(SceneDescription& scene) const;
+
+private:
+    BinaryScene() = default;
+
+    struct MeshRecord {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t fileOffset;
+        uint32_t fileLength;
+    };
+
+    void*                   mapping = nullptr;
+    size_t                  mappingSize = 0;
+
+    uint32_t                meshes = 0;
+    uint32_t                instances = 0;
+    const char*             strings = nullptr;
+    const MeshRecord*       meshRecords = nullptr;
+
+    const uint32_t*         instanceMeshes = nullptr;
+    const float*            positions = nullptr;    // Three floats per instance
+    const float*            rotations = nullptr;
+    const float*            scales = nullptr;
+    const float*            colors = nullptr;
+    const float*            emissiveColors = nullptr;
+    const uint8_t*          flags = nullptr;
+};
@@ -0,0 +1,788 @@
+#include "sceneDescription.hpp"
+#include "sceneBinary.hpp"
+#include "../fileReader.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+std::string sceneGeometryKey(const std::string& meshPath, bool hasTextures) {
+    return meshPath + (hasTextures ? "|textured" : "|plain");
+}
+
+simd::float4x4 meshTransformMatrix(const MeshInfo& info) {
+    simd::float4x4 scaleMatrix{simd::float4{info.scale.x, 0.0f, 0.0f, 0.0f},
+                               simd::float4{0.0f, info.scale.y, 0.0f, 0.0f},
+                               simd::float4{0.0f, 0.0f, info.scale.z, 0.0f},
+                               simd::float4{0.0f, 0.0f, 0.0f, 1.0f}};
+
+    const float toRadians = float(M_PI) / 180.0f;
+    float cosX = std::cos(info.rotation.x * toRadians);
+    float sinX = std::sin(info.rotation.x * toRadians);
+    float cosY = std::cos(info.rotation.y * toRadians);
+    float sinY = std::sin(info.rotation.y * toRadians);
+    float cosZ = std::cos(info.rotation.z * toRadians);
+    float sinZ = std::sin(info.rotation.z * toRadians);
+
+    simd::float4x4 rotX{simd::float4{1.0f, 0.0f, 0.0f, 0.0f},
+                        simd::float4{0.0f, cosX, sinX, 0.0f},
+                        simd::float4{0.0f, -sinX, cosX, 0.0f},
+                        simd::float4{0.0f, 0.0f, 0.0f, 1.0f}};
+
+    simd::float4x4 rotY{simd::float4{cosY, 0.0f, -sinY, 0.0f},
+                        simd::float4{0.0f, 1.0f, 0.0f, 0.0f},
+                        simd::float4{sinY, 0.0f, cosY, 0.0f},
+                        simd::float4{0.0f, 0.0f, 0.0f, 1.0f}};
+
+    simd::float4x4 rotZ{simd::float4{cosZ, sinZ, 0.0f, 0.0f},
+                        simd::float4{-sinZ, cosZ, 0.0f, 0.0f},
+                        simd::float4{0.0f, 0.0f, 1.0f, 0.0f},
+                        simd::float4{0.0f, 0.0f, 0.0f, 1.0f}};
+
+    // First Z, then Y, then X
+    simd::float4x4 rotationMatrix = matrix_multiply(matrix_multiply(rotZ, rotY), rotX);
+
+    simd::float4x4 posMatrix{simd::float4{1.0f, 0.0f, 0.0f, 0.0f},
+                             simd::float4{0.0f, 1.0f, 0.0f, 0.0f},
+                             simd::float4{0.0f, 0.0f, 1.0f, 0.0f},
+                             simd::float4{info.position.x, info.position.y, info.position.z, 1.0f}};
+
+    return matrix_multiply(posMatrix, matrix_multiply(rotationMatrix, scaleMatrix));
+}
+
+std::string SceneDescription::geometryKey(size_t index) const {
+    return sceneGeometryKey(meshPaths[instanceMeshes[index]], instances[index].hasTextures);
+}
+
+void SceneDescription::clear() {
+    meshNames.clear();
+    meshFiles.clear();
+    meshPaths.clear();
+    instanceMeshes.clear();
+    instances.clear();
+}
+
+namespace {
+
+// Declarations are collected first and resolved once the whole file has been seen,
+// since objects may reference meshes declared after them
+struct MeshDeclarations {
+    std::vector<std::string>                    names;
+    std::vector<std::string>                    files;
+    std::unordered_map<std::string, uint32_t>   indices;
+
+    void declare(const std::string& name, const std::string& file) {
+        auto it = indices.find(name);
+        if (it != indices.end()) {
+            // A later declaration with the same name wins
+            files[it->second] = file;
+            return;
+        }
+        indices.emplace(name, static_cast<uint32_t>(names.size()));
+        names.push_back(name);
+        files.push_back(file);
+    }
+
+    void resolve(SceneDescription& scene) const {
+        scene.meshNames = names;
+        scene.meshFiles = files;
+        scene.meshPaths.clear();
+        scene.meshPaths.reserve(files.size());
+        for (const std::string& file : files) {
+            scene.meshPaths.push_back(SceneReader::processPath(file));
+        }
+    }
+};
+
+// Rough size of one object in a scene file, used to reserve the instance arrays up front
+constexpr size_t BYTES_PER_OBJECT_ESTIMATE = 160;
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::vector<unsigned char> bytes;
+    if (!FileReader::shared().read(path, bytes)) {
+        std::cerr << "Failed to open scene file: " << path << std::endl;
+        return false;
+    }
+    contents.assign(bytes.begin(), bytes.end());
+    return true;
+}
+
+class SceneSaxHandler : public json::json_sax_t {
+public:
+    SceneSaxHandler(SceneDescription& scene, size_t expectedObjects) : scene(scene) {
+        scene.instances.reserve(expectedObjects);
+        scene.instanceMeshes.reserve(expectedObjects);
+        instanceOrdinals.reserve(expectedObjects);
+    }
+
+    bool null() override { return value(ValueType::Null); }
+    bool boolean(bool val) override { return value(ValueType::Boolean, 0.0, val); }
+    bool number_integer(number_integer_t val) override { return value(ValueType::Number, static_cast<double>(val)); }
+    bool number_unsigned(number_unsigned_t val) override { return value(ValueType::Number, static_cast<double>(val)); }
+    bool number_float(number_float_t val, const string_t&) override { return value(ValueType::Number, val); }
+    bool string(string_t& val) override { return value(ValueType::String, 0.0, false, &val); }
+    bool binary(binary_t&) override { return value(ValueType::Other); }
+
+    bool key(string_t& val) override {
+        if (skipDepth == 0) {
+            currentKey = val;
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        if (skipDepth > 0) {
+            skipDepth++;
+            return true;
+        }
+
+        Context parent = stack.empty() ? Context::None : stack.back();
+        if (parent == Context::Vector) {
+            vectorValue(ValueType::Object, 0.0);
+            skipDepth = 1;
+        } else if (parent == Context::None) {
+            stack.push_back(Context::Root);
+        } else if (parent == Context::Root && currentKey == "scene") {
+            stack.push_back(Context::Scene);
+        } else if (parent == Context::Meshes) {
+            stack.push_back(Context::MeshDeclaration);
+            meshDeclaration = PendingMesh();
+        } else if (parent == Context::Objects) {
+            stack.push_back(Context::Object);
+            object = PendingObject();
+        } else {
+            if (parent == Context::Object) {
+                objectValue(ValueType::Object);
+            }
+            skipDepth = 1;
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        if (skipDepth > 0) {
+            skipDepth--;
+            return true;
+        }
+
+        Context context = stack.back();
+        stack.pop_back();
+        if (context == Context::MeshDeclaration) {
+            if (meshDeclaration.hasName && meshDeclaration.hasFile) {
+                declarations.declare(meshDeclaration.name, meshDeclaration.file);
+            }
+        } else if (context == Context::Object) {
+            addObject();
+        }
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (skipDepth > 0) {
+            skipDepth++;
+            return true;
+        }
+
+        Context parent = stack.empty() ? Context::None : stack.back();
+        if (parent == Context::Scene && currentKey == "meshes") {
+            stack.push_back(Context::Meshes);
+        } else if (parent == Context::Scene && currentKey == "objects") {
+            stack.push_back(Context::Objects);
+        } else if (parent == Context::Object && vectorField(currentKey) != nullptr) {
+            stack.push_back(Context::Vector);
+            vector = vectorField(currentKey);
+            *vector = PendingVector();
+        } else {
+            if (parent == Context::Vector) {
+                vectorValue(ValueType::Array, 0.0);
+            } else if (parent == Context::Object) {
+                objectValue(ValueType::Array);
+            }
+            skipDepth = 1;
+        }
+        return true;
+    }
+
+    bool end_array() override {
+        if (skipDepth > 0) {
+            skipDepth--;
+            return true;
+        }
+        stack.pop_back();
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        std::cerr << "JSON parse error: " << ex.what() << std::endl;
+        return false;
+    }
+
+    // Maps mesh references to declarations and drops the objects that are skipped,
+    // reporting them in the order they appear in the file
+    void finish() {
+        declarations.resolve(scene);
+
+        std::vector<int64_t> declarationOf(referenceNames.size(), -1);
+        for (size_t i = 0; i < referenceNames.size(); i++) {
+            auto it = declarations.indices.find(referenceNames[i]);
+            if (it != declarations.indices.end()) {
+                declarationOf[i] = it->second;
+            }
+        }
+
+        struct Message {
+            uint32_t    ordinal;
+            std::string text;
+        };
+        std::vector<Message> messages;
+
+        for (const Failure& failure : failures) {
+            if (failure.reference < 0) {
+                messages.push_back({failure.ordinal, "Object missing mesh reference, skipping"});
+            } else if (declarationOf[failure.reference] < 0) {
+                messages.push_back({failure.ordinal, "Mesh not found: " + referenceNames[failure.reference] + ", skipping object"});
+            } else {
+                messages.push_back({failure.ordinal, "Error creating mesh '" + referenceNames[failure.reference] + "': " + failure.error});
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < scene.instances.size(); i++) {
+            int64_t declaration = declarationOf[scene.instanceMeshes[i]];
+            if (declaration < 0) {
+                messages.push_back({instanceOrdinals[i], "Mesh not found: " + referenceNames[scene.instanceMeshes[i]] + ", skipping object"});
+                continue;
+            }
+            scene.instances[kept] = scene.instances[i];
+            scene.instanceMeshes[kept] = static_cast<uint32_t>(declaration);
+            kept++;
+        }
+        scene.instances.resize(kept);
+        scene.instanceMeshes.resize(kept);
+
+        std::sort(messages.begin(), messages.end(), [](const Message& a, const Message& b) {
+            return a.ordinal < b.ordinal;
+        });
+        for (const Message& message : messages) {
+            std::cerr << message.text << std::endl;
+        }
+    }
+
+private:
+    enum class Context { None, Root, Scene, Meshes, MeshDeclaration, Objects, Object, Vector };
+    enum class ValueType { Null, Boolean, Number, String, Object, Array, Other };
+
+    static const char* typeName(ValueType type) {
+        switch (type) {
+            case ValueType::Null:       return "null";
+            case ValueType::Boolean:    return "boolean";
+            case ValueType::Number:     return "number";
+            case ValueType::String:     return "string";
+            case ValueType::Object:     return "object";
+            case ValueType::Array:      return "array";
+            default:                    return "binary";
+        }
+    }
+
+    // A three component array. Like the DOM reader, only arrays of exactly three
+    // elements are used, and those must hold numbers.
+    struct PendingVector {
+        float       values[3] = {0.0f, 0.0f, 0.0f};
+        size_t      count = 0;
+        ValueType   badType = ValueType::Number;
+        bool        present = false;
+    };
+
+    struct PendingBool {
+        bool        value = false;
+        ValueType   type = ValueType::Null;
+        bool        present = false;
+    };
+
+    struct PendingMesh {
+        std::string name;
+        std::string file;
+        bool        hasName = false;
+        bool        hasFile = false;
+    };
+
+    struct PendingObject {
+        std::string     mesh;
+        bool            hasMesh = false;
+        PendingVector   position;
+        PendingVector   scale;
+        PendingVector   color;
+        PendingVector   albedoColor;
+        PendingVector   emissiveColor;
+        PendingVector   rotation;
+        PendingBool     hasTextures;
+        PendingBool     isEmissive;
+    };
+
+    PendingVector* vectorField(const std::string& name) {
+        if (name == "pos")              return &object.position;
+        if (name == "scale")            return &object.scale;
+        if (name == "color")            return &object.color;
+        if (name == "albedoColor")      return &object.albedoColor;
+        if (name == "emissiveColor")    return &object.emissiveColor;
+        if (name == "rot")              return &object.rotation;
+        return nullptr;
+    }
+
+    bool value(ValueType type, double number = 0.0, bool boolean = false, const std::string* text = nullptr) {
+        if (skipDepth > 0 || stack.empty()) return true;
+
+        switch (stack.back()) {
+            case Context::Vector:
+                vectorValue(type, number);
+                break;
+            case Context::MeshDeclaration:
+                // Non string names are ignored like declarations without a name
+                if (type == ValueType::String && currentKey == "name") {
+                    meshDeclaration.name = *text;
+                    meshDeclaration.hasName = true;
+                } else if (type == ValueType::String && currentKey == "filename") {
+                    meshDeclaration.file = *text;
+                    meshDeclaration.hasFile = true;
+                }
+                break;
+            case Context::Object:
+                if (currentKey == "mesh" && type == ValueType::String) {
+                    object.mesh = *text;
+                    object.hasMesh = true;
+                } else if (currentKey == "hasTextures") {
+                    object.hasTextures = {boolean, type, true};
+                } else if (currentKey == "isEmissive") {
+                    object.isEmissive = {boolean, type, true};
+                } else {
+                    objectValue(type);
+                }
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    void vectorValue(ValueType type, double number) {
+        if (type == ValueType::Number) {
+            if (vector->count < 3) {
+                vector->values[vector->count] = static_cast<float>(number);
+            }
+        } else if (vector->badType == ValueType::Number && vector->count < 3) {
+            vector->badType = type;
+        }
+        vector->count++;
+        vector->present = true;
+    }
+
+    // A scalar or object under one of the vector keys replaces an earlier array with
+    // the same key, and is then ignored like the DOM reader ignores non arrays
+    void objectValue(ValueType type) {
+        if (PendingVector* field = vectorField(currentKey)) {
+            *field = PendingVector();
+            field->badType = type;
+        }
+    }
+
+    static bool readVector(const PendingVector& vector, simd::float3& out, bool& used, std::string& error) {
+        used = false;
+        if (!vector.present || vector.count != 3) return true;
+        if (vector.badType != ValueType::Number) {
+            error = std::string("[json.exception.type_error.302] type must be number, but is ") + typeName(vector.badType);
+            return false;
+        }
+        out = simd::float3{vector.values[0], vector.values[1], vector.values[2]};
+        used = true;
+        return true;
+    }
+
+    static bool readBool(const PendingBool& value, bool& out, std::string& error) {
+        if (value.type != ValueType::Boolean) {
+            error = std::string("[json.exception.type_error.302] type must be boolean, but is ") + typeName(value.type);
+            return false;
+        }
+        out = value.value;
+        return true;
+    }
+
+    static bool buildMeshInfo(const PendingObject& pending, MeshInfo& info, std::string& error) {
+        info.hasTextures = false;
+        bool used;
+
+        if (!readVector(pending.position, info.position, used, error)) return false;
+        if (!readVector(pending.scale, info.scale, used, error)) return false;
+
+        // Parse color - check for both color and albedoColor for compatibility
+        if (!readVector(pending.color, info.color, used, error)) return false;
+        if (!used && !readVector(pending.albedoColor, info.color, used, error)) return false;
+
+        if (pending.hasTextures.present && !readBool(pending.hasTextures, info.hasTextures, error)) return false;
+
+        if (pending.isEmissive.present) {
+            if (!readBool(pending.isEmissive, info.isEmissive, error)) return false;
+
+            if (info.isEmissive) {
+                if (!readVector(pending.emissiveColor, info.emissiveColor, used, error)) return false;
+                if (!used) {
+                    // Default emissive color if not specified
+                    info.emissiveColor = simd::float3{1.0f, 1.0f, 1.0f};
+                }
+            }
+        }
+
+        if (!readVector(pending.rotation, info.rotation, used, error)) return false;
+        return true;
+    }
+
+    // Objects go straight into the instance arrays as soon as they are closed. Until the
+    // declarations are resolved instanceMeshes holds an index into referenceNames.
+    void addObject() {
+        uint32_t ordinal = objectCount++;
+        if (!object.hasMesh) {
+            failures.push_back({ordinal, -1, std::string()});
+            return;
+        }
+
+        auto it = referenceIndices.find(object.mesh);
+        if (it == referenceIndices.end()) {
+            it = referenceIndices.emplace(object.mesh, static_cast<uint32_t>(referenceNames.size())).first;
+            referenceNames.push_back(object.mesh);
+        }
+
+        MeshInfo info;
+        std::string error;
+        if (!buildMeshInfo(object, info, error)) {
+            failures.push_back({ordinal, static_cast<int64_t>(it->second), error});
+            return;
+        }
+
+        scene.instances.push_back(info);
+        scene.instanceMeshes.push_back(it->second);
+        instanceOrdinals.push_back(ordinal);
+    }
+
+    struct Failure {
+        uint32_t    ordinal;
+        int64_t     reference;  // -1 when the object has no mesh key
+        std::string error;
+    };
+
+    SceneDescription&                           scene;
+    MeshDeclarations                            declarations;
+
+    std::vector<std::string>                    referenceNames;
+    std::unordered_map<std::string, uint32_t>   referenceIndices;
+    std::vector<uint32_t>                       instanceOrdinals;
+    std::vector<Failure>                        failures;
+    uint32_t                                    objectCount = 0;
+
+    std::vector<Context>        stack;
+    std::string                 currentKey;
+    int                         skipDepth = 0;
+
+    PendingMesh                 meshDeclaration;
+    PendingObject               object;
+    PendingVector*              vector = nullptr;
+};
+
+
+// Shortest decimal that reads back as the same float, so written scenes stay readable
+// and survive a round trip unchanged
+std::string formatFloat(float value) {
+    char text[32];
+    for (int precision = 1; precision <= 9; precision++) {
+        std::snprintf(text, sizeof(text), "%.*g", precision, value);
+        if (std::strtof(text, nullptr) == value) break;
+    }
+    std::string result = text;
+    if (result.find_first_of(".eEn") == std::string::npos) {
+        result += ".0";
+    }
+    return result;
+}
+
+std::string formatVector(simd::float3 value) {
+    return "[" + formatFloat(value.x) + ", " + formatFloat(value.y) + ", " + formatFloat(value.z) + "]";
+}
+
+bool hasExtension(const std::string& path, const std::string& extension) {
+    return path.size() >= extension.size() &&
+           path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+}
+
+bool SceneReader::isBinaryPath(const std::string& path) {
+    return hasExtension(path, SCENE_BINARY_EXTENSION);
+}
+
+bool SceneReader::read(const std::string& path, SceneDescription& scene) {
+    return isBinaryPath(path) ? readBinary(path, scene) : readJSON(path, scene);
+}
+
+bool SceneReader::readBinary(const std::string& binaryFilePath, SceneDescription& scene) {
+    scene.clear();
+
+    std::unique_ptr<BinaryScene> binary = BinaryScene::open(binaryFilePath);
+    if (!binary) {
+        return false;
+    }
+    binary->toDescription(scene);
+    return true;
+}
+
+bool SceneReader::readJSON(const std::string& jsonFilePath, SceneDescription& scene) {
+    scene.clear();
+
+    std::string contents;
+    if (!readFile(jsonFilePath, contents)) {
+        return false;
+    }
+
+    SceneSaxHandler handler(scene, contents.size() / BYTES_PER_OBJECT_ESTIMATE);
+    if (!json::sax_parse(contents.begin(), contents.end(), &handler)) {
+        scene.clear();
+        return false;
+    }
+
+    handler.finish();
+    return true;
+}
+
+bool SceneReader::readJSONDom(const std::string& jsonFilePath, SceneDescription& scene) {
+    scene.clear();
+
+    std::ifstream file(jsonFilePath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open scene file: " << jsonFilePath << std::endl;
+        return false;
+    }
+
+    json sceneData;
+    try {
+        file >> sceneData;
+    } catch (const json::parse_error& e) {
+        std::cerr << "JSON parse error: " << e.what() << std::endl;
+        file.close();
+        return false;
+    }
+    file.close();
+
+    MeshDeclarations declarations;
+
+    if (sceneData["scene"].contains("meshes") && sceneData["scene"]["meshes"].is_array()) {
+        for (const auto& meshDef : sceneData["scene"]["meshes"]) {
+            if (meshDef.contains("name") && meshDef.contains("filename")) {
+                std::string name = meshDef["name"];
+                std::string filename = meshDef["filename"];
+
+                declarations.declare(name, filename);
+            }
+        }
+    }
+    declarations.resolve(scene);
+
+    // Load object instances
+    if (sceneData["scene"].contains("objects") && sceneData["scene"]["objects"].is_array()) {
+        for (const auto& objDef : sceneData["scene"]["objects"]) {
+            if (!objDef.contains("mesh")) {
+                std::cerr << "Object missing mesh reference, skipping" << std::endl;
+                continue;
+            }
+
+            std::string meshName = objDef["mesh"];
+
+            // Find the referenced mesh path
+            auto meshIndex = declarations.indices.find(meshName);
+            if (meshIndex == declarations.indices.end()) {
+                std::cerr << "Mesh not found: " << meshName << ", skipping object" << std::endl;
+                continue;
+            }
+
+            try {
+                // Create mesh info for this instance
+                MeshInfo info;
+                info.hasTextures = false; // Default to false
+
+                // Parse position
+                if (objDef.contains("pos") && objDef["pos"].is_array() && objDef["pos"].size() == 3) {
+                    info.position = {
+                        objDef["pos"][0],
+                        objDef["pos"][1],
+                        objDef["pos"][2]
+                    };
+                }
+
+                // Parse scale
+                if (objDef.contains("scale") && objDef["scale"].is_array() && objDef["scale"].size() == 3) {
+                    info.scale = {
+                        objDef["scale"][0],
+                        objDef["scale"][1],
+                        objDef["scale"][2]
+                    };
+                }
+
+                // Parse color - check for both color and albedoColor for compatibility
+                if (objDef.contains("color") && objDef["color"].is_array() && objDef["color"].size() == 3) {
+                    info.color = {
+                        objDef["color"][0],
+                        objDef["color"][1],
+                        objDef["color"][2]
+                    };
+                } else if (objDef.contains("albedoColor") && objDef["albedoColor"].is_array() && objDef["albedoColor"].size() == 3) {
+                    info.color = {
+                        objDef["albedoColor"][0],
+                        objDef["albedoColor"][1],
+                        objDef["albedoColor"][2]
+                    };
+                }
+
+                if (objDef.contains("hasTextures")) {
+                    info.hasTextures = objDef["hasTextures"];
+                }
+
+                if (objDef.contains("isEmissive")) {
+                    info.isEmissive = objDef["isEmissive"];
+
+                    // If the object is emissive, parse the emissive color
+                    if (info.isEmissive && objDef.contains("emissiveColor") &&
+                        objDef["emissiveColor"].is_array() && objDef["emissiveColor"].size() == 3) {
+                        info.emissiveColor = {
+                            objDef["emissiveColor"][0],
+                            objDef["emissiveColor"][1],
+                            objDef["emissiveColor"][2]
+                        };
+
+                    } else if (info.isEmissive) {
+                        // Default emissive color if not specified
+                        info.emissiveColor = {1.0f, 1.0f, 1.0f};
+                    }
+                }
+
+                if (objDef.contains("rot") && objDef["rot"].is_array() && objDef["rot"].size() == 3) {
+                    info.rotation = {
+                        objDef["rot"][0],
+                        objDef["rot"][1],
+                        objDef["rot"][2]
+                    };
+                }
+
+                scene.instanceMeshes.push_back(meshIndex->second);
+                scene.instances.push_back(info);
+            } catch (const std::exception& e) {
+                std::cerr << "Error creating mesh '" << meshName << "': " << e.what() << std::endl;
+            }
+        }
+    }
+
+    return true;
+}
+
+std::string SceneReader::expandPathMacros(const std::string& path) {
+    // Check for @MODELS_PATH@ macro
+    std::string expandedPath = path;
+
+    const std::string modelsPathMacro = "@MODELS_PATH@";
+    size_t modelsPos = expandedPath.find(modelsPathMacro);
+    if (modelsPos != std::string::npos) {
+        expandedPath.replace(modelsPos, modelsPathMacro.length(), MODELS_PATH);
+    }
+
+    // Check for @SCENES_PATH@ macro
+    const std::string scenesPathMacro = "@SCENES_PATH@";
+    size_t scenesPos = expandedPath.find(scenesPathMacro);
+    if (scenesPos != std::string::npos) {
+        expandedPath.replace(scenesPos, scenesPathMacro.length(), SCENES_PATH);
+    }
+
+    // Check for @TEXTURE_PATH@ macro
+    const std::string texturePathMacro = "@TEXTURE_PATH@";
+    size_t texturePos = expandedPath.find(texturePathMacro);
+    if (texturePos != std::string::npos) {
+        expandedPath.replace(texturePos, texturePathMacro.length(), TEXTURE_PATH);
+    }
+
+    return expandedPath;
+}
+
+std::string SceneReader::processPath(const std::string& originalPath) {
+    std::string expandedPath = expandPathMacros(originalPath);
+
+    // Check if the expanded path exists directly
+    std::ifstream fileCheck(expandedPath);
+    if (fileCheck.good()) {
+        fileCheck.close();
+        return expandedPath;
+    }
+    fileCheck.close();
+
+    // If not found, try common alternatives
+    // Try with MODELS_PATH prefix if it's not already there
+    if (expandedPath.find(MODELS_PATH) == std::string::npos) {
+        std::string modelPath = std::string(MODELS_PATH) + "/" + expandedPath;
+        fileCheck.open(modelPath);
+        if (fileCheck.good()) {
+            fileCheck.close();
+            return modelPath;
+        }
+        fileCheck.close();
+    }
+
+    return expandedPath;
+}
+
+bool SceneWriter::write(const std::string& path, const SceneDescription& scene) {
+    return SceneReader::isBinaryPath(path) ? writeBinary(path, scene) : writeJSON(path, scene);
+}
+
+bool SceneWriter::writeBinary(const std::string& binaryFilePath, const SceneDescription& scene) {
+    return BinaryScene::write(binaryFilePath, scene);
+}
+
+bool SceneWriter::writeJSON(const std::string& jsonFilePath, const SceneDescription& scene) {
+    std::ofstream file(jsonFilePath, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write scene file: " << jsonFilePath << std::endl;
+        return false;
+    }
+
+    // Same layout as the hand written scenes, one key per line with vectors kept inline
+    file << "{\n    \"scene\": {\n        \"meshes\": [";
+    for (size_t i = 0; i < scene.meshNames.size(); i++) {
+        file << (i == 0 ? "\n" : ",\n")
+             << "            {\n"
+             << "                \"name\": " << json(scene.meshNames[i]).dump() << ",\n"
+             << "                \"filename\": " << json(scene.meshFiles[i]).dump() << "\n"
+             << "            }";
+    }
+    file << "\n        ],\n        \"objects\": [";
+
+    for (size_t i = 0; i < scene.instanceCount(); i++) {
+        const MeshInfo& info = scene.instances[i];
+        file << (i == 0 ? "\n" : ",\n")
+             << "            {\n"
+             << "                \"mesh\": " << json(scene.meshNames[scene.instanceMeshes[i]]).dump() << ",\n"
+             << "                \"pos\": " << formatVector(info.position) << ",\n"
+             << "                \"scale\": " << formatVector(info.scale) << ",\n"
+             << "                \"color\": " << formatVector(info.color) << ",\n"
+             << "                \"hasTextures\": " << (info.hasTextures ? "true" : "false") << ",\n"
+             << "                \"isEmissive\": " << (info.isEmissive ? "true" : "false") << ",\n";
+        // The readers ignore emissiveColor on objects that are not emissive
+        if (info.isEmissive) {
+            file << "                \"emissiveColor\": " << formatVector(info.emissiveColor) << ",\n";
+        }
+        file << "                \"rot\": " << formatVector(info.rotation) << "\n"
+             << "            }";
+    }
+    file << "\n        ]\n    }\n}\n";
+
+    return bool(file);
+}
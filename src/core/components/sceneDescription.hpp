@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "vertexData.hpp"
+
+// Everything a scene file declares, without any GPU objects. Instances are kept in
+// flat arrays so large scenes can be read without building a document in memory.
+struct SceneDescription {
+    // Declared meshes, indexed by the values in instanceMeshes
+    std::vector<std::string>    meshNames;
+    std::vector<std::string>    meshFiles;      // As written in the scene, macros included
+    std::vector<std::string>    meshPaths;      // Resolved on disk
+
+    // One entry per object whose mesh reference resolved, in declaration order
+    std::vector<uint32_t>       instanceMeshes;
+    std::vector<MeshInfo>       instances;
+
+    size_t instanceCount() const { return instances.size(); }
+    // Objects with the same key load the same file the same way and can share geometry
+    std::string geometryKey(size_t index) const;
+    void clear();
+};
+
+std::string sceneGeometryKey(const std::string& meshPath, bool hasTextures);
+// Object to world transform of an instance: scale, then rotation around Z, Y and X, then
+// the position. Shared by the renderer and the code that works on scenes without Metal.
+simd::float4x4 meshTransformMatrix(const MeshInfo& info);
+
+// Reads scene files into a SceneDescription. Errors are reported on std::cerr with the
+// same messages for every reader; objects that fail are skipped, a file that cannot be
+// read or parsed returns false.
+class SceneReader {
+public:
+    // Picks the reader from the extension, binary for SCENE_BINARY_EXTENSION and JSON otherwise
+    static bool read(const std::string& path, SceneDescription& scene);
+
+    // Streams the JSON through a SAX handler straight into the instance arrays
+    static bool readJSON(const std::string& jsonFilePath, SceneDescription& scene);
+    // Builds an nlohmann::json document first and walks it. Kept as a reference for the
+    // SAX reader and for benchmarking.
+    static bool readJSONDom(const std::string& jsonFilePath, SceneDescription& scene);
+    static bool readBinary(const std::string& binaryFilePath, SceneDescription& scene);
+
+    static bool isBinaryPath(const std::string& path);
+
+    static std::string expandPathMacros(const std::string& path);
+    static std::string processPath(const std::string& originalPath);
+};
+
+// Writes a SceneDescription back out. Every MeshInfo field is written explicitly, so a
+// scene converted to binary and back reads into exactly the same description.
+class SceneWriter {
+public:
+    // Picks the format from the extension like SceneReader::read
+    static bool write(const std::string& path, const SceneDescription& scene);
+
+    static bool writeJSON(const std::string& jsonFilePath, const SceneDescription& scene);
+    static bool writeBinary(const std::string& binaryFilePath, const SceneDescription& scene);
+};
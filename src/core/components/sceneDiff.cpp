@@ -0,0 +1,94 @@
+#include "sceneDiff.hpp"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+bool sameVector(simd::float3 a, simd::float3 b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+}
+
+SceneDiff SceneDiff::compute(const SceneDescription& previous, const SceneDescription& next) {
+    SceneDiff diff;
+    diff.changes.resize(next.instanceCount(), SceneObjectUnchanged);
+    diff.previousIndex.resize(next.instanceCount(), -1);
+    diff.reuseFrom.resize(next.instanceCount(), -1);
+
+    struct MeshObjects {
+        std::vector<uint32_t>   indices;
+        size_t                  matched = 0;
+    };
+    std::unordered_map<std::string, MeshObjects> previousObjects;
+    for (size_t i = 0; i < previous.instanceCount(); i++) {
+        previousObjects[previous.meshNames[previous.instanceMeshes[i]]].indices.push_back(static_cast<uint32_t>(i));
+    }
+
+    for (size_t i = 0; i < next.instanceCount(); i++) {
+        auto it = previousObjects.find(next.meshNames[next.instanceMeshes[i]]);
+        if (it == previousObjects.end() || it->second.matched == it->second.indices.size()) {
+            diff.changes[i] = SceneObjectAdded;
+            diff.createdCount++;
+            continue;
+        }
+
+        uint32_t match = it->second.indices[it->second.matched++];
+        diff.previousIndex[i] = match;
+
+        const MeshInfo& before = previous.instances[match];
+        const MeshInfo& after = next.instances[i];
+
+        if (previous.geometryKey(match) != next.geometryKey(i)) {
+            diff.changes[i] = SceneObjectRecreated;
+            diff.createdCount++;
+            continue;
+        }
+
+        if (!sameVector(before.position, after.position) || !sameVector(before.rotation, after.rotation) ||
+            !sameVector(before.scale, after.scale)) {
+            diff.changes[i] |= SceneObjectMoved;
+            diff.movedCount++;
+        }
+        if (!sameVector(before.color, after.color) || before.isEmissive != after.isEmissive ||
+            !sameVector(before.emissiveColor, after.emissiveColor)) {
+            diff.changes[i] |= SceneObjectRestyled;
+            diff.restyledCount++;
+        }
+    }
+
+    for (const auto& [name, objects] : previousObjects) {
+        diff.removed.insert(diff.removed.end(), objects.indices.begin() + objects.matched, objects.indices.end());
+    }
+    std::sort(diff.removed.begin(), diff.removed.end());
+
+    // Kept objects already hold their geometry. Objects that need a mesh are created in
+    // order, so each one can also copy from an earlier one that loaded the same file.
+    std::unordered_map<std::string, int64_t> geometryHolders;
+    for (size_t i = 0; i < next.instanceCount(); i++) {
+        if (!diff.needsMesh(i)) {
+            geometryHolders.emplace(next.geometryKey(i), static_cast<int64_t>(i));
+        }
+    }
+    for (size_t i = 0; i < next.instanceCount(); i++) {
+        if (!diff.needsMesh(i)) continue;
+
+        auto [it, inserted] = geometryHolders.emplace(next.geometryKey(i), static_cast<int64_t>(i));
+        if (!inserted) {
+            diff.reuseFrom[i] = it->second;
+            diff.reusedCount++;
+        }
+    }
+
+    return diff;
+}
+
+bool SceneDiff::canRefit() const {
+    if (createdCount > 0 || !removed.empty()) return false;
+    for (size_t i = 0; i < previousIndex.size(); i++) {
+        if (previousIndex[i] != static_cast<int64_t>(i)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "sceneDescription.hpp"
+
+// What happened to one object between two versions of a scene. Kept objects can be
+// updated in place, the others need a new mesh.
+enum SceneObjectChanges : uint8_t {
+    SceneObjectUnchanged    = 0,
+    SceneObjectMoved        = 1 << 0,   // Position, rotation or scale
+    SceneObjectRestyled     = 1 << 1,   // Color or emission
+    SceneObjectRecreated    = 1 << 2,   // Mesh file or hasTextures changed, geometry is reloaded
+    SceneObjectAdded        = 1 << 3,
+};
+
+// Difference between two scene descriptions, computed without touching any GPU state.
+//
+// Objects have no identity in the scene file, so they are matched per mesh name in file
+// order: the n-th object using a mesh in the old scene becomes the n-th object using that
+// mesh in the new one. Editing a transform or color keeps the match, inserting an object
+// only shifts the objects of the same mesh that follow it.
+struct SceneDiff {
+    // One entry per object of the new scene
+    std::vector<uint8_t>    changes;
+    // Matching object in the old scene, -1 for added objects
+    std::vector<int64_t>    previousIndex;
+    // For objects that need a mesh, an object of the new scene that is either kept or
+    // created before it and has the same geometry, so its vertices can be copied instead of
+    // parsing the file again. -1 if the file has to be loaded.
+    std::vector<int64_t>    reuseFrom;
+    // Objects of the old scene with no match in the new one
+    std::vector<uint32_t>   removed;
+
+    size_t movedCount = 0;
+    size_t restyledCount = 0;
+    size_t createdCount = 0;
+    size_t reusedCount = 0;
+
+    static SceneDiff compute(const SceneDescription& previous, const SceneDescription& next);
+
+    bool empty() const { return movedCount == 0 && restyledCount == 0 && createdCount == 0 && removed.empty(); }
+    // Every object keeps its mesh and its place in the object list, so the acceleration
+    // structure keeps its topology and only needs a refit
+    bool canRefit() const;
+
+    bool needsMesh(size_t index) const { return (changes[index] & (SceneObjectRecreated | SceneObjectAdded)) != 0; }
+};
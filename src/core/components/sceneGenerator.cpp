@@ -0,0 +1,213 @@
+#include "sceneGenerator.hpp"
+#include "sceneDescription.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr size_t CITY_BLOCK_SIDE = 4;               // Buildings along each side of a block
+constexpr float  CITY_STREET_WIDTH = 2.0f;          // In spacings
+constexpr size_t CLUSTER_OBJECTS_PER_SIDE = 4;      // Clusters grow with sqrt(count) / this
+
+// splitmix64, small and identical on every platform
+class SceneRandom {
+public:
+    explicit SceneRandom(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // [0, 1)
+    float unit() { return static_cast<float>(next() >> 40) * (1.0f / 16777216.0f); }
+    float range(float low, float high) { return low + (high - low) * unit(); }
+    uint32_t below(uint32_t count) { return static_cast<uint32_t>(next() % count); }
+
+private:
+    uint64_t state;
+};
+
+// Keeps the written scenes short and readable
+float quantize(float value) {
+    return std::round(value * 1000.0f) / 1000.0f;
+}
+
+simd::float3 quantize(simd::float3 value) {
+    return simd::float3{quantize(value.x), quantize(value.y), quantize(value.z)};
+}
+
+struct Placement {
+    simd::float3 position;  // y is the height of the object's base above the ground
+    simd::float3 scale;
+};
+
+size_t ceilSqrt(size_t value) {
+    size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(value)));
+    while (side * side < value) side++;
+    return std::max<size_t>(side, 1);
+}
+
+Placement gridPlacement(const SceneGeneratorSettings& settings, size_t index) {
+    size_t side = ceilSqrt(settings.count);
+    float center = (side - 1) * 0.5f;
+    return {
+        simd::float3{(index % side - center) * settings.spacing, 0.0f, (index / side - center) * settings.spacing},
+        simd::float3{1.0f, 1.0f, 1.0f}
+    };
+}
+
+Placement cityPlacement(const SceneGeneratorSettings& settings, size_t index, SceneRandom& random) {
+    const size_t lotsPerBlock = CITY_BLOCK_SIDE * CITY_BLOCK_SIDE;
+    size_t blockSide = ceilSqrt((settings.count + lotsPerBlock - 1) / lotsPerBlock);
+    float blockPitch = (CITY_BLOCK_SIDE + CITY_STREET_WIDTH) * settings.spacing;
+    float center = (blockSide * blockPitch - CITY_STREET_WIDTH * settings.spacing) * 0.5f;
+
+    size_t block = index / lotsPerBlock;
+    size_t lot = index % lotsPerBlock;
+    float x = (block % blockSide) * blockPitch + (lot % CITY_BLOCK_SIDE + 0.5f) * settings.spacing - center;
+    float z = (block / blockSide) * blockPitch + (lot / CITY_BLOCK_SIDE + 0.5f) * settings.spacing - center;
+
+    // Mostly low buildings with the occasional tower
+    float height = settings.spacing * (0.3f + 3.0f * std::pow(random.unit(), 3.0f));
+    float footprint = settings.spacing * 0.4f;
+    return {simd::float3{x, 0.0f, z}, simd::float3{footprint, height, footprint}};
+}
+
+struct Cluster {
+    simd::float3 center;
+    float        radius;
+};
+
+std::vector<Cluster> makeClusters(const SceneGeneratorSettings& settings, SceneRandom& random) {
+    size_t clusterCount = std::max<size_t>(1, ceilSqrt(settings.count) / CLUSTER_OBJECTS_PER_SIDE);
+    float extent = settings.spacing * ceilSqrt(settings.count) * 1.5f;
+    float radius = settings.spacing * std::sqrt(static_cast<float>(settings.count) / clusterCount) * 0.6f;
+
+    std::vector<Cluster> clusters(clusterCount);
+    for (Cluster& cluster : clusters) {
+        cluster.center = simd::float3{random.range(-0.5f, 0.5f) * extent, 0.0f, random.range(-0.5f, 0.5f) * extent};
+        cluster.radius = radius * random.range(0.5f, 1.5f);
+    }
+    return clusters;
+}
+
+Placement clusterPlacement(const std::vector<Cluster>& clusters, SceneRandom& random) {
+    const Cluster& cluster = clusters[random.below(static_cast<uint32_t>(clusters.size()))];
+
+    // Sum of uniforms, dense in the middle and thinning out towards the edge
+    auto falloff = [&random]() {
+        return (random.range(-1.0f, 1.0f) + random.range(-1.0f, 1.0f) + random.range(-1.0f, 1.0f)) / 3.0f;
+    };
+    simd::float3 offset{falloff() * cluster.radius, std::abs(falloff()) * cluster.radius * 0.3f, falloff() * cluster.radius};
+    return {cluster.center + offset, simd::float3{1.0f, 1.0f, 1.0f}};
+}
+
+}
+
+bool parseSceneLayout(const std::string& name, SceneLayout& layout) {
+    if (name == "grid")     { layout = SceneLayout::Grid;    return true; }
+    if (name == "cluster")  { layout = SceneLayout::Cluster; return true; }
+    if (name == "city")     { layout = SceneLayout::City;    return true; }
+    return false;
+}
+
+const char* sceneLayoutName(SceneLayout layout) {
+    switch (layout) {
+        case SceneLayout::Grid:     return "grid";
+        case SceneLayout::Cluster:  return "cluster";
+        case SceneLayout::City:     return "city";
+    }
+    return "unknown";
+}
+
+void generateScene(const SceneGeneratorSettings& settings, SceneDescription& scene) {
+    scene.clear();
+
+    // Each aspect gets its own stream so e.g. changing the jitter does not move the colors
+    SceneRandom layoutRandom(settings.seed);
+    SceneRandom jitterRandom(settings.seed ^ 0x6A09E667F3BCC908ull);
+    SceneRandom materialRandom(settings.seed ^ 0xBB67AE8584CAA73Bull);
+
+    for (const SceneGeneratorSettings::MeshSource& mesh : settings.meshes) {
+        scene.meshNames.push_back(mesh.name);
+        scene.meshFiles.push_back(mesh.file);
+    }
+    uint32_t meshCount = static_cast<uint32_t>(settings.meshes.size());
+
+    uint32_t groundIndex = 0;
+    if (settings.groundPlane) {
+        groundIndex = static_cast<uint32_t>(scene.meshNames.size());
+        scene.meshNames.push_back(settings.groundMesh.name);
+        scene.meshFiles.push_back(settings.groundMesh.file);
+    }
+
+    for (const std::string& file : scene.meshFiles) {
+        scene.meshPaths.push_back(SceneReader::processPath(file));
+    }
+
+    std::vector<Cluster> clusters;
+    if (settings.layout == SceneLayout::Cluster) {
+        clusters = makeClusters(settings, layoutRandom);
+    }
+
+    scene.instanceMeshes.reserve(settings.count + 1);
+    scene.instances.reserve(settings.count + 1);
+
+    simd::float3 boundsMin{0.0f, 0.0f, 0.0f};
+    simd::float3 boundsMax{0.0f, 0.0f, 0.0f};
+
+    for (size_t i = 0; i < settings.count && meshCount > 0; i++) {
+        Placement placement;
+        switch (settings.layout) {
+            case SceneLayout::Grid:     placement = gridPlacement(settings, i); break;
+            case SceneLayout::Cluster:  placement = clusterPlacement(clusters, layoutRandom); break;
+            case SceneLayout::City:     placement = cityPlacement(settings, i, layoutRandom); break;
+        }
+
+        MeshInfo info;
+        info.scale = placement.scale * (1.0f + jitterRandom.range(-0.5f, 0.5f) * settings.jitter);
+        info.rotation = simd::float3{0.0f, jitterRandom.range(-180.0f, 180.0f) * settings.jitter, 0.0f};
+        info.position = placement.position + simd::float3{
+            jitterRandom.range(-0.5f, 0.5f) * settings.jitter * settings.spacing,
+            0.0f,
+            jitterRandom.range(-0.5f, 0.5f) * settings.jitter * settings.spacing
+        };
+        // Sit on the ground, the meshes span [-1, 1]
+        info.position.y += info.scale.y;
+
+        info.color = simd::float3{materialRandom.range(0.35f, 0.95f), materialRandom.range(0.35f, 0.95f), materialRandom.range(0.35f, 0.95f)};
+        info.isEmissive = materialRandom.unit() < settings.emissiveFraction;
+        if (info.isEmissive) {
+            info.emissiveColor = simd::float3{materialRandom.range(0.2f, 1.5f), materialRandom.range(0.2f, 1.5f), materialRandom.range(0.2f, 1.5f)};
+        }
+
+        info.position = quantize(info.position);
+        info.scale = quantize(info.scale);
+        info.rotation = quantize(info.rotation);
+        info.color = quantize(info.color);
+        info.emissiveColor = quantize(info.emissiveColor);
+
+        uint32_t meshIndex = settings.layout == SceneLayout::Grid ? static_cast<uint32_t>(i % meshCount)
+                                                                  : materialRandom.below(meshCount);
+        scene.instanceMeshes.push_back(meshIndex);
+        scene.instances.push_back(info);
+
+        boundsMin = simd::min(boundsMin, info.position - info.scale);
+        boundsMax = simd::max(boundsMax, info.position + info.scale);
+    }
+
+    if (settings.groundPlane) {
+        MeshInfo ground;
+        simd::float3 center = (boundsMin + boundsMax) * 0.5f;
+        simd::float3 halfSize = (boundsMax - boundsMin) * 0.5f + settings.spacing;
+        ground.position = quantize(simd::float3{center.x, 0.0f, center.z});
+        ground.scale = quantize(simd::float3{halfSize.x, 1.0f, halfSize.z});
+        ground.color = simd::float3{0.8f, 0.8f, 0.8f};
+        scene.instanceMeshes.push_back(groundIndex);
+        scene.instances.push_back(ground);
+    }
+}
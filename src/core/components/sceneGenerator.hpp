@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sceneDescription.hpp"
+
+enum class SceneLayout {
+    Grid,       // Evenly spaced square grid
+    Cluster,    // Dense groups scattered over the area
+    City,       // Blocks of buildings with varying heights separated by streets
+};
+
+struct SceneGeneratorSettings {
+    struct MeshSource {
+        std::string name;
+        std::string file;
+    };
+
+    size_t          count = 1000;
+    SceneLayout     layout = SceneLayout::Grid;
+    // Distance between neighbouring objects, the meshes are assumed to span [-1, 1]
+    float           spacing = 3.0f;
+    float           emissiveFraction = 0.05f;
+    // 0 keeps the layout exact. 1 moves objects by up to half a spacing either way, rotates
+    // them freely around the up axis and varies their scale by up to 50%.
+    float           jitter = 0.0f;
+    uint64_t        seed = 1;
+    // Adds a quad under everything, which is not counted in count
+    bool            groundPlane = false;
+
+    std::vector<MeshSource> meshes = {{"cube", "@MODELS_PATH@/cube.obj"}};
+    MeshSource              groundMesh = {"quad", "@MODELS_PATH@/quad.obj"};
+};
+
+bool parseSceneLayout(const std::string& name, SceneLayout& layout);
+const char* sceneLayoutName(SceneLayout layout);
+
+// Builds a synthetic scene for scaling tests. The output only depends on the settings:
+// the random numbers come from a fixed generator rather than <random> distributions,
+// whose results differ between standard libraries.
+void generateScene(const SceneGeneratorSettings& settings, SceneDescription& scene);
@@ -1,10 +1,11 @@
 #include "sceneParser.hpp"
+#include "sceneDescription.hpp"
+#include "sceneBinary.hpp"
 #include "mesh.hpp"
+#include "../fileReader.hpp"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
-#include <nlohmann/json.hpp>
-
-using json = nlohmann::json;
 
 SceneParser::SceneParser(MTL::Device* device, MTL::VertexDescriptor* vertexDescriptor)
     : metalDevice(device), defaultVertexDescriptor(vertexDescriptor) {
@@ -13,187 +14,147 @@ SceneParser::SceneParser(MTL::Device* device, MTL::VertexDescriptor* vertexDescr
 SceneParser::~SceneParser() {
 }
 
-std::vector<Mesh*> SceneParser::loadScene(const std::string& jsonFilePath) {
-    std::vector<Mesh*> meshes;
-    
-    std::ifstream file(jsonFilePath);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open scene file: " << jsonFilePath << std::endl;
-        return meshes;
-    }
-    
-    json sceneData;
-    try {
-        file >> sceneData;
-    } catch (const json::parse_error& e) {
-        std::cerr << "JSON parse error: " << e.what() << std::endl;
-        file.close();
-        return meshes;
+std::vector<Mesh*> SceneParser::createObjects(const SceneDescription& scene) {
+    return instantiate(scene.instanceCount(), [&scene](size_t index, MeshInfo& info) {
+        info = scene.instances[index];
+        return scene.instanceMeshes[index];
+    }, scene.meshNames, scene.meshPaths);
+}
+
+std::vector<Mesh*> SceneParser::createObjects(const BinaryScene& scene) {
+    // Only the mesh table is resolved up front
+    std::vector<std::string> meshNames(scene.meshCount());
+    std::vector<std::string> meshPaths(scene.meshCount());
+    for (uint32_t i = 0; i < scene.meshCount(); i++) {
+        meshNames[i] = std::string(scene.meshName(i));
+        meshPaths[i] = processPath(std::string(scene.meshFile(i)));
     }
-    file.close();
-    
-    std::unordered_map<std::string, std::string> meshPaths;
     
-    if (sceneData["scene"].contains("meshes") && sceneData["scene"]["meshes"].is_array()) {
-        for (const auto& meshDef : sceneData["scene"]["meshes"]) {
-            if (meshDef.contains("name") && meshDef.contains("filename")) {
-                std::string name = meshDef["name"];
-                std::string filename = meshDef["filename"];
+    return instantiate(scene.instanceCount(), [&scene](size_t index, MeshInfo& info) {
+        info = scene.instance(static_cast<uint32_t>(index));
+        return scene.instanceMesh(static_cast<uint32_t>(index));
+    }, meshNames, meshPaths);
+}
 
-                std::string resolvedPath = processPath(filename);
-                meshPaths[name] = resolvedPath;
-            }
-        }
-    }
+std::vector<Mesh*> SceneParser::instantiate(size_t instanceCount, const InstanceReader& readInstance,
+                                            const std::vector<std::string>& meshNames,
+                                            const std::vector<std::string>& meshPaths) {
+    std::vector<Mesh*> objects(instanceCount, nullptr);
+    MeshInfo info;
     
-    // Load object instances
-    if (sceneData["scene"].contains("objects") && sceneData["scene"]["objects"].is_array()) {
-        for (const auto& objDef : sceneData["scene"]["objects"]) {
-            if (!objDef.contains("mesh")) {
-                std::cerr << "Object missing mesh reference, skipping" << std::endl;
-                continue;
-            }
-            
-            std::string meshName = objDef["mesh"];
-            
-            // Find the referenced mesh path
-            if (meshPaths.find(meshName) == meshPaths.end()) {
-                std::cerr << "Mesh not found: " << meshName << ", skipping object" << std::endl;
+    if (!parallelLoading) {
+        for (size_t i = 0; i < instanceCount; i++) {
+            uint32_t meshIndex = readInstance(i, info);
+            if (meshIndex >= meshNames.size()) {
+                std::cerr << "Mesh not found: #" << meshIndex << ", skipping object" << std::endl;
                 continue;
             }
-            
-            try {
-                // Create mesh info for this instance
-                MeshInfo info;
-                info.hasTextures = false; // Default to false
-                
-                // Parse position
-                if (objDef.contains("pos") && objDef["pos"].is_array() && objDef["pos"].size() == 3) {
-                    info.position = {
-                        objDef["pos"][0],
-                        objDef["pos"][1],
-                        objDef["pos"][2]
-                    };
-                }
-                
-                // Parse scale
-                if (objDef.contains("scale") && objDef["scale"].is_array() && objDef["scale"].size() == 3) {
-                    info.scale = {
-                        objDef["scale"][0],
-                        objDef["scale"][1],
-                        objDef["scale"][2]
-                    };
-                }
-                
-                // Parse color - check for both color and albedoColor for compatibility
-                if (objDef.contains("color") && objDef["color"].is_array() && objDef["color"].size() == 3) {
-                    info.color = {
-                        objDef["color"][0],
-                        objDef["color"][1],
-                        objDef["color"][2]
-                    };
-                } else if (objDef.contains("albedoColor") && objDef["albedoColor"].is_array() && objDef["albedoColor"].size() == 3) {
-                    info.color = {
-                        objDef["albedoColor"][0],
-                        objDef["albedoColor"][1],
-                        objDef["albedoColor"][2]
-                    };
-                }
-                
-                if (objDef.contains("hasTextures")) {
-                    info.hasTextures = objDef["hasTextures"];
-                }
-                
-                if (objDef.contains("isEmissive")) {
-                    info.isEmissive = objDef["isEmissive"];
-                    
-                    // If the object is emissive, parse the emissive color
-                    if (info.isEmissive && objDef.contains("emissiveColor") && 
-                        objDef["emissiveColor"].is_array() && objDef["emissiveColor"].size() == 3) {
-                        info.emissiveColor = {
-                            objDef["emissiveColor"][0],
-                            objDef["emissiveColor"][1],
-                            objDef["emissiveColor"][2]
-                        };
-
-                    } else if (info.isEmissive) {
-                        // Default emissive color if not specified
-                        info.emissiveColor = {1.0f, 1.0f, 1.0f};
-                    }
-                }
-
-                if (objDef.contains("rot") && objDef["rot"].is_array() && objDef["rot"].size() == 3) {
-                    info.rotation = {
-                        objDef["rot"][0],
-                        objDef["rot"][1],
-                        objDef["rot"][2]
-                    };
-                }
-                
-                std::string meshPath = meshPaths[meshName];
-                Mesh* newMesh = new Mesh(meshPath.c_str(), metalDevice, defaultVertexDescriptor, info);
-                
-                newMesh->defaultVertexAttributes();
-                
-                meshes.push_back(newMesh);
-            } catch (const std::exception& e) {
-                std::cerr << "Error creating mesh '" << meshName << "': " << e.what() << std::endl;
-            }
+            objects[i] = createMesh(meshNames[meshIndex], meshPaths[meshIndex], info);
         }
+        return objects;
     }
     
-    return meshes;
-}
-
-std::string SceneParser::expandPathMacros(const std::string& path) {
-    // Check for @MODELS_PATH@ macro
-    std::string expandedPath = path;
+    // Resolve the unique geometries first, in order of first use. The first object using
+    // a geometry owns the loaded mesh, the ones after it become instances of it.
+    struct Geometry {
+        uint32_t    meshIndex;
+        size_t      firstObject;
+        MeshInfo    info;
+        Mesh*       mesh = nullptr;
+        std::string error;
+    };
+    std::vector<Geometry> geometries;
+    std::vector<int64_t> objectGeometries(instanceCount, -1);
+    std::unordered_map<std::string, size_t> geometryIndices;
     
-    const std::string modelsPathMacro = "@MODELS_PATH@";
-    size_t modelsPos = expandedPath.find(modelsPathMacro);
-    if (modelsPos != std::string::npos) {
-        expandedPath.replace(modelsPos, modelsPathMacro.length(), MODELS_PATH);
+    for (size_t i = 0; i < instanceCount; i++) {
+        uint32_t meshIndex = readInstance(i, info);
+        if (meshIndex >= meshNames.size()) continue;
+        
+        auto [it, inserted] = geometryIndices.emplace(sceneGeometryKey(meshPaths[meshIndex], info.hasTextures), geometries.size());
+        if (inserted) {
+            geometries.push_back({meshIndex, i, info});
+        }
+        objectGeometries[i] = static_cast<int64_t>(it->second);
     }
     
-    // Check for @SCENES_PATH@ macro
-    const std::string scenesPathMacro = "@SCENES_PATH@";
-    size_t scenesPos = expandedPath.find(scenesPathMacro);
-    if (scenesPos != std::string::npos) {
-        expandedPath.replace(scenesPos, scenesPathMacro.length(), SCENES_PATH);
+    // The OBJ files are read as one batch. Parsing, welding and tangents start on the
+    // scheduler as soon as a file is in memory. Texture arrays are decoded on it as well,
+    // the loaders help with that work while they wait for their images.
+    std::vector<std::string> geometryPaths;
+    for (const Geometry& geometry : geometries) {
+        geometryPaths.push_back(meshPaths[geometry.meshIndex]);
     }
+    FileReader::shared().readAll(geometryPaths, [&](size_t g, std::vector<unsigned char>& bytes, bool ok) {
+        Geometry& geometry = geometries[g];
+        if (!ok) {
+            geometry.error = "Failed to read " + geometryPaths[g];
+            return;
+        }
+        
+        NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+        
+        Mesh* mesh = new Mesh(metalDevice, geometry.info);
+        try {
+            mesh->loadObj(geometryPaths[g], bytes);
+            geometry.mesh = mesh;
+        } catch (const std::exception& e) {
+            geometry.error = e.what();
+            delete mesh;
+        }
+        
+        pool->release();
+    });
     
-    // Check for @TEXTURE_PATH@ macro
-    const std::string texturePathMacro = "@TEXTURE_PATH@";
-    size_t texturePos = expandedPath.find(texturePathMacro);
-    if (texturePos != std::string::npos) {
-        expandedPath.replace(texturePos, texturePathMacro.length(), TEXTURE_PATH);
+    // GPU buffers are created here on the calling thread, in declaration order, so the
+    // result and the log do not depend on which loader finished first
+    for (size_t i = 0; i < instanceCount; i++) {
+        uint32_t meshIndex = readInstance(i, info);
+        if (objectGeometries[i] < 0) {
+            std::cerr << "Mesh not found: #" << meshIndex << ", skipping object" << std::endl;
+            continue;
+        }
+        
+        Geometry& geometry = geometries[objectGeometries[i]];
+        if (geometry.firstObject == i && geometry.mesh) {
+            try {
+                geometry.mesh->createBuffers(defaultVertexDescriptor);
+                geometry.mesh->defaultVertexAttributes();
+            } catch (const std::exception& e) {
+                geometry.error = e.what();
+                delete geometry.mesh;
+                geometry.mesh = nullptr;
+            }
+        }
+        
+        if (!geometry.mesh) {
+            std::cerr << "Error creating mesh '" << meshNames[meshIndex] << "': " << geometry.error << std::endl;
+            continue;
+        }
+        
+        objects[i] = geometry.firstObject == i ? geometry.mesh : new Mesh(*geometry.mesh, info);
     }
     
-    return expandedPath;
+    return objects;
 }
 
-std::string SceneParser::processPath(const std::string& originalPath) {
-    std::string expandedPath = expandPathMacros(originalPath);
-    
-    // Check if the expanded path exists directly
-    std::ifstream fileCheck(expandedPath);
-    if (fileCheck.good()) {
-        fileCheck.close();
-        return expandedPath;
-    }
-    fileCheck.close();
-    
-    // If not found, try common alternatives
-    // Try with MODELS_PATH prefix if it's not already there
-    if (expandedPath.find(MODELS_PATH) == std::string::npos) {
-        std::string modelPath = std::string(MODELS_PATH) + "/" + expandedPath;
-        fileCheck.open(modelPath);
-        if (fileCheck.good()) {
-            fileCheck.close();
-            return modelPath;
-        }
-        fileCheck.close();
+Mesh* SceneParser::createMesh(const std::string& meshName, const std::string& meshPath, const MeshInfo& info) {
+    try {
+        Mesh* newMesh = new Mesh(meshPath.c_str(), metalDevice, defaultVertexDescriptor, info);
+        
+        newMesh->defaultVertexAttributes();
+        
+        return newMesh;
+    } catch (const std::exception& e) {
+        std::cerr << "Error creating mesh '" << meshName << "': " << e.what() << std::endl;
+        return nullptr;
     }
+}
 
-    return expandedPath;
+std::string SceneParser::expandPathMacros(const std::string& path) {
+    return SceneReader::expandPathMacros(path);
+}
+
+std::string SceneParser::processPath(const std::string& originalPath) {
+    return SceneReader::processPath(originalPath);
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -10,17 +11,38 @@ namespace MTL {
 }
 
 class Mesh;
+class BinaryScene;
+struct MeshInfo;
+struct SceneDescription;
 
 class SceneParser {
 public:
     SceneParser(MTL::Device* device, MTL::VertexDescriptor* vertexDescriptor);
     ~SceneParser();
 
-    std::vector<Mesh*> loadScene(const std::string& jsonFilePath);
+    // One entry per instance, nullptr where the mesh could not be created
+    std::vector<Mesh*> createObjects(const SceneDescription& scene);
+    // Reads the instances straight out of the mapping. Also one entry per instance,
+    // including the ones whose mesh index is out of range.
+    std::vector<Mesh*> createObjects(const BinaryScene& scene);
+    Mesh* createMesh(const std::string& meshName, const std::string& meshPath, const MeshInfo& info);
     std::string expandPathMacros(const std::string& path);
     std::string processPath(const std::string& originalPath);
 
+    // Parallel loading parses every unique mesh file once, concurrently, and instances it
+    // for the objects that repeat it. Serial loading creates the objects one after another.
+    void setParallelLoading(bool enabled) { parallelLoading = enabled; }
+
 private:
+    // Fills in the info of one object and returns the index of its mesh
+    using InstanceReader = std::function<uint32_t(size_t index, MeshInfo& info)>;
+
+    // Shared by JSON descriptions and binary mappings, one entry per instance
+    std::vector<Mesh*> instantiate(size_t instanceCount, const InstanceReader& readInstance,
+                                   const std::vector<std::string>& meshNames,
+                                   const std::vector<std::string>& meshPaths);
+
     MTL::Device* metalDevice;
     MTL::VertexDescriptor* defaultVertexDescriptor;
+    bool parallelLoading = true;
 };
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "sceneWatcher.hpp"
+
+SceneWatcher::SceneWatcher(const std::string& path, std::chrono::milliseconds interval)
+: filePath(path)
+, interval(interval)
+, nextCheck(Clock::now() + interval) {
+    readTime(loadedTime);
+}
+
+bool SceneWatcher::readTime(std::filesystem::file_time_type& time) const {
+    std::error_code error;
+    std::filesystem::file_time_type current = std::filesystem::last_write_time(filePath, error);
+    if (error) return false;
+    time = current;
+    return true;
+}
+
+bool SceneWatcher::poll() {
+    Clock::time_point now = Clock::now();
+    if (now < nextCheck) return false;
+    nextCheck = now + interval;
+
+    // A file that is missing for a moment, e.g. while an editor replaces it, is not a change
+    std::filesystem::file_time_type current;
+    if (!readTime(current)) return false;
+
+    if (current == loadedTime) {
+        pending = false;
+        return false;
+    }
+
+    if (!pending || current != pendingTime) {
+        pending = true;
+        pendingTime = current;
+        return false;
+    }
+
+    pending = false;
+    loadedTime = current;
+    return true;
+}
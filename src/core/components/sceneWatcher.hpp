@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+constexpr std::chrono::milliseconds SCENE_WATCH_INTERVAL{250};
+
+// Polls the modification time of a scene file. A change is only reported once the time
+// has stayed the same for a whole interval, so an editor that writes the file in several
+// steps triggers a single reload of the finished file.
+class SceneWatcher {
+public:
+    explicit SceneWatcher(const std::string& path, std::chrono::milliseconds interval = SCENE_WATCH_INTERVAL);
+
+    // Cheap enough to call every frame, the file system is touched at most once per interval
+    bool poll();
+
+    const std::string& path() const { return filePath; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool readTime(std::filesystem::file_time_type& time) const;
+
+    std::string                     filePath;
+    std::chrono::milliseconds       interval;
+    Clock::time_point               nextCheck;
+
+    std::filesystem::file_time_type loadedTime;     // Version the scene was built from
+    std::filesystem::file_time_type pendingTime;    // Newer version waiting to settle
+    bool                            pending = false;
+};
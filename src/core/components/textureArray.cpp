@@ -6,6 +6,78 @@
 #include <iostream>
 
 #include "textureArray.hpp"
+#include "textureAtlas.hpp"
+#include "mipGenerator.hpp"
+#include "textureCache.hpp"
+#include "../taskScheduler.hpp"
+#include "../fileReader.hpp"
+
+namespace {
+
+MTL::Texture* newAtlasTexture(MTL::Device* device, const AtlasLayout& layout, int firstLevel, int mipLevels) {
+    int baseSize = std::max(1, layout.pageSize >> firstLevel);
+    
+    MTL::TextureDescriptor* textureDescriptor = MTL::TextureDescriptor::alloc()->init();
+    textureDescriptor->texture2DDescriptor(MTL::PixelFormatRGBA8Unorm,
+                                           baseSize,
+                                           baseSize,
+                                           false);
+    textureDescriptor->setArrayLength(layout.pageCount);
+    textureDescriptor->setUsage(MTL::TextureUsageShaderRead);
+    textureDescriptor->setTextureType(MTL::TextureType2DArray);
+    textureDescriptor->setWidth(baseSize);
+    textureDescriptor->setHeight(baseSize);
+    textureDescriptor->setMipmapLevelCount(mipLevels - firstLevel);
+    textureDescriptor->setPixelFormat(MTL::PixelFormatRGBA8Unorm);
+
+    MTL::Texture* textureArray = device->newTexture(textureDescriptor);
+    assert(textureArray != nullptr);
+    textureDescriptor->release();
+    
+    return textureArray;
+}
+
+// Slots are aligned so that page level N of an image sits at the slot origin >> N with a
+// gutter of GUTTER >> N. The texture's own level 0 is page level `firstLevel`. Images
+// smaller than the page's mip count run out of levels at 1x1; that level is repeated into
+// the page levels above it, which would otherwise sample whatever the texture held there.
+size_t uploadSlot(MTL::Texture* texture, const AtlasSlot& slot,
+                  const std::vector<MipChain::Level>& levels, const unsigned char* levelData,
+                  int firstLevel, int mipLevels, std::vector<unsigned char>& staging) {
+    assert(!levels.empty());
+    size_t uploaded = 0;
+    for (int level = firstLevel; level < mipLevels; level++) {
+        const MipChain::Level& mip = levels[std::min(level, static_cast<int>(levels.size()) - 1)];
+        int gutter = ATLAS_GUTTER >> level;
+        int regionWidth = mip.width + 2 * gutter;
+        int regionHeight = mip.height + 2 * gutter;
+        
+        staging.resize(size_t(regionWidth) * regionHeight * 4);
+        TextureAtlasPacker::copyWithGutter(levelData + mip.offset, mip.width, mip.height,
+                                           staging.data(), regionWidth, 0, 0, gutter);
+        
+        MTL::Region region = MTL::Region(slot.x >> level, slot.y >> level, 0, regionWidth, regionHeight, 1);
+        NS::UInteger bytesPerRow = 4 * regionWidth;
+        texture->replaceRegion(region, level - firstLevel, slot.page, staging.data(), bytesPerRow, 0);
+        uploaded += staging.size();
+    }
+    return uploaded;
+}
+
+MipChain decodeImage(const std::vector<unsigned char>& bytes, int width, int height, const MipSettings& settings) {
+    // stb keeps a per-thread flip flag next to the global one
+    stbi_set_flip_vertically_on_load_thread(true);
+    int w, h, c;
+    unsigned char* image = stbi_load_from_memory(bytes.data(), static_cast<int>(bytes.size()),
+                                                 &w, &h, &c, STBI_rgb_alpha);
+    assert(image != NULL && w == width && h == height);
+    
+    MipChain mipChain = MipGenerator::generate(image, w, h, settings);
+    stbi_image_free(image);
+    return mipChain;
+}
+
+}
 
 TextureArray::TextureArray(std::vector<std::string>& FilePaths,
                            MTL::Device* metalDevice, TextureType type) {
@@ -16,69 +88,210 @@ TextureArray::TextureArray(std::vector<std::string>& FilePaths,
 }
 
 void TextureArray::loadTextures(std::vector<std::string> &filePaths, TextureType type) {
+    using Clock = std::chrono::steady_clock;
+    auto loadStart = Clock::now();
+    
+    auto source = std::make_shared<AtlasSource>();
+    source->filePaths = filePaths;
+    source->cacheKeys.resize(filePaths.size());
+    
     int maxImageWidth = 0, maxImageHeight = 0;
-    std::vector<unsigned char*> images;
-    unsigned char* image;
     int width, height, channels;
-    std::vector<int> widths;
-    std::vector<int> heights;
-    // Load Images and determine max width and height
-    for (std::string filePath : filePaths) {
-        stbi_set_flip_vertically_on_load(true);
-        image = stbi_load(filePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-        assert(image != NULL);
+    std::vector<TextureAtlasPacker::Size> sizes;
+    // Only the headers are read here so the atlas can be laid out before anything is decoded
+    for (const std::string& filePath : filePaths) {
+        int ok = stbi_info(filePath.c_str(), &width, &height, &channels);
+        assert(ok);
     
         maxImageWidth = std::max(maxImageWidth, width);
         maxImageHeight = std::max(maxImageHeight, height);
         
-        widths.push_back(width);
-        heights.push_back(height);
-        
-        images.push_back(image);
+        sizes.push_back({width, height});
     }
+    source->maxImageExtent = std::max(maxImageWidth, maxImageHeight);
     
-    // Create Texture Array
-    MTL::TextureDescriptor* textureDescriptor = MTL::TextureDescriptor::alloc()->init();
-    textureDescriptor->texture2DDescriptor(MTL::PixelFormatRGBA8Unorm,
-                                           maxImageWidth,
-                                           maxImageHeight,
-                                           false);
-    textureDescriptor->setArrayLength(images.size());
-    textureDescriptor->setUsage(MTL::TextureUsageShaderRead);
-    textureDescriptor->setTextureType(MTL::TextureType2DArray);
-    textureDescriptor->setWidth(maxImageWidth);
-    textureDescriptor->setHeight(maxImageHeight);
-    textureDescriptor->setMipmapLevelCount(1);
-    textureDescriptor->setPixelFormat(MTL::PixelFormatRGBA8Unorm);
-
-    MTL::Texture* textureArray = device->newTexture(textureDescriptor);
-    assert(textureArray != nullptr);
-    textureDescriptor->release();
-//    std::string textureType = type == DIFFUSE ? "Diffuse " : "Normal ";
-//    std::cout << textureType << "Texture Array Width: " << textureArray->width() << std::endl;
-//    std::cout << textureType << "Texture Array Height: " << textureArray->height() << std::endl;
+    // Pack every image into as few pages as possible instead of giving each one a max sized layer
+    source->layout = TextureAtlasPacker::packBest(sizes);
+    const AtlasLayout& layout = source->layout;
+    assert(layout.pageCount > 0);
+    
+    // Mips stop at the level where the gutter shrinks to a single texel
+    int mipLevels = std::min(ATLAS_MAX_MIP_LEVELS, MipGenerator::fullLevelCount(layout.pageSize, layout.pageSize));
+    source->mipLevels = mipLevels;
+    source->settings.srgb = (type == DIFFUSE);
+    source->settings.normalMap = (type == NORMAL);
+    source->settings.maxLevels = mipLevels;
+    
+    // Only the smallest levels are uploaded now, the streamer brings in the rest on demand
+    int firstLevel = std::max(0, mipLevels - TEXTURE_RESIDENT_MIP_LEVELS);
+    MTL::Texture* textureArray = newAtlasTexture(device, layout, firstLevel, mipLevels);
 
-    for (int i = 0; i < images.size(); i++) {
-        if (type == DIFFUSE)
-            diffuseTextureInfos.push_back({widths[i], heights[i]});
-		if (type == NORMAL)
-			normalTextureInfos.push_back({widths[i], heights[i]});
-		
-        MTL::Region region = MTL::Region(0, 0, 0, widths[i], heights[i], 1);
-        NS::UInteger bytesPerRow = 4 * widths[i];
+    std::vector<TextureInfo>& textureInfos = (type == DIFFUSE) ? diffuseTextureInfos : normalTextureInfos;
+    float pageSize = static_cast<float>(layout.pageSize);
+    
+    for (int i = 0; i < sizes.size(); i++) {
+        const AtlasSlot& slot = layout.slots[i];
+        TextureInfo info{};
+        info.uvScale = simd::float2{slot.width / pageSize, slot.height / pageSize};
+        info.uvOffset = simd::float2{(slot.x + ATLAS_GUTTER) / pageSize, (slot.y + ATLAS_GUTTER) / pageSize};
+        info.layer = slot.page;
+        info.width = slot.width;
+        info.height = slot.height;
+        info.count = static_cast<int>(sizes.size());
+        textureInfos.push_back(info);
+    }
+    
+    // Decode and build mips on the pool, or map the result of a previous run from the
+    // texture cache. Every chain is generated in full even though only its tail is uploaded
+    // here, so that the streamer later finds all levels in the cache.
+    // Workers only touch their own slot of these vectors and hand the index over through
+    // the queue once it is ready to upload.
+    struct DecodedTexture {
+        MipChain                        mipChain;
+        std::unique_ptr<CachedTexture>  cached;
+        double                          decodeMs = 0.0;
+    };
+    std::vector<DecodedTexture> decoded(filePaths.size());
+    std::deque<size_t> readyQueue;
+    std::mutex readyMutex;
+    std::atomic<size_t> cacheHits{0};
+    
+    TextureCache& cache = TextureCache::shared();
+    TaskScheduler& scheduler = TaskScheduler::shared();
+    
+    // All images are read as one batch, each one is decoded as soon as its read completes.
+    // The source bytes are read once, both for the cache key and for decoding on a miss.
+    FileReadHandle reads = FileReader::shared().readAsync(filePaths, [&](size_t i, std::vector<unsigned char>& bytes, bool ok) {
+        assert(ok);
+        auto decodeStart = Clock::now();
+        
+        uint64_t cacheKey = TextureCache::makeKey(bytes.data(), bytes.size(), source->settings);
+        source->cacheKeys[i] = cacheKey;
+        
+        decoded[i].cached = cache.load(cacheKey);
+        if (decoded[i].cached &&
+            (decoded[i].cached->width() != sizes[i].width || decoded[i].cached->height() != sizes[i].height)) {
+            decoded[i].cached.reset();
+        }
+        
+        if (decoded[i].cached) {
+            cacheHits++;
+        } else {
+            decoded[i].mipChain = decodeImage(bytes, sizes[i].width, sizes[i].height, source->settings);
+            cache.store(cacheKey, decoded[i].mipChain);
+        }
+        decoded[i].decodeMs = std::chrono::duration<double, std::milli>(Clock::now() - decodeStart).count();
         
-        textureArray->replaceRegion(region, 0, i, images[i], bytesPerRow, 0);
-        stbi_image_free(images[i]);
+        std::lock_guard<std::mutex> lock(readyMutex);
+        readyQueue.push_back(i);
+    });
+    
+    // Upload each texture into its slot as soon as it is decoded. Waiting runs the decode jobs
+    // of this batch itself, and only those, so this also works when the loader is a scheduler
+    // task that other loaders wait for through the registry.
+    std::vector<unsigned char> staging;
+    for (size_t uploaded = 0; uploaded < filePaths.size(); uploaded++) {
+        size_t i;
+        scheduler.waitUntil([&]() {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            return !readyQueue.empty();
+        }, reads.get());
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            i = readyQueue.front();
+            readyQueue.pop_front();
+        }
+        
+        DecodedTexture& texture = decoded[i];
+        const std::vector<MipChain::Level>& levels = texture.cached ? texture.cached->mipLevels() : texture.mipChain.levels;
+        const unsigned char* levelData = texture.cached ? texture.cached->data() : texture.mipChain.data.data();
+        uploadSlot(textureArray, layout.slots[i], levels, levelData, firstLevel, mipLevels, staging);
+        
+        texture.mipChain = MipChain();
+        texture.cached.reset();
+    }
+    
+    // The last callbacks may still be returning
+    FileReader::shared().wait(reads);
+    
+    if (cacheHits < filePaths.size()) {
+        cache.trim();
     }
     
+    double totalMs = std::chrono::duration<double, std::milli>(Clock::now() - loadStart).count();
+    std::string textureType = type == DIFFUSE ? "Diffuse" : "Normal";
+    std::cout << textureType << " textures: " << filePaths.size() << " loaded in " << totalMs << " ms ("
+              << cacheHits.load() << " from cache)" << std::endl;
+    for (size_t i = 0; i < filePaths.size(); i++) {
+        std::string fileName = filePaths[i].substr(filePaths[i].find_last_of("/\\") + 1);
+        std::cout << "    " << fileName << " (" << sizes[i].width << "x" << sizes[i].height << "): "
+                  << decoded[i].decodeMs << " ms" << std::endl;
+    }
+    
+    size_t paddedBytes = size_t(maxImageWidth) * maxImageHeight * 4 * sizes.size();
+    size_t atlasBytes = layout.totalBytes();
+    std::cout << textureType << " atlas: " << sizes.size() << " textures in "
+              << layout.pageCount << " page(s) of " << layout.pageSize << "x" << layout.pageSize
+              << ", " << paddedBytes / (1024.0 * 1024.0) << " MB -> " << atlasBytes / (1024.0 * 1024.0)
+              << " MB (saved " << (double(paddedBytes) - double(atlasBytes)) / (1024.0 * 1024.0) << " MB), "
+              << source->bytesFromLevel(firstLevel) / (1024.0 * 1024.0) << " MB resident" << std::endl;
+    
+    atlasSource = source;
+    firstResidentLevel = firstLevel;
+    
     if (type == DIFFUSE)
         diffuseTextureArray = textureArray;
 	if (type == NORMAL)
 		normalTextureArray = textureArray;
 }
 
+MTL::Texture* TextureArray::buildTexture(const AtlasSource& source, MTL::Device* metalDevice, int firstLevel) {
+    MTL::Texture* textureArray = newAtlasTexture(metalDevice, source.layout, firstLevel, source.mipLevels);
+    TextureCache& cache = TextureCache::shared();
+    
+    std::vector<unsigned char> staging;
+    for (size_t i = 0; i < source.filePaths.size(); i++) {
+        const AtlasSlot& slot = source.layout.slots[i];
+        
+        std::unique_ptr<CachedTexture> cached = cache.load(source.cacheKeys[i]);
+        if (cached && cached->width() == slot.width && cached->height() == slot.height) {
+            uploadSlot(textureArray, slot, cached->mipLevels(), cached->data(), firstLevel, source.mipLevels, staging);
+            continue;
+        }
+        
+        std::vector<unsigned char> bytes;
+        bool ok = FileReader::shared().read(source.filePaths[i], bytes);
+        assert(ok);
+        MipChain mipChain = decodeImage(bytes, slot.width, slot.height, source.settings);
+        uploadSlot(textureArray, slot, mipChain.levels, mipChain.data.data(), firstLevel, source.mipLevels, staging);
+        cache.store(source.cacheKeys[i], mipChain);
+    }
+    
+    return textureArray;
+}
+
+TextureHandle TextureArray::acquire(std::vector<std::string>& filePaths,
+                                    MTL::Device* metalDevice, TextureType type) {
+    if (filePaths.empty()) return nullptr;
+    
+    std::string kind = type == DIFFUSE ? "diffuse" : "normal";
+    return TextureRegistry::shared().acquire(TextureRegistry::fileKey(kind, filePaths), [&]() {
+        TextureArray textureArray(filePaths, metalDevice, type);
+        
+        RegisteredTexture registered;
+        registered.texture = (type == DIFFUSE) ? textureArray.diffuseTextureArray : textureArray.normalTextureArray;
+        registered.infos = (type == DIFFUSE) ? textureArray.diffuseTextureInfos : textureArray.normalTextureInfos;
+        registered.atlas = textureArray.atlasSource;
+        registered.firstLevel = textureArray.firstResidentLevel;
+        // The registry keeps its own reference, the array drops its one on destruction
+        if (registered.texture) {
+            registered.texture->retain();
+        }
+        return registered;
+    });
+}
+
 TextureArray::~TextureArray() {
-    std::cout << "TextureArray->release()" << std::endl;
-    diffuseTextureArray->release();
-	normalTextureArray->release();
+    if (diffuseTextureArray) diffuseTextureArray->release();
+	if (normalTextureArray) normalTextureArray->release();
 }
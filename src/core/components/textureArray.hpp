@@ -9,6 +9,12 @@
 #include <vector>
 
 #include "vertexData.hpp"
+#include "textureRegistry.hpp"
+#include "textureAtlas.hpp"
+
+// Mip levels of every atlas that are loaded up front. Everything above them is brought
+// in by the TextureStreamer once a mesh using the atlas needs the detail.
+constexpr int TEXTURE_RESIDENT_MIP_LEVELS = 2;
 
 enum TextureType {
     DIFFUSE,
@@ -25,10 +31,21 @@ public:
     void loadTextures(std::vector<std::string>& filePaths,
                       TextureType type);
     
-    MTL::Texture* diffuseTextureArray;
+    // Builds the atlas through the texture registry, so identical file lists share one array
+    static TextureHandle acquire(std::vector<std::string>& filePaths,
+                                 MTL::Device* metalDevice, TextureType type);
+    
+    // Rebuilds an atlas whose level 0 is page level `firstLevel`. Images come from the
+    // texture cache and are only decoded again if their entry has been evicted.
+    static MTL::Texture* buildTexture(const AtlasSource& source, MTL::Device* metalDevice, int firstLevel);
+    
+    std::shared_ptr<const AtlasSource> atlasSource;
+    int firstResidentLevel = 0;
+    
+    MTL::Texture* diffuseTextureArray = nullptr;
     std::vector<TextureInfo> diffuseTextureInfos;
 	
-	MTL::Texture* normalTextureArray;
+	MTL::Texture* normalTextureArray = nullptr;
 	std::vector<TextureInfo> normalTextureInfos;
 
 private:
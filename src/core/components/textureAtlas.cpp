@@ -0,0 +1,180 @@
+#include "textureAtlas.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+size_t AtlasSource::bytesFromLevel(int firstLevel, size_t bytesPerTexel) const {
+    size_t bytes = 0;
+    for (int level = firstLevel; level < mipLevels; level++) {
+        size_t levelSize = std::max(1, layout.pageSize >> level);
+        bytes += levelSize * levelSize * bytesPerTexel * layout.pageCount;
+    }
+    return bytes;
+}
+
+int TextureAtlasPacker::paddedExtent(int extent) {
+    int padded = extent + 2 * ATLAS_GUTTER;
+    return (padded + ATLAS_ALIGNMENT - 1) / ATLAS_ALIGNMENT * ATLAS_ALIGNMENT;
+}
+
+void TextureAtlasPacker::copyWithGutter(const unsigned char* image, int width, int height,
+                                        unsigned char* page, int pageSize, int x, int y, int gutter) {
+    for (int row = -gutter; row < height + gutter; row++) {
+        int srcRow = ((row % height) + height) % height;
+        unsigned char* dst = page + (size_t(y + gutter + row) * pageSize + (x + gutter)) * 4;
+
+        // Left gutter, image row, right gutter
+        for (int col = -gutter; col < 0; col++) {
+            int srcCol = ((col % width) + width) % width;
+            std::memcpy(dst + col * 4, image + (size_t(srcRow) * width + srcCol) * 4, 4);
+        }
+        std::memcpy(dst, image + size_t(srcRow) * width * 4, size_t(width) * 4);
+        for (int col = width; col < width + gutter; col++) {
+            int srcCol = col % width;
+            std::memcpy(dst + col * 4, image + (size_t(srcRow) * width + srcCol) * 4, 4);
+        }
+    }
+}
+
+AtlasLayout TextureAtlasPacker::packBest(const std::vector<Size>& sizes) {
+    int minPageSize = ATLAS_ALIGNMENT;
+    for (const Size& size : sizes) {
+        minPageSize = std::max(minPageSize, paddedExtent(size.width));
+        minPageSize = std::max(minPageSize, paddedExtent(size.height));
+    }
+
+    AtlasLayout best = pack(sizes, minPageSize);
+
+    // Bigger pages waste less space at the end of each page but can leave one page mostly empty
+    for (int pageSize = minPageSize * 2; pageSize <= ATLAS_MAX_PAGE_SIZE; pageSize *= 2) {
+        AtlasLayout candidate = pack(sizes, pageSize);
+        if (candidate.pageCount > 0 && candidate.totalBytes() < best.totalBytes()) {
+            best = std::move(candidate);
+        }
+    }
+
+    return best;
+}
+
+AtlasLayout TextureAtlasPacker::pack(const std::vector<Size>& sizes, int pageSize) {
+    AtlasLayout layout;
+    layout.pageSize = pageSize;
+    layout.slots.resize(sizes.size());
+
+    // Tallest first keeps the skyline flat
+    std::vector<size_t> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) {
+        if (sizes[a].height != sizes[b].height) {
+            return sizes[a].height > sizes[b].height;
+        }
+        return sizes[a].width > sizes[b].width;
+    });
+
+    std::vector<std::vector<SkylineNode>> pages;
+
+    for (size_t index : order) {
+        int width = paddedExtent(sizes[index].width);
+        int height = paddedExtent(sizes[index].height);
+
+        if (width > pageSize || height > pageSize) {
+            layout.pageCount = 0;
+            return layout;
+        }
+
+        bool placed = false;
+        for (size_t page = 0; page < pages.size() && !placed; page++) {
+            int x, y;
+            size_t node;
+            if (findPosition(pages[page], pageSize, width, height, x, y, node)) {
+                addSkylineLevel(pages[page], node, x, y, width, height);
+                layout.slots[index] = {static_cast<int>(page), x, y, sizes[index].width, sizes[index].height};
+                placed = true;
+            }
+        }
+
+        if (!placed) {
+            pages.push_back({{0, 0, pageSize}});
+            int x, y;
+            size_t node;
+            findPosition(pages.back(), pageSize, width, height, x, y, node);
+            addSkylineLevel(pages.back(), node, x, y, width, height);
+            layout.slots[index] = {static_cast<int>(pages.size() - 1), x, y, sizes[index].width, sizes[index].height};
+        }
+    }
+
+    layout.pageCount = static_cast<int>(pages.size());
+    return layout;
+}
+
+bool TextureAtlasPacker::findPosition(const std::vector<SkylineNode>& skyline, int pageSize, int width, int height,
+                                      int& bestX, int& bestY, size_t& bestNode) {
+    int bestTop = std::numeric_limits<int>::max();
+    int bestWidth = std::numeric_limits<int>::max();
+    bool found = false;
+
+    for (size_t i = 0; i < skyline.size(); i++) {
+        int x = skyline[i].x;
+        if (x + width > pageSize) {
+            break;
+        }
+
+        // The rect rests on the highest node it spans
+        int y = 0;
+        int remaining = width;
+        for (size_t j = i; j < skyline.size() && remaining > 0; j++) {
+            y = std::max(y, skyline[j].y);
+            remaining -= skyline[j].width;
+        }
+
+        if (y + height > pageSize) {
+            continue;
+        }
+
+        int top = y + height;
+        if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth)) {
+            bestTop = top;
+            bestWidth = skyline[i].width;
+            bestX = x;
+            bestY = y;
+            bestNode = i;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+void TextureAtlasPacker::addSkylineLevel(std::vector<SkylineNode>& skyline, size_t nodeIndex, int x, int y, int width, int height) {
+    skyline.insert(skyline.begin() + nodeIndex, {x, y + height, width});
+
+    // Trim or drop the nodes now covered by the new level
+    for (size_t i = nodeIndex + 1; i < skyline.size(); ) {
+        int previousEnd = skyline[i - 1].x + skyline[i - 1].width;
+        if (skyline[i].x >= previousEnd) {
+            break;
+        }
+
+        int shrink = previousEnd - skyline[i].x;
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+
+        if (skyline[i].width <= 0) {
+            skyline.erase(skyline.begin() + i);
+        } else {
+            break;
+        }
+    }
+
+    // Merge neighbours at the same height
+    for (size_t i = 0; i + 1 < skyline.size(); ) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            i++;
+        }
+    }
+}
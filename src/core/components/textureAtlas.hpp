@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include "mipGenerator.hpp"
+
+// Every packed texture is surrounded by a gutter of wrapped texels so that bilinear
+// filtering with repeat addressing never bleeds into a neighbour. Slots are aligned
+// to ATLAS_ALIGNMENT so that each mip level of a slot still lands on whole texels.
+constexpr int ATLAS_GUTTER      = 16;
+constexpr int ATLAS_ALIGNMENT   = 32;
+// Last level at which the gutter is still at least one texel wide
+constexpr int ATLAS_MAX_MIP_LEVELS = 5;
+constexpr int ATLAS_MAX_PAGE_SIZE  = 8192;
+
+struct AtlasSlot {
+    int page = 0;
+    int x = 0;          // Top-left of the slot, including the gutter
+    int y = 0;
+    int width = 0;      // Image size without the gutter
+    int height = 0;
+};
+
+struct AtlasLayout {
+    int pageSize = 0;
+    int pageCount = 0;
+    std::vector<AtlasSlot> slots; // Same order as the input sizes
+
+    size_t bytesPerPage(size_t bytesPerTexel = 4) const { return size_t(pageSize) * pageSize * bytesPerTexel; }
+    size_t totalBytes(size_t bytesPerTexel = 4) const { return bytesPerPage(bytesPerTexel) * pageCount; }
+};
+
+// Everything needed to rebuild an atlas starting at any mip level after the initial load
+struct AtlasSource {
+    std::vector<std::string>    filePaths;
+    std::vector<uint64_t>       cacheKeys;      // Texture cache entry of every image
+    AtlasLayout                 layout;
+    MipSettings                 settings;
+    int                         mipLevels = 0;
+    int                         maxImageExtent = 0;
+
+    // Size of an array holding page levels [firstLevel, mipLevels)
+    size_t bytesFromLevel(int firstLevel, size_t bytesPerTexel = 4) const;
+};
+
+// Skyline bottom-left packer. Textures are sorted by height so the skyline stays flat,
+// and a new page is opened whenever a texture does not fit into any existing one.
+class TextureAtlasPacker {
+public:
+    struct Size {
+        int width;
+        int height;
+    };
+
+    // Tries a few page sizes and keeps the layout with the smallest footprint
+    static AtlasLayout packBest(const std::vector<Size>& sizes);
+    static AtlasLayout pack(const std::vector<Size>& sizes, int pageSize);
+
+    static int paddedExtent(int extent);
+
+    // Copies an RGBA8 image into a page and fills `gutter` texels around it with wrapped
+    // texels, matching what repeat addressing would have sampled
+    static void copyWithGutter(const unsigned char* image, int width, int height,
+                               unsigned char* page, int pageSize, int x, int y, int gutter);
+
+private:
+    struct SkylineNode {
+        int x;
+        int y;
+        int width;
+    };
+
+    static bool findPosition(const std::vector<SkylineNode>& skyline, int pageSize, int width, int height, int& bestX, int& bestY, size_t& bestNode);
+    static void addSkylineLevel(std::vector<SkylineNode>& skyline, size_t nodeIndex, int x, int y, int width, int height);
+};
@@ -0,0 +1,313 @@
+#include "textureCache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint32_t CACHE_MAGIC          = 0x4358544D; // "MTXC"
+constexpr uint32_t CACHE_VERSION        = 1;
+constexpr size_t   CACHE_PAYLOAD_ALIGN  = 64;
+constexpr const char* CACHE_EXTENSION   = ".mipc";
+
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint32_t format;
+    uint64_t payloadOffset;
+    uint64_t payloadBytes;
+};
+
+struct CacheLevel {
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;
+};
+
+size_t payloadOffsetFor(uint32_t levelCount) {
+    size_t tableEnd = sizeof(CacheHeader) + sizeof(CacheLevel) * levelCount;
+    return (tableEnd + CACHE_PAYLOAD_ALIGN - 1) & ~(CACHE_PAYLOAD_ALIGN - 1);
+}
+
+// 64 bit hash in the style of xxHash: four independent lanes so the multiplies can
+// overlap, which keeps hashing well ahead of disk bandwidth
+constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t PRIME3 = 0x165667B19E3779F9ull;
+constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t rotl(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t read32(const unsigned char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint64_t mixRound(uint64_t acc, uint64_t input) {
+    acc += input * PRIME2;
+    acc = rotl(acc, 31);
+    return acc * PRIME1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t value) {
+    acc ^= mixRound(0, value);
+    return acc * PRIME1 + PRIME4;
+}
+
+uint64_t hash64(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + size;
+    uint64_t h;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+        const unsigned char* limit = end - 32;
+        do {
+            v1 = mixRound(v1, read64(p));
+            v2 = mixRound(v2, read64(p + 8));
+            v3 = mixRound(v3, read64(p + 16));
+            v4 = mixRound(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + PRIME5;
+    }
+
+    h += static_cast<uint64_t>(size);
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= mixRound(0, read64(p));
+        h = rotl(h, 27) * PRIME1 + PRIME4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * PRIME1;
+        h = rotl(h, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        h ^= (*p) * PRIME5;
+        h = rotl(h, 11) * PRIME1;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+}
+
+CachedTexture::~CachedTexture() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+    }
+}
+
+TextureCache::TextureCache(const std::string& directory, size_t capacity)
+: directory(directory), capacity(capacity) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    isEnabled = !error && std::filesystem::is_directory(directory, error);
+    if (!isEnabled) {
+        std::cerr << "Texture cache disabled, cannot create " << directory << std::endl;
+    }
+}
+
+TextureCache& TextureCache::shared() {
+    static TextureCache cache(TEXTURE_CACHE_PATH);
+    return cache;
+}
+
+uint64_t TextureCache::makeKey(const void* sourceBytes, size_t sourceSize, const MipSettings& settings) {
+    // Everything that changes the decoded result goes into the seed
+    uint64_t seed = CACHE_VERSION;
+    seed = seed * 31 + (settings.srgb ? 1 : 0);
+    seed = seed * 31 + (settings.normalMap ? 1 : 0);
+    seed = seed * 31 + static_cast<uint64_t>(settings.maxLevels);
+    seed = seed * 31 + static_cast<uint64_t>(settings.filter);
+    seed = seed * 31 + static_cast<uint64_t>(CachedTextureFormat::RGBA8);
+    return hash64(sourceBytes, sourceSize, seed);
+}
+
+std::string TextureCache::pathFor(uint64_t key) const {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return directory + "/" + name + CACHE_EXTENSION;
+}
+
+std::unique_ptr<CachedTexture> TextureCache::load(uint64_t key) {
+    if (!isEnabled) return nullptr;
+
+    std::string path = pathFor(key);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(CacheHeader)) {
+        close(fd);
+        return nullptr;
+    }
+
+    size_t fileSize = size_t(info.st_size);
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    // Bump the modification time so eviction sees this entry as recently used
+    futimens(fd, nullptr);
+    close(fd);
+    if (mapping == MAP_FAILED) return nullptr;
+
+    std::unique_ptr<CachedTexture> texture(new CachedTexture());
+    texture->mapping = mapping;
+    texture->mappingSize = fileSize;
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(mapping);
+    CacheHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.key != key ||
+        header.format != uint32_t(CachedTextureFormat::RGBA8) ||
+        header.levelCount == 0 || header.payloadOffset != payloadOffsetFor(header.levelCount) ||
+        header.payloadOffset + header.payloadBytes != fileSize) {
+        std::cerr << "Discarding damaged texture cache entry " << path << std::endl;
+        texture.reset();
+        std::remove(path.c_str());
+        return nullptr;
+    }
+
+    texture->pixelFormat = static_cast<CachedTextureFormat>(header.format);
+    texture->payload = bytes + header.payloadOffset;
+    texture->levels.resize(header.levelCount);
+    for (uint32_t i = 0; i < header.levelCount; i++) {
+        CacheLevel level;
+        std::memcpy(&level, bytes + sizeof(CacheHeader) + sizeof(CacheLevel) * i, sizeof(level));
+        if (level.offset + size_t(level.width) * level.height * 4 > header.payloadBytes) {
+            texture.reset();
+            std::remove(path.c_str());
+            return nullptr;
+        }
+        texture->levels[i] = {int(level.width), int(level.height), size_t(level.offset)};
+    }
+
+    // The texture is uploaded front to back right after this
+    madvise(mapping, fileSize, MADV_SEQUENTIAL);
+    madvise(mapping, fileSize, MADV_WILLNEED);
+
+    return texture;
+}
+
+bool TextureCache::store(uint64_t key, const MipChain& mipChain) {
+    if (!isEnabled || mipChain.levelCount() == 0) return false;
+
+    CacheHeader header{};
+    header.magic = CACHE_MAGIC;
+    header.version = CACHE_VERSION;
+    header.key = key;
+    header.width = mipChain.width();
+    header.height = mipChain.height();
+    header.levelCount = mipChain.levelCount();
+    header.format = static_cast<uint32_t>(CachedTextureFormat::RGBA8);
+    header.payloadOffset = payloadOffsetFor(header.levelCount);
+    header.payloadBytes = mipChain.data.size();
+
+    std::vector<unsigned char> prefix(header.payloadOffset, 0);
+    std::memcpy(prefix.data(), &header, sizeof(header));
+    for (uint32_t i = 0; i < header.levelCount; i++) {
+        const MipChain::Level& mip = mipChain.levels[i];
+        CacheLevel level{uint32_t(mip.width), uint32_t(mip.height), uint64_t(mip.offset)};
+        std::memcpy(prefix.data() + sizeof(CacheHeader) + sizeof(CacheLevel) * i, &level, sizeof(level));
+    }
+
+    // Write next to the final path and rename so a reader never sees a partial entry
+    std::string path = pathFor(key);
+    std::string tempPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(prefix.data()), prefix.size());
+        file.write(reinterpret_cast<const char*>(mipChain.data.data()), mipChain.data.size());
+        if (!file) {
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void TextureCache::trim() {
+    if (!isEnabled) return;
+    std::lock_guard<std::mutex> lock(trimMutex);
+
+    struct Entry {
+        std::filesystem::path           path;
+        std::filesystem::file_time_type lastUsed;
+        uintmax_t                       size;
+    };
+    std::vector<Entry> entries;
+    uintmax_t totalSize = 0;
+
+    std::error_code error;
+    for (const auto& file : std::filesystem::directory_iterator(directory, error)) {
+        if (!file.is_regular_file(error) || file.path().extension() != CACHE_EXTENSION) continue;
+        Entry entry{file.path(), file.last_write_time(error), file.file_size(error)};
+        if (error) continue;
+        totalSize += entry.size;
+        entries.push_back(entry);
+    }
+
+    if (totalSize <= capacity) return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.lastUsed < b.lastUsed;
+    });
+
+    size_t evicted = 0;
+    for (const Entry& entry : entries) {
+        if (totalSize <= capacity) break;
+        if (std::filesystem::remove(entry.path, error)) {
+            totalSize -= entry.size;
+            evicted++;
+        }
+    }
+    std::cout << "Texture cache: evicted " << evicted << " entries, "
+              << totalSize / (1024.0 * 1024.0) << " MB in use" << std::endl;
+}
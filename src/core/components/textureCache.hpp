@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "mipGenerator.hpp"
+
+constexpr size_t TEXTURE_CACHE_DEFAULT_CAPACITY = size_t(2) << 30; // 2 GB
+
+// Pixel layout of a cache entry's payload. Only RGBA8 is written today but the field is
+// part of the header so block compressed entries can be added without a version bump.
+enum class CachedTextureFormat : uint32_t {
+    RGBA8 = 0,
+};
+
+// Read-only view of one cache entry. The file stays memory mapped for as long as this
+// object is alive, so uploads read straight out of the page cache without a copy.
+class CachedTexture {
+public:
+    ~CachedTexture();
+
+    CachedTexture(const CachedTexture&) = delete;
+    CachedTexture& operator=(const CachedTexture&) = delete;
+
+    int width() const { return levels.empty() ? 0 : levels[0].width; }
+    int height() const { return levels.empty() ? 0 : levels[0].height; }
+    int levelCount() const { return static_cast<int>(levels.size()); }
+    CachedTextureFormat format() const { return pixelFormat; }
+
+    const std::vector<MipChain::Level>& mipLevels() const { return levels; }
+    const unsigned char* data() const { return payload; }
+    const unsigned char* level(int index) const { return payload + levels[index].offset; }
+    size_t bytesPerRow(int index) const { return size_t(levels[index].width) * 4; }
+
+private:
+    friend class TextureCache;
+    CachedTexture() = default;
+
+    void*                       mapping = nullptr;
+    size_t                      mappingSize = 0;
+    const unsigned char*        payload = nullptr;
+    std::vector<MipChain::Level> levels;
+    CachedTextureFormat         pixelFormat = CachedTextureFormat::RGBA8;
+};
+
+// Disk cache of decoded, mipmapped textures. Entries are keyed by a hash of the source
+// file contents together with the import settings, so editing a source or changing how it
+// is imported simply misses and writes a new entry. The least recently used entries are
+// evicted once the directory grows past the capacity.
+class TextureCache {
+public:
+    explicit TextureCache(const std::string& directory, size_t capacity = TEXTURE_CACHE_DEFAULT_CAPACITY);
+
+    // Cache rooted at TEXTURE_CACHE_PATH
+    static TextureCache& shared();
+
+    static uint64_t makeKey(const void* sourceBytes, size_t sourceSize, const MipSettings& settings);
+
+    bool enabled() const { return isEnabled; }
+
+    // Returns nullptr on a miss or when the entry on disk is damaged
+    std::unique_ptr<CachedTexture> load(uint64_t key);
+    bool store(uint64_t key, const MipChain& mipChain);
+
+    // Deletes the oldest entries until the directory fits in the capacity
+    void trim();
+
+private:
+    std::string pathFor(uint64_t key) const;
+
+    std::string directory;
+    size_t      capacity;
+    bool        isEnabled = false;
+    std::mutex  trimMutex;
+};
@@ -0,0 +1,137 @@
+#include "textureRegistry.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+
+TextureRegistry& TextureRegistry::shared() {
+    static TextureRegistry registry;
+    return registry;
+}
+
+std::string TextureRegistry::fileKey(const std::string& kind, const std::vector<std::string>& filePaths) {
+    // Canonical paths so "a/../b.png" and "b.png" end up as the same entry
+    std::string key = kind;
+    for (const std::string& filePath : filePaths) {
+        std::error_code error;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(filePath, error);
+        key += '|';
+        key += error ? filePath : canonical.string();
+    }
+    return key;
+}
+
+std::string TextureRegistry::contentKey(const std::string& kind, uint64_t contentHash) {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(contentHash));
+    return kind + "#" + hash;
+}
+
+TextureHandle TextureRegistry::acquire(const std::string& key, const std::function<RegisteredTexture()>& create) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = slots.find(key);
+        if (it != slots.end()) {
+            if (TextureHandle existing = it->second.texture.lock()) {
+                hits++;
+                bytesDeduplicated += existing->bytes;
+                return existing;
+            }
+        }
+    }
+
+    std::promise<TextureHandle> promise;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        Slot& slot = slots[key];
+        if (TextureHandle existing = slot.texture.lock()) {
+            hits++;
+            bytesDeduplicated += existing->bytes;
+            return existing;
+        }
+        if (slot.pending.valid()) {
+            // Another thread is already creating it
+            std::shared_future<TextureHandle> pending = slot.pending;
+            lock.unlock();
+            TextureHandle existing = pending.get();
+            if (existing) {
+                hits++;
+                bytesDeduplicated += existing->bytes;
+            }
+            return existing;
+        }
+        slot.pending = promise.get_future().share();
+    }
+
+    // Loading happens outside the lock so other keys are not held up. A failed load hands
+    // its exception to the waiters and leaves the key free for the next attempt.
+    RegisteredTexture* entry = nullptr;
+    try {
+        entry = new RegisteredTexture(create());
+    } catch (...) {
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            auto it = slots.find(key);
+            if (it != slots.end()) {
+                it->second.pending = std::shared_future<TextureHandle>();
+                if (it->second.texture.expired()) slots.erase(it);
+            }
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+    TextureHandle handle;
+    if (entry->texture) {
+        if (entry->bytes == 0) {
+            entry->bytes = entry->texture->allocatedSize();
+        }
+        bytesResident += entry->bytes;
+        handle = TextureHandle(entry, [this, key](const RegisteredTexture* registered) {
+            release(key, registered);
+        });
+    } else {
+        delete entry;
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        Slot& slot = slots[key];
+        slot.texture = handle;
+        slot.pending = std::shared_future<TextureHandle>();
+    }
+    promise.set_value(handle);
+
+    return handle;
+}
+
+void TextureRegistry::release(const std::string& key, const RegisteredTexture* entry) {
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = slots.find(key);
+        // The key may already have been loaded again by someone else
+        if (it != slots.end() && it->second.texture.expired() && !it->second.pending.valid()) {
+            slots.erase(it);
+        }
+    }
+
+    bytesResident -= entry->bytes;
+    entry->texture->release();
+    delete entry;
+}
+
+size_t TextureRegistry::residentCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    size_t count = 0;
+    for (const auto& [key, slot] : slots) {
+        if (!slot.texture.expired()) count++;
+    }
+    return count;
+}
+
+void TextureRegistry::printStats() const {
+    std::cout << "Texture registry: " << residentCount() << " textures, "
+              << residentBytes() / (1024.0 * 1024.0) << " MB resident, "
+              << deduplicatedCount() << " duplicate loads avoided ("
+              << deduplicatedBytes() / (1024.0 * 1024.0) << " MB)" << std::endl;
+}
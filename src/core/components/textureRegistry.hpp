@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Metal/Metal.hpp>
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "vertexData.hpp"
+#include "textureAtlas.hpp"
+
+// A texture owned by the registry. Atlas entries also carry the slot of every packed image
+// and what is needed to stream in the levels above `firstLevel`.
+struct RegisteredTexture {
+    MTL::Texture*                       texture = nullptr;
+    std::vector<TextureInfo>            infos;
+    size_t                              bytes = 0;
+    std::shared_ptr<const AtlasSource>  atlas;
+    int                                 firstLevel = 0;  // Page level of the texture's level 0
+};
+
+// Holding a handle keeps the texture alive, the last handle to go away releases it
+using TextureHandle = std::shared_ptr<const RegisteredTexture>;
+
+// Process wide table of every texture the loaders created, so that meshes sharing a
+// material library or materials sharing an image decode and upload the pixels once.
+// Loader threads can look up and insert concurrently; when two threads ask for the same
+// key at once the second one waits for the first one's result instead of loading again.
+class TextureRegistry {
+public:
+    static TextureRegistry& shared();
+
+    // Key for an atlas built from these files, in this order
+    static std::string fileKey(const std::string& kind, const std::vector<std::string>& filePaths);
+    // Key for a texture identified by a hash of its pixels and import settings
+    static std::string contentKey(const std::string& kind, uint64_t contentHash);
+
+    // Returns the registered texture for `key`, calling `create` only if nobody holds it.
+    // `create` hands over one reference to the texture it returns. If it throws, the exception
+    // reaches this caller and everyone waiting for the key, and the next acquire tries again.
+    TextureHandle acquire(const std::string& key, const std::function<RegisteredTexture()>& create);
+
+    size_t residentCount() const;
+    size_t residentBytes() const { return bytesResident.load(); }
+    size_t deduplicatedBytes() const { return bytesDeduplicated.load(); }
+    size_t deduplicatedCount() const { return hits.load(); }
+
+    void printStats() const;
+
+private:
+    TextureRegistry() = default;
+
+    void release(const std::string& key, const RegisteredTexture* entry);
+
+    struct Slot {
+        std::weak_ptr<const RegisteredTexture>  texture;
+        std::shared_future<TextureHandle>       pending;
+    };
+
+    mutable std::shared_mutex                   mutex;
+    std::unordered_map<std::string, Slot>       slots;
+
+    std::atomic<size_t>                         bytesResident{0};
+    std::atomic<size_t>                         bytesDeduplicated{0};
+    std::atomic<size_t>                         hits{0};
+};
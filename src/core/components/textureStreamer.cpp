@@ -0,0 +1,279 @@
+#include "textureStreamer.hpp"
+#include "textureArray.hpp"
+#include "../taskScheduler.hpp"
+
+#include <cmath>
+
+TextureStreamer::TextureStreamer(MTL::Device* device, int framesInFlight, size_t budgetBytes)
+: device(device)
+, framesInFlight(framesInFlight)
+, budgetBytes(budgetBytes) {
+}
+
+TextureStreamer::~TextureStreamer() {
+    for (std::future<void>& load : loads) {
+        load.wait();
+    }
+    for (CompletedLoad& load : completed) {
+        load.texture->release();
+    }
+    for (StreamedAtlas& atlas : atlases) {
+        if (atlas.streamed) {
+            atlas.streamed->release();
+            atlas.streamed = nullptr;
+            // Meshes can outlive the streamer when a scene is reloaded
+            bind(atlas);
+        }
+    }
+    releaseRetired(0, true);
+}
+
+void TextureStreamer::addMeshes(const std::vector<Mesh*>& meshes) {
+    for (Mesh* mesh : meshes) {
+        if (!mesh->meshHasTextures()) continue;
+
+        const TextureHandle* handles[2] = {&mesh->diffuseTextureHandle, &mesh->normalTextureHandle};
+        for (int i = 0; i < 2; i++) {
+            const TextureHandle& handle = *handles[i];
+            // Only atlases with levels above their resident tail have anything to stream
+            if (!handle || !handle->atlas || handle->firstLevel == 0) continue;
+
+            auto it = atlasIndices.find(handle.get());
+            if (it == atlasIndices.end()) {
+                StreamedAtlas atlas;
+                atlas.base = handle;
+                atlas.residentLevel = handle->firstLevel;
+                atlas.targetLevel = handle->firstLevel;
+                it = atlasIndices.emplace(handle.get(), atlases.size()).first;
+                atlases.push_back(atlas);
+            }
+            atlases[it->second].users.push_back({mesh, i == 1});
+        }
+    }
+
+    updateStats();
+}
+
+void TextureStreamer::update(const Camera& camera, float viewportHeight, uint64_t frameNumber) {
+    releaseRetired(frameNumber, false);
+    applyCompletedLoads(frameNumber);
+    computeTargets(camera, viewportHeight);
+    scheduleLoads(frameNumber);
+    updateStats();
+}
+
+void TextureStreamer::computeTargets(const Camera& camera, float viewportHeight) {
+    float tanHalfFov = std::tan(camera.fov * 0.5f * float(M_PI) / 180.0f);
+    // Cone around the frustum diagonal, cheap and conservative enough for streaming
+    float halfDiagonal = std::atan(tanHalfFov * std::sqrt(1.0f + camera.aspectRatio * camera.aspectRatio));
+
+    // Atlases only read the meshes and write their own targets
+    TaskScheduler::shared().parallelFor(atlases.size(), [&](size_t index) {
+        StreamedAtlas& atlas = atlases[index];
+        const AtlasSource& source = *atlas.base->atlas;
+        atlas.targetLevel = atlas.base->firstLevel;
+        atlas.priority = 0.0f;
+
+        for (const MeshUse& use : atlas.users) {
+            simd::float3 center;
+            float radius;
+            use.mesh->getWorldBoundingSphere(center, radius);
+
+            simd::float3 toCenter = center - camera.position;
+            float distance = simd::length(toCenter);
+
+            if (distance > radius) {
+                float angle = std::acos(std::clamp(simd::dot(toCenter / distance, camera.front), -1.0f, 1.0f));
+                if (angle > halfDiagonal + std::asin(radius / distance)) continue;
+            }
+
+            // Pixels covered by the mesh across the screen. The atlas images are assumed to
+            // span the mesh once, so the largest one needs this many texels across it.
+            float nearest = std::max(distance - radius, camera.nearPlane);
+            float projectedPixels = radius * viewportHeight / (nearest * tanHalfFov);
+            float texelsPerPixel = source.maxImageExtent / std::max(projectedPixels, 1.0f);
+
+            int level = static_cast<int>(std::floor(std::log2(std::max(texelsPerPixel, 1.0f))));
+            atlas.targetLevel = std::min(atlas.targetLevel, std::clamp(level, 0, atlas.base->firstLevel));
+            atlas.priority = std::max(atlas.priority, projectedPixels);
+        }
+    }, TEXTURE_STREAMING_ATLASES_PER_TASK);
+}
+
+void TextureStreamer::applyCompletedLoads(uint64_t frameNumber) {
+    std::vector<CompletedLoad> finished;
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        finished.swap(completed);
+    }
+
+    loads.erase(std::remove_if(loads.begin(), loads.end(), [](std::future<void>& load) {
+        return load.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), loads.end());
+
+    for (const CompletedLoad& load : finished) {
+        StreamedAtlas& atlas = atlases[load.atlasIndex];
+        atlas.loading = false;
+        atlas.pendingBytes = 0;
+
+        if (atlas.streamed) {
+            retire(atlas.streamed, frameNumber);
+        }
+        atlas.streamed = load.texture;
+        atlas.streamedBytes = load.bytes;
+        atlas.residentLevel = load.level;
+        bind(atlas);
+
+        stats.totalUploadedBytes += load.bytes;
+        uploadHistory.emplace_back(Clock::now(), load.bytes);
+    }
+}
+
+void TextureStreamer::scheduleLoads(uint64_t frameNumber) {
+    std::vector<size_t> wanted;
+    for (size_t i = 0; i < atlases.size(); i++) {
+        if (!atlases[i].loading && atlases[i].targetLevel < atlases[i].residentLevel) {
+            wanted.push_back(i);
+        }
+    }
+    std::sort(wanted.begin(), wanted.end(), [this](size_t a, size_t b) {
+        return atlases[a].priority > atlases[b].priority;
+    });
+
+    for (size_t index : wanted) {
+        if (static_cast<int>(loads.size()) >= TEXTURE_STREAMING_MAX_IN_FLIGHT) break;
+
+        StreamedAtlas& atlas = atlases[index];
+        std::shared_ptr<const AtlasSource> source = atlas.base->atlas;
+
+        // Settle for a coarser level than the target if the finest one does not fit
+        int level = atlas.targetLevel;
+        for (; level < atlas.residentLevel; level++) {
+            size_t bytes = source->bytesFromLevel(level);
+            // The current streamed version is released once the new one arrives
+            size_t needed = bytes > atlas.streamedBytes ? bytes - atlas.streamedBytes : 0;
+            if (makeRoom(needed, atlas.priority, index, frameNumber)) break;
+        }
+        if (level >= atlas.residentLevel) continue;
+
+        atlas.loading = true;
+        atlas.pendingBytes = source->bytesFromLevel(level);
+
+        MTL::Device* metalDevice = device;
+        loads.push_back(TaskScheduler::shared().submit([this, index, level, source, metalDevice]() {
+            NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+            CompletedLoad load;
+            load.atlasIndex = index;
+            load.level = level;
+            load.texture = TextureArray::buildTexture(*source, metalDevice, level);
+            load.texture->setLabel(NS::String::string("Streamed Texture Array", NS::ASCIIStringEncoding));
+            load.bytes = source->bytesFromLevel(level);
+
+            pool->release();
+
+            std::lock_guard<std::mutex> lock(completedMutex);
+            completed.push_back(load);
+        }));
+    }
+}
+
+bool TextureStreamer::makeRoom(size_t bytes, float priority, size_t keepIndex, uint64_t frameNumber) {
+    size_t used = 0;
+    for (const StreamedAtlas& atlas : atlases) {
+        used += atlas.streamedBytes + atlas.pendingBytes;
+    }
+    if (used + bytes <= budgetBytes) return true;
+
+    // Atlases streamed finer than they need right now go first, then the least visible
+    std::vector<size_t> victims;
+    for (size_t i = 0; i < atlases.size(); i++) {
+        const StreamedAtlas& atlas = atlases[i];
+        if (i == keepIndex || !atlas.streamed || atlas.loading) continue;
+        bool oversized = atlas.residentLevel < atlas.targetLevel;
+        if (oversized || atlas.priority < priority) {
+            victims.push_back(i);
+        }
+    }
+    std::sort(victims.begin(), victims.end(), [this](size_t a, size_t b) {
+        bool oversizedA = atlases[a].residentLevel < atlases[a].targetLevel;
+        bool oversizedB = atlases[b].residentLevel < atlases[b].targetLevel;
+        if (oversizedA != oversizedB) return oversizedA;
+        return atlases[a].priority < atlases[b].priority;
+    });
+
+    // Only evict if that actually makes the load fit
+    size_t reclaimable = 0;
+    size_t victimCount = 0;
+    while (victimCount < victims.size() && used - reclaimable + bytes > budgetBytes) {
+        reclaimable += atlases[victims[victimCount++]].streamedBytes;
+    }
+    if (used - reclaimable + bytes > budgetBytes) return false;
+
+    for (size_t i = 0; i < victimCount; i++) {
+        evict(atlases[victims[i]], frameNumber);
+    }
+    return true;
+}
+
+void TextureStreamer::evict(StreamedAtlas& atlas, uint64_t frameNumber) {
+    retire(atlas.streamed, frameNumber);
+    atlas.streamed = nullptr;
+    atlas.streamedBytes = 0;
+    atlas.residentLevel = atlas.base->firstLevel;
+    bind(atlas);
+    stats.evictions++;
+}
+
+void TextureStreamer::bind(StreamedAtlas& atlas) {
+    MTL::Texture* texture = atlas.streamed ? atlas.streamed : atlas.base->texture;
+    for (const MeshUse& use : atlas.users) {
+        if (use.normalMap) {
+            use.mesh->normalTextures = texture;
+        } else {
+            use.mesh->diffuseTextures = texture;
+        }
+    }
+}
+
+void TextureStreamer::retire(MTL::Texture* texture, uint64_t frameNumber) {
+    // Command buffers still in flight may be sampling it
+    retired.push_back({texture, frameNumber + framesInFlight});
+}
+
+void TextureStreamer::releaseRetired(uint64_t frameNumber, bool all) {
+    retired.erase(std::remove_if(retired.begin(), retired.end(), [frameNumber, all](const RetiredTexture& entry) {
+        if (!all && entry.releaseFrame > frameNumber) return false;
+        entry.texture->release();
+        return true;
+    }), retired.end());
+}
+
+void TextureStreamer::updateStats() {
+    stats.budgetBytes = budgetBytes;
+    stats.baseBytes = 0;
+    stats.streamedBytes = 0;
+    stats.pendingBytes = 0;
+    stats.atlasCount = static_cast<int>(atlases.size());
+    stats.atlasesAtTarget = 0;
+    stats.loadsInFlight = static_cast<int>(loads.size());
+
+    for (const StreamedAtlas& atlas : atlases) {
+        stats.baseBytes += atlas.base->bytes;
+        stats.streamedBytes += atlas.streamedBytes;
+        stats.pendingBytes += atlas.pendingBytes;
+        if (atlas.residentLevel <= atlas.targetLevel) {
+            stats.atlasesAtTarget++;
+        }
+    }
+
+    Clock::time_point now = Clock::now();
+    while (!uploadHistory.empty() && now - uploadHistory.front().first > std::chrono::seconds(1)) {
+        uploadHistory.pop_front();
+    }
+    size_t recentBytes = 0;
+    for (const auto& [time, bytes] : uploadHistory) {
+        recentBytes += bytes;
+    }
+    stats.bandwidthMBps = recentBytes / (1024.0f * 1024.0f);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include <Metal/Metal.hpp>
+#include <future>
+#include <mutex>
+
+#include "mesh.hpp"
+#include "camera.hpp"
+#include "textureRegistry.hpp"
+
+constexpr size_t TEXTURE_STREAMING_DEFAULT_BUDGET = size_t(512) << 20; // 512 MB
+constexpr int    TEXTURE_STREAMING_MAX_IN_FLIGHT  = 2;
+// Atlases whose targets are computed together, most scenes have too few to split at all
+constexpr size_t TEXTURE_STREAMING_ATLASES_PER_TASK = 16;
+
+struct TextureStreamingStats {
+    size_t  budgetBytes = 0;
+    size_t  baseBytes = 0;          // Lowest mips, always resident
+    size_t  streamedBytes = 0;      // Higher mips currently resident, counted against the budget
+    size_t  pendingBytes = 0;       // Loads in flight
+    size_t  totalUploadedBytes = 0; // Everything streamed in since startup
+    float   bandwidthMBps = 0.0f;   // Uploads over the last second
+    int     atlasCount = 0;
+    int     atlasesAtTarget = 0;
+    int     loadsInFlight = 0;
+    int     evictions = 0;
+};
+
+// Streams the upper mip levels of texture atlases in and out. Every atlas starts with
+// only its smallest levels resident. Each frame the streamer estimates how many texels
+// per pixel every visible mesh needs from its bounds and the camera, then rebuilds the
+// most wanted atlases at a finer first level on the TaskScheduler and swaps them into
+// the meshes once ready. Streamed levels are counted against a budget and the least
+// important atlases fall back to their base levels when something more visible needs
+// the memory.
+//
+// An atlas is always bound with its finest resident level as level 0, so sampling in
+// the gbuffer pass can never reach a level that is not loaded.
+class TextureStreamer {
+public:
+    TextureStreamer(MTL::Device* device, int framesInFlight, size_t budgetBytes = TEXTURE_STREAMING_DEFAULT_BUDGET);
+    ~TextureStreamer();
+
+    void addMeshes(const std::vector<Mesh*>& meshes);
+    void update(const Camera& camera, float viewportHeight, uint64_t frameNumber);
+
+    void setBudget(size_t bytes) { budgetBytes = bytes; }
+    const TextureStreamingStats& getStats() const { return stats; }
+
+private:
+    struct MeshUse {
+        Mesh*   mesh;
+        bool    normalMap;
+    };
+
+    struct StreamedAtlas {
+        TextureHandle           base;
+        std::vector<MeshUse>    users;
+        MTL::Texture*           streamed = nullptr;
+        size_t                  streamedBytes = 0;
+        size_t                  pendingBytes = 0;
+        int                     residentLevel = 0;  // Page level that is bound as level 0
+        int                     targetLevel = 0;
+        float                   priority = 0.0f;    // Largest projected size of a visible user, in pixels
+        bool                    loading = false;
+    };
+
+    struct CompletedLoad {
+        size_t          atlasIndex;
+        int             level;
+        MTL::Texture*   texture;
+        size_t          bytes;
+    };
+
+    struct RetiredTexture {
+        MTL::Texture*   texture;
+        uint64_t        releaseFrame;
+    };
+
+    void computeTargets(const Camera& camera, float viewportHeight);
+    void applyCompletedLoads(uint64_t frameNumber);
+    void scheduleLoads(uint64_t frameNumber);
+    bool makeRoom(size_t bytes, float priority, size_t keepIndex, uint64_t frameNumber);
+    void evict(StreamedAtlas& atlas, uint64_t frameNumber);
+    void bind(StreamedAtlas& atlas);
+    void retire(MTL::Texture* texture, uint64_t frameNumber);
+    void releaseRetired(uint64_t frameNumber, bool all);
+    void updateStats();
+
+    MTL::Device*                device;
+    int                         framesInFlight;
+    size_t                      budgetBytes;
+
+    std::vector<StreamedAtlas>                              atlases;
+    std::unordered_map<const RegisteredTexture*, size_t>    atlasIndices;
+    std::vector<RetiredTexture>                             retired;
+
+    std::mutex                      completedMutex;
+    std::vector<CompletedLoad>      completed;
+    std::vector<std::future<void>>  loads;
+
+    using Clock = std::chrono::steady_clock;
+    std::deque<std::pair<Clock::time_point, size_t>>   uploadHistory;
+
+    TextureStreamingStats           stats;
+};
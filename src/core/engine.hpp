@@ -19,6 +19,12 @@
 #include "components/camera.hpp"
 #include "components/gltfLoader.hpp"
 #include "components/sceneParser.hpp"
+#include "components/sceneBinary.hpp"
+#include "components/sceneDescription.hpp"
+#include "components/sceneDiff.hpp"
+#include "components/sceneWatcher.hpp"
+#include "components/textureStreamer.hpp"
+#include "components/assetStreamer.hpp"
 #include "../../data/shaders/config.hpp"
 #include "managers/renderPipeline.hpp"
 #include "../editor/editor.hpp"
@@ -26,6 +32,9 @@
 #include "managers/resourceManager.hpp"
 #include "managers/renderPassManager.hpp"
 #include "managers/rayTracingManager.hpp"
+#include "taskScheduler.hpp"
+#include "fileReader.hpp"
+#include "startupTimeline.hpp"
 
 #include <stb/stb_image.h>
 
@@ -35,6 +44,10 @@
 constexpr uint8_t MaxFramesInFlight = 3;
 constexpr float NEAR_PLANE = 0.1f;
 constexpr float FAR_PLANE = 100.0f;
+// Off loads scene objects one after another, for comparing load times
+constexpr bool PARALLEL_SCENE_LOADING = true;
+// Off runs the startup stages one after another, for comparing time to first frame
+constexpr bool PARALLEL_STARTUP = true;
 
 
 class Engine {
@@ -54,8 +67,12 @@ private:
     void initDevice();
     void initWindow();
 
-    void loadSceneFromJSON(const std::string& jsonFilePath);
+    void loadSceneFromFile(const std::string& sceneFilePath);
     void loadScene();
+    // Applies the changes in the scene file, called when the watcher sees it change
+    void reloadScene();
+    // Builds sceneDescription from the binary mapping, the first reload of a binary scene needs it
+    void describeScene();
     void createBuffers();
 	
 	MTL::CommandBuffer* beginFrame(bool isPaused);
@@ -102,6 +119,11 @@ private:
     std::unique_ptr<ResourceManager>    resourceManager;
     std::unique_ptr<RayTracingManager>  rayTracingManager;
     std::unique_ptr<RenderPassManager>  renderPassManager;
+    std::unique_ptr<TextureStreamer>    textureStreamer;
+    // Meshes and textures requested while running, handed back at the start of each frame
+    std::unique_ptr<AssetStreamer>      assetStreamer;
+    // From the start of init until the first frame has been submitted
+    std::unique_ptr<StartupTimeline>    startupTimeline;
     
     bool                windowResizeFlag = false;
     int                 newWidth;
@@ -129,11 +151,23 @@ private:
     MTL::CommandQueue*          metalCommandQueue;
 	
     std::vector<Mesh*>          meshes;
+    
+    // Scene file the meshes came from. sceneObjects has one entry per object of
+    // sceneDescription, nullptr where the mesh failed to load. Binary scenes keep their
+    // mapping instead, sceneObjects then follows its instances until describeScene().
+    std::string                     scenePath;
+    SceneDescription                sceneDescription;
+    std::unique_ptr<BinaryScene>    sceneBinary;
+    std::vector<Mesh*>              sceneObjects;
+    std::unique_ptr<SceneWatcher>   sceneWatcher;
 
     MTL::SamplerState*          samplerState;
 
     uint64_t                    frameNumber;
     uint8_t                     frameDataBufferIndex;
+    // Kept here because the FrameData buffer of the last frame may already be in flight
+    simd::float4x4              previousViewProjectionMatrix;
+    bool                        hasPreviousViewProjection = false;
     
     // Ray tracing
     std::vector<MTL::AccelerationStructure*>    primitiveAccelerationStructures;
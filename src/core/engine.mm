@@ -13,8 +13,15 @@ Engine::Engine()
 }
 
 void Engine::init() {
-    initDevice();
-    initWindow();
+    startupTimeline = std::make_unique<StartupTimeline>();
+    StartupTimeline& timeline = *startupTimeline;
+    TaskScheduler& scheduler = TaskScheduler::shared();
+    
+    // GLFW and Cocoa have to be set up on the main thread
+    timeline.measure("device and window", [this]() {
+        initDevice();
+        initWindow();
+    });
 
     resourceManager = std::make_unique<ResourceManager>(metalDevice);
     editor = std::make_unique<Editor>(glfwWindow, metalDevice);
@@ -22,12 +29,56 @@ void Engine::init() {
     rayTracingManager = std::make_unique<RayTracingManager>(metalDevice, resourceManager.get());
 
     createCommandQueue();
-	loadScene();
-    createDefaultLibrary();
-    createBuffers();
-    renderPipelines.initialize(metalDevice, metalDefaultLibrary);
+    
+    // Shared by stages that run at the same time: the formats by the pipelines and the
+    // render targets, the vertex descriptor by the pipelines and the meshes
+    albedoSpecularGBufferFormat = MTL::PixelFormatRGBA8Unorm_sRGB;
+    normalMapGBufferFormat = MTL::PixelFormatRGBA8Snorm;
+    depthGBufferFormat = MTL::PixelFormatR32Float;
     defaultVertexDescriptor = createDefaultVertexDescriptor();
-    createRenderPipelines();
+    assetStreamer = std::make_unique<AssetStreamer>(metalDevice, defaultVertexDescriptor);
+    
+    // The shaders compile while the scene loads, and the acceleration structure and the
+    // texture streamer only wait for the geometry. Without PARALLEL_STARTUP every stage is
+    // waited on as soon as it is spawned, so they run one after another in this order.
+    auto stage = [&](const char* name, std::function<void()> body, const std::vector<TaskHandle>& dependencies = {}) {
+        TaskHandle task = scheduler.spawn([&timeline, name, body]() {
+            @autoreleasepool {
+                timeline.measure(name, body);
+            }
+        }, dependencies);
+        if (!PARALLEL_STARTUP) {
+            scheduler.wait(task);
+        }
+        return task;
+    };
+    
+    TaskHandle scene = stage("scene", [this]() {
+        loadScene();
+    });
+    TaskHandle streamer = stage("texture streamer", [this]() {
+        textureStreamer = std::make_unique<TextureStreamer>(metalDevice, MaxFramesInFlight);
+        textureStreamer->addMeshes(meshes);
+    }, {scene});
+    TaskHandle accelerationStructure = stage("acceleration structure", [this]() {
+        rayTracingManager->setupAccelerationStructures(meshes);
+        rayTracingManager->setupTriangleResources(meshes);
+    }, {scene});
+    TaskHandle library = stage("shader library", [this]() {
+        createDefaultLibrary();
+    });
+    TaskHandle pipelines = stage("pipelines", [this]() {
+        renderPipelines.initialize(metalDevice, metalDefaultLibrary);
+        createRenderPipelines();
+    }, {library});
+    
+    // Only depend on the window, so they are made here while the stages run
+    timeline.measure("frame buffers", [this]() {
+        createBuffers();
+    });
+    timeline.measure("render targets", [this]() {
+        createViewRenderPassDescriptor();
+    });
 
     renderPassManager = std::make_unique<RenderPassManager>(
         metalDevice, 
@@ -38,9 +89,10 @@ void Engine::init() {
         editor.get()
     );
     
-	createViewRenderPassDescriptor();
-    rayTracingManager->setupAccelerationStructures(meshes);
-    rayTracingManager->setupTriangleResources(meshes);
+    // Runs whatever is still pending on this thread as well
+    timeline.measure("wait for stages", [&]() {
+        scheduler.wait({scene, streamer, accelerationStructure, library, pipelines});
+    });
 }
 
 void Engine::run() {
@@ -53,8 +105,22 @@ void Engine::run() {
         editor->debug.cameraPosition = camera.position;
         
         @autoreleasepool {
+            if (sceneWatcher && sceneWatcher->poll()) {
+                reloadScene();
+            }
+            
             metalDrawable = (__bridge CA::MetalDrawable*)[metalLayer nextDrawable];
-            draw();
+            if (startupTimeline) {
+                startupTimeline->measure("first frame", [this]() {
+                    draw();
+                });
+                startupTimeline->print(std::cout);
+                std::cout << "Time to first frame: " << startupTimeline->elapsedMs() << " ms ("
+                          << (PARALLEL_STARTUP ? "parallel" : "serial") << " startup)" << std::endl;
+                startupTimeline.reset();
+            } else {
+                draw();
+            }
         }
         
         glfwPollEvents();
@@ -64,6 +130,11 @@ void Engine::run() {
 void Engine::cleanup() {
     glfwTerminate();
     
+    // Waits for loads in flight and drops the streamed mips before the meshes go away
+    textureStreamer.reset();
+    // Resumes whatever still awaits an asset, so it goes before the meshes as well
+    assetStreamer.reset();
+    
     // Clean up mesh objects
     for (auto& mesh : meshes) {
         delete mesh;
@@ -214,20 +285,181 @@ void Engine::endFrame(MTL::CommandBuffer* commandBuffer) {
     }
 }
 
-void Engine::loadSceneFromJSON(const std::string& jsonFilePath) {
+void Engine::loadSceneFromFile(const std::string& sceneFilePath) {
     if (!defaultVertexDescriptor) {
         defaultVertexDescriptor = createDefaultVertexDescriptor();
     }
     
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
     SceneParser parser(metalDevice, defaultVertexDescriptor);
+    parser.setParallelLoading(PARALLEL_SCENE_LOADING);
+    
+    // .json scenes are parsed into the description, which is kept so the next version of
+    // the file can be diffed against it. SCENE_BINARY_EXTENSION scenes are created straight
+    // from the mapping, their description is only built once a reload needs it.
+    sceneDescription.clear();
+    sceneBinary.reset();
+    if (SceneReader::isBinaryPath(sceneFilePath)) {
+        sceneBinary = BinaryScene::open(sceneFilePath);
+        if (!sceneBinary) {
+            return;
+        }
+        sceneObjects = parser.createObjects(*sceneBinary);
+    } else {
+        if (!SceneReader::readJSON(sceneFilePath, sceneDescription)) {
+            return;
+        }
+        sceneObjects = parser.createObjects(sceneDescription);
+    }
+    
+    for (Mesh* mesh : sceneObjects) {
+        if (mesh) {
+            meshes.push_back(mesh);
+        }
+    }
+    
+    scenePath = sceneFilePath;
+    sceneWatcher = std::make_unique<SceneWatcher>(sceneFilePath);
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    std::cout << "Scene loaded in "
+              << std::chrono::duration<double, std::milli>(endTime - startTime).count() << " ms: "
+              << meshes.size() << " objects, " << (PARALLEL_SCENE_LOADING ? "parallel" : "serial") << std::endl;
     
-    std::vector<Mesh*> loadedMeshes = parser.loadScene(jsonFilePath);
+    // Everything read so far was for this scene: meshes, images and the scene file itself
+    FileReadStats reads = FileReader::shared().takeStats();
+    std::cout << "File reads (" << reads.backend << "): " << reads.files << " files, "
+              << reads.bytes / (1024.0 * 1024.0) << " MB in " << reads.busyMs << " ms, "
+              << reads.throughputMBps() << " MB/s, queue depth " << reads.averageQueueDepth
+              << " average, " << reads.maxQueueDepth << " max" << std::endl;
     
-    meshes.insert(meshes.end(), loadedMeshes.begin(), loadedMeshes.end());
+    TextureRegistry::shared().printStats();
+}
+
+void Engine::describeScene() {
+    if (!sceneBinary) {
+        return;
+    }
+    
+    // toDescription skips the instances with an unknown mesh, their objects are nullptr
+    std::vector<Mesh*> objects;
+    objects.reserve(sceneObjects.size());
+    for (uint32_t i = 0; i < sceneBinary->instanceCount(); i++) {
+        if (sceneBinary->instanceMesh(i) < sceneBinary->meshCount()) {
+            objects.push_back(sceneObjects[i]);
+        }
+    }
+    
+    sceneBinary->toDescription(sceneDescription);
+    sceneObjects = std::move(objects);
+    sceneBinary.reset();
+}
+
+void Engine::reloadScene() {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    // The mapping still shows the loaded version, BinaryScene::write replaces the file
+    describeScene();
+    
+    SceneDescription nextScene;
+    if (!SceneReader::read(scenePath, nextScene)) {
+        std::cerr << "Scene reload failed, keeping the current scene" << std::endl;
+        return;
+    }
+    
+    SceneDiff diff = SceneDiff::compute(sceneDescription, nextScene);
+    if (diff.empty()) {
+        sceneDescription = std::move(nextScene);
+        return;
+    }
+    
+    // Frames in flight read the meshes, the acceleration structure and the triangle data.
+    // Reloads are rare, so simply let the queue drain before touching any of them.
+    MTL::CommandBuffer* drainCommandBuffer = metalCommandQueue->commandBuffer();
+    drainCommandBuffer->commit();
+    drainCommandBuffer->waitUntilCompleted();
+    
+    bool refit = diff.canRefit();
+    if (!refit) {
+        // The streamer points at the meshes, it is recreated for the new set below
+        textureStreamer.reset();
+    }
+    
+    // Kept objects are updated in place
+    std::vector<Mesh*> nextObjects(nextScene.instanceCount(), nullptr);
+    std::vector<bool> carried(sceneObjects.size(), false);
+    for (size_t i = 0; i < nextScene.instanceCount(); i++) {
+        if (diff.needsMesh(i)) continue;
+        
+        size_t previous = static_cast<size_t>(diff.previousIndex[i]);
+        carried[previous] = true;
+        nextObjects[i] = sceneObjects[previous];
+        if (nextObjects[i]) {
+            nextObjects[i]->meshInfo = nextScene.instances[i];
+        }
+    }
+    
+    // New and changed objects copy geometry that is already loaded where they can
+    SceneParser parser(metalDevice, defaultVertexDescriptor);
+    for (size_t i = 0; i < nextScene.instanceCount(); i++) {
+        if (!diff.needsMesh(i)) continue;
+        
+        Mesh* source = diff.reuseFrom[i] >= 0 ? nextObjects[diff.reuseFrom[i]] : nullptr;
+        if (source) {
+            nextObjects[i] = new Mesh(*source, nextScene.instances[i]);
+        } else {
+            uint32_t meshIndex = nextScene.instanceMeshes[i];
+            nextObjects[i] = parser.createMesh(nextScene.meshNames[meshIndex], nextScene.meshPaths[meshIndex], nextScene.instances[i]);
+        }
+    }
+    
+    for (size_t i = 0; i < sceneObjects.size(); i++) {
+        if (!carried[i]) {
+            delete sceneObjects[i];
+        }
+    }
+    
+    meshes.clear();
+    std::vector<size_t> movedMeshes;
+    std::vector<size_t> restyledMeshes;
+    for (size_t i = 0; i < nextObjects.size(); i++) {
+        if (!nextObjects[i]) continue;
+        
+        if (diff.changes[i] & SceneObjectMoved) {
+            movedMeshes.push_back(meshes.size());
+        }
+        if (diff.changes[i] & SceneObjectRestyled) {
+            restyledMeshes.push_back(meshes.size());
+        }
+        meshes.push_back(nextObjects[i]);
+    }
+    
+    if (refit) {
+        rayTracingManager->refitAccelerationStructures(meshes, movedMeshes);
+        rayTracingManager->updateTriangleResources(meshes, restyledMeshes);
+    } else {
+        rayTracingManager->setupAccelerationStructures(meshes);
+        rayTracingManager->setupTriangleResources(meshes);
+        
+        textureStreamer = std::make_unique<TextureStreamer>(metalDevice, MaxFramesInFlight);
+        textureStreamer->addMeshes(meshes);
+    }
+    
+    sceneDescription = std::move(nextScene);
+    sceneObjects = std::move(nextObjects);
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    std::cout << "Scene reloaded in "
+              << std::chrono::duration<double, std::milli>(endTime - startTime).count() << " ms: "
+              << diff.movedCount << " moved, " << diff.restyledCount << " restyled, "
+              << diff.createdCount << " created (" << diff.reusedCount << " from loaded geometry), "
+              << diff.removed.size() << " removed, acceleration structure "
+              << (refit ? "refit" : "rebuilt") << std::endl;
 }
 
 void Engine::loadScene() {
-    loadSceneFromJSON(std::string(SCENES_PATH) + "/cubesScene.json");
+    loadSceneFromFile(std::string(SCENES_PATH) + "/cubesScene.json");
 }
 
 MTL::VertexDescriptor* Engine::createDefaultVertexDescriptor() {
@@ -380,6 +612,12 @@ void Engine::updateWorldState(bool isPaused) {
 	frameData->projection_matrix_inverse = matrix_invert(frameData->projection_matrix);
 	frameData->view_matrix = camera.getViewMatrix();
     frameData->view_matrix_inverse = camera.getInverseViewMatrix();
+
+    // The first frame has no history and reprojects onto itself
+    simd::float4x4 viewProjectionMatrix = frameData->projection_matrix * frameData->view_matrix;
+    frameData->previous_view_projection_matrix = hasPreviousViewProjection ? previousViewProjectionMatrix : viewProjectionMatrix;
+    previousViewProjectionMatrix = viewProjectionMatrix;
+    hasPreviousViewProjection = true;
     
     frameData->cameraUp         = float4{camera.up.x,       camera.up.y,        camera.up.z, 1.0f};
     frameData->cameraRight      = float4{camera.right.x,    camera.right.y,     camera.right.z, 1.0f};
@@ -391,6 +629,7 @@ void Engine::updateWorldState(bool isPaused) {
 	frameData->framebuffer_height = (uint)metalLayer.drawableSize.height;
     frameData->near_plane = NEAR_PLANE;
     frameData->far_plane = FAR_PLANE;
+    frameData->frame_index = (uint)frameNumber;
 
 	// Define the sun color
 	frameData->sun_color = simd_make_float4(0.95, 0.95, 0.9, 1.0);
@@ -424,10 +663,6 @@ void Engine::createCommandQueue() {
 
 void Engine::createRenderPipelines() {
     NS::Error* error;
-	
-	albedoSpecularGBufferFormat = MTL::PixelFormatRGBA8Unorm_sRGB;
-	normalMapGBufferFormat 	    = MTL::PixelFormatRGBA8Snorm;
-	depthGBufferFormat			= MTL::PixelFormatR32Float;
 
     #pragma mark Deferred render pipeline setup
     {
@@ -620,11 +855,7 @@ void Engine::createDebugLines() {
 }
 
 void Engine::createViewRenderPassDescriptor() {
-    // Define GBuffer formats
-    albedoSpecularGBufferFormat = MTL::PixelFormatRGBA8Unorm_sRGB;
-    normalMapGBufferFormat = MTL::PixelFormatRGBA8Snorm;
-    depthGBufferFormat = MTL::PixelFormatR32Float;
-    
+    // GBuffer formats are set in init
     uint32_t width = metalLayer.drawableSize.width;
     uint32_t height = metalLayer.drawableSize.height;
         
@@ -736,6 +967,16 @@ void Engine::draw() {
     MTL::CommandBuffer* commandBuffer = beginFrame(false);
     editor->beginFrame(forwardDescriptor);
     camera.position = editor->debug.cameraPosition;
+    
+    // Swap in finished mip loads before anything binds mesh textures this frame
+    textureStreamer->setBudget(size_t(editor->debug.textureBudgetMB) << 20);
+    textureStreamer->update(camera, metalLayer.drawableSize.height, frameNumber);
+    editor->textureStreaming = textureStreamer->getStats();
+    
+    // Only picks up finished loads, anything still reading from disk stays on the workers
+    assetStreamer->updateInterest(camera);
+    assetStreamer->update();
+    editor->assetStreaming = assetStreamer->getStats();
 
     // Depth prepass
     renderPassManager->drawDepthPrepass(commandBuffer, meshes, frameDataBuffers[currentFrameIndex]);
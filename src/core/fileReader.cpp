@@ -0,0 +1,470 @@
+#include "fileReader.hpp"
+#include "taskScheduler.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <condition_variable>
+#include <thread>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Returns the descriptor and sets size, -1 if the file cannot be opened
+int openForRead(const std::string& path, size_t& size) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    size = static_cast<size_t>(info.st_size);
+    return fd;
+}
+
+}
+
+#ifdef __linux__
+
+// Owns the ring and the thread that feeds it. Files are opened only when their first
+// request is about to be queued, so a large batch does not hold hundreds of descriptors.
+// Every request is a readv into the file's final buffer, the thread hands the file to the
+// scheduler once all of its requests are back.
+//
+// The thread blocks in io_uring_enter while requests are in flight, batches queued in the
+// meantime are picked up with the next completion.
+struct FileReader::Backend {
+    struct OpenFile {
+        FileReadHandle              batch;
+        size_t                      index = 0;
+        int                         fd = -1;
+        size_t                      size = 0;
+        size_t                      issued = 0;
+        int                         outstanding = 0;
+        bool                        failed = false;
+        std::vector<unsigned char>  bytes;
+    };
+
+    struct Request {
+        std::shared_ptr<OpenFile>   file;
+        iovec                       buffer;
+        size_t                      offset;
+    };
+
+    explicit Backend(FileReader& reader) : reader(reader) {}
+
+    ~Backend() {
+        if (thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_one();
+            thread.join();
+        }
+        if (sqes != MAP_FAILED) ::munmap(sqes, entries * sizeof(io_uring_sqe));
+        if (cqRing != MAP_FAILED && cqRing != sqRing) ::munmap(cqRing, cqRingSize);
+        if (sqRing != MAP_FAILED) ::munmap(sqRing, sqRingSize);
+        if (ringFd >= 0) ::close(ringFd);
+    }
+
+    // False when the kernel is too old or io_uring is not allowed, e.g. in a container
+    bool start() {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ringFd = static_cast<int>(::syscall(__NR_io_uring_setup, FILE_READ_QUEUE_DEPTH, &params));
+        if (ringFd < 0) return false;
+
+        entries = params.sq_entries;
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap) {
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+
+        sqRing = ::mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) return false;
+        cqRing = singleMap ? sqRing
+                           : ::mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) return false;
+        sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE,
+                                                 MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) return false;
+
+        char* sq = static_cast<char*>(sqRing);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cqRing);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        requests.resize(entries);
+        for (unsigned slot = 0; slot < entries; slot++) {
+            freeSlots.push_back(slot);
+        }
+
+        thread = std::thread(&Backend::run, this);
+        return true;
+    }
+
+    void enqueue(const FileReadHandle& batch) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < batch->paths.size(); i++) {
+                incoming.emplace_back(batch, i);
+            }
+        }
+        wake.notify_one();
+    }
+
+    void run() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (inFlight == 0 && unsubmitted == 0 && !current && waiting.empty()) {
+                    wake.wait(lock, [this]() { return stopping || !incoming.empty(); });
+                    if (incoming.empty()) return;
+                }
+                waiting.insert(waiting.end(), incoming.begin(), incoming.end());
+                incoming.clear();
+            }
+
+            while (prepareNext()) {
+            }
+            if (inFlight == 0 && unsubmitted == 0) continue;
+
+            int submitted = static_cast<int>(::syscall(__NR_io_uring_enter, ringFd, unsubmitted, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+            if (submitted < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+                std::cerr << "io_uring_enter failed: " << std::strerror(errno) << std::endl;
+                assert(false);
+                return;
+            }
+            if (submitted > 0) {
+                unsubmitted -= submitted;
+                inFlight += submitted;
+                reader.trackDepth(submitted);
+            }
+
+            reap();
+        }
+    }
+
+    // Queues one request, a retry of a short read before anything new
+    bool prepareNext() {
+        unsigned slot;
+        if (!retrySlots.empty()) {
+            slot = retrySlots.back();
+            retrySlots.pop_back();
+            if (requests[slot].file->failed) {
+                release(slot);
+                return true;
+            }
+        } else {
+            if (freeSlots.empty() || !nextFile()) return false;
+
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+
+            Request& request = requests[slot];
+            size_t length = std::min(FILE_READ_CHUNK_BYTES, current->size - current->issued);
+            request.file = current;
+            request.offset = current->issued;
+            request.buffer.iov_base = current->bytes.data() + current->issued;
+            request.buffer.iov_len = length;
+            current->issued += length;
+            current->outstanding++;
+        }
+
+        const Request& request = requests[slot];
+        unsigned tail = *sqTail;
+        unsigned index = tail & *sqMask;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = request.file->fd;
+        sqe.off = request.offset;
+        sqe.addr = reinterpret_cast<uint64_t>(&request.buffer);
+        sqe.len = 1;
+        sqe.user_data = slot;
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        unsubmitted++;
+        return true;
+    }
+
+    // Makes current a file with data left to request, opening waiting files as needed
+    bool nextFile() {
+        while (!current || current->failed || current->issued == current->size) {
+            current.reset();
+            if (waiting.empty()) return false;
+
+            auto [batch, index] = waiting.front();
+            waiting.pop_front();
+
+            auto file = std::make_shared<OpenFile>();
+            file->batch = batch;
+            file->index = index;
+            file->fd = openForRead(batch->paths[index], file->size);
+            if (file->fd < 0 || file->size == 0) {
+                file->failed = file->fd < 0;
+                finalize(*file);
+                continue;
+            }
+            file->bytes.resize(file->size);
+            current = file;
+        }
+        return true;
+    }
+
+    void reap() {
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            io_uring_cqe cqe = cqes[head & *cqMask];
+            head++;
+            complete(cqe);
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    void complete(const io_uring_cqe& cqe) {
+        unsigned slot = static_cast<unsigned>(cqe.user_data);
+        Request& request = requests[slot];
+        inFlight--;
+        reader.trackDepth(-1);
+
+        if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+            retrySlots.push_back(slot);
+            return;
+        }
+        if (cqe.res <= 0) {
+            request.file->failed = true;
+        } else if (static_cast<size_t>(cqe.res) < request.buffer.iov_len) {
+            // Short read, ask for the rest
+            request.offset += cqe.res;
+            request.buffer.iov_base = static_cast<unsigned char*>(request.buffer.iov_base) + cqe.res;
+            request.buffer.iov_len -= cqe.res;
+            retrySlots.push_back(slot);
+            return;
+        }
+        release(slot);
+    }
+
+    void release(unsigned slot) {
+        std::shared_ptr<OpenFile> file = std::move(requests[slot].file);
+        freeSlots.push_back(slot);
+
+        // A failed file stops getting new requests, so it is done once the last one is back
+        if (--file->outstanding == 0 && (file->failed || file->issued == file->size)) {
+            finalize(*file);
+        }
+    }
+
+    void finalize(OpenFile& file) {
+        if (file.fd >= 0) ::close(file.fd);
+        if (file.failed) {
+            std::cerr << "Failed to read file: " << file.batch->paths[file.index] << std::endl;
+            file.bytes.clear();
+        }
+        reader.countFile(file.failed ? 0 : file.size, !file.failed);
+
+        FileReader& fileReader = reader;
+        TaskScheduler::shared().spawn([&fileReader, batch = file.batch, index = file.index,
+                                       bytes = std::move(file.bytes), ok = !file.failed]() mutable {
+            fileReader.deliver(batch, index, bytes, ok);
+        }, {}, file.batch.get());
+    }
+
+    FileReader&     reader;
+
+    int             ringFd = -1;
+    unsigned        entries = 0;
+    void*           sqRing = MAP_FAILED;
+    void*           cqRing = MAP_FAILED;
+    size_t          sqRingSize = 0;
+    size_t          cqRingSize = 0;
+    io_uring_sqe*   sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    unsigned*       sqTail = nullptr;
+    unsigned*       sqMask = nullptr;
+    unsigned*       sqArray = nullptr;
+    unsigned*       cqHead = nullptr;
+    unsigned*       cqTail = nullptr;
+    unsigned*       cqMask = nullptr;
+    io_uring_cqe*   cqes = nullptr;
+
+    std::thread                                     thread;
+    std::mutex                                      mutex;
+    std::condition_variable                         wake;
+    bool                                            stopping = false;
+    std::deque<std::pair<FileReadHandle, size_t>>   incoming;
+
+    // Only touched by the thread
+    std::deque<std::pair<FileReadHandle, size_t>>   waiting;
+    std::shared_ptr<OpenFile>                       current;
+    std::vector<Request>                            requests;
+    std::vector<unsigned>                           freeSlots;
+    std::vector<unsigned>                           retrySlots;
+    unsigned                                        inFlight = 0;
+    unsigned                                        unsubmitted = 0;
+};
+
+#else
+
+struct FileReader::Backend {
+};
+
+#endif
+
+FileReader::FileReader(bool useIoUring)
+: lastDepthChange(Clock::now()) {
+    // Callbacks run on the shared scheduler, which has to outlive this
+    TaskScheduler::shared();
+
+#ifdef __linux__
+    if (!useIoUring) return;
+
+    backend = std::make_unique<Backend>(*this);
+    if (!backend->start()) {
+        std::cerr << "io_uring is not available, reading files with pread" << std::endl;
+        backend.reset();
+    }
+#endif
+}
+
+FileReader::~FileReader() {
+}
+
+FileReader& FileReader::shared() {
+    static FileReader reader;
+    return reader;
+}
+
+const char* FileReader::backendName() const {
+    return backend ? "io_uring" : "pread";
+}
+
+FileReadHandle FileReader::readAsync(const std::vector<std::string>& paths, FileReadCallback onRead) {
+    auto batch = std::make_shared<FileReadBatch>();
+    batch->paths = paths;
+    batch->onRead = std::move(onRead);
+
+#ifdef __linux__
+    if (backend) {
+        backend->enqueue(batch);
+        return batch;
+    }
+#endif
+
+    // Without a ring the workers block in pread, one file each
+    for (size_t i = 0; i < batch->paths.size(); i++) {
+        TaskScheduler::shared().spawn([this, batch, i]() {
+            std::vector<unsigned char> bytes;
+            bool ok = read(batch->paths[i], bytes);
+            deliver(batch, i, bytes, ok);
+        }, {}, batch.get());
+    }
+    return batch;
+}
+
+void FileReader::wait(const FileReadHandle& batch) {
+    if (!batch) return;
+    TaskScheduler::shared().waitUntil([&batch]() { return batch->done(); }, batch.get());
+}
+
+void FileReader::readAll(const std::vector<std::string>& paths, FileReadCallback onRead) {
+    wait(readAsync(paths, std::move(onRead)));
+}
+
+bool FileReader::read(const std::string& path, std::vector<unsigned char>& bytes) {
+    size_t size = 0;
+    int fd = openForRead(path, size);
+    if (fd < 0) {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        countFile(0, false);
+        return false;
+    }
+
+    bytes.resize(size);
+    size_t offset = 0;
+    bool ok = true;
+    trackDepth(1);
+    while (offset < size) {
+        ssize_t count = ::pread(fd, bytes.data() + offset, std::min(FILE_READ_CHUNK_BYTES, size - offset), offset);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) {
+            ok = false;
+            break;
+        }
+        offset += static_cast<size_t>(count);
+    }
+    trackDepth(-1);
+    ::close(fd);
+
+    if (!ok) {
+        std::cerr << "Failed to read file: " << path << std::endl;
+        bytes.clear();
+    }
+    countFile(ok ? size : 0, ok);
+    return ok;
+}
+
+void FileReader::deliver(const FileReadHandle& batch, size_t index, std::vector<unsigned char>& bytes, bool ok) {
+    // Runs as a spawned task, which must not throw
+    try {
+        batch->onRead(index, bytes, ok);
+    } catch (const std::exception& e) {
+        std::cerr << "Error processing " << batch->paths[index] << ": " << e.what() << std::endl;
+    }
+    batch->finished++;
+}
+
+void FileReader::trackDepth(int change) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    auto now = Clock::now();
+    if (depth > 0) {
+        double ms = std::chrono::duration<double, std::milli>(now - lastDepthChange).count();
+        stats.busyMs += ms;
+        depthIntegralMs += depth * ms;
+    }
+    lastDepthChange = now;
+    depth += change;
+    stats.maxQueueDepth = std::max(stats.maxQueueDepth, depth);
+}
+
+void FileReader::countFile(size_t bytes, bool ok) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    stats.files++;
+    stats.bytes += bytes;
+    if (!ok) stats.failed++;
+}
+
+FileReadStats FileReader::takeStats() {
+    // Closes the interval that is still open
+    trackDepth(0);
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    FileReadStats result = stats;
+    result.backend = backendName();
+    result.averageQueueDepth = stats.busyMs > 0.0 ? depthIntegralMs / stats.busyMs : 0.0;
+
+    stats = FileReadStats();
+    stats.maxQueueDepth = depth;
+    depthIntegralMs = 0.0;
+    return result;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include <functional>
+#include <mutex>
+
+// Files larger than this are read as several requests, so one big file keeps more than one
+// slot of the device queue busy
+constexpr size_t FILE_READ_CHUNK_BYTES = size_t(1) << 20;
+// Requests the io_uring backend keeps in flight at most
+constexpr unsigned FILE_READ_QUEUE_DEPTH = 64;
+
+// Reads since the last takeStats. Queue depth is the number of read requests in flight,
+// averaged over the time any was.
+struct FileReadStats {
+    const char* backend = "";
+    size_t      files = 0;
+    size_t      failed = 0;
+    size_t      bytes = 0;
+    double      busyMs = 0.0;
+    double      averageQueueDepth = 0.0;
+    size_t      maxQueueDepth = 0;
+
+    double throughputMBps() const { return busyMs > 0.0 ? bytes / (1024.0 * 1024.0) / (busyMs / 1000.0) : 0.0; }
+};
+
+// Called once per file with its contents, on a scheduler task right after the read finished
+using FileReadCallback = std::function<void(size_t index, std::vector<unsigned char>& bytes, bool ok)>;
+
+// One call to FileReader::readAsync
+class FileReadBatch {
+public:
+    // Every callback has returned
+    bool done() const { return finished.load() == paths.size(); }
+
+private:
+    friend class FileReader;
+
+    std::vector<std::string>    paths;
+    FileReadCallback            onRead;
+    std::atomic<size_t>         finished{0};
+};
+
+using FileReadHandle = std::shared_ptr<FileReadBatch>;
+
+// Reads whole files for the loaders. On Linux the reads of a batch are queued on an io_uring
+// from a dedicated thread, so the device sees many requests at once instead of one per
+// loader. Elsewhere, or where the kernel refuses io_uring, every file is read with pread
+// on a scheduler task. Either way each file is handed to its callback on the task scheduler
+// as soon as its own read completes, so decoding overlaps the reads still in flight.
+class FileReader {
+public:
+    // Without useIoUring files are always read with pread, for comparing the two
+    explicit FileReader(bool useIoUring = true);
+    ~FileReader();
+
+    FileReader(const FileReader&) = delete;
+    FileReader& operator=(const FileReader&) = delete;
+
+    static FileReader& shared();
+
+    FileReadHandle readAsync(const std::vector<std::string>& paths, FileReadCallback onRead);
+    // Runs other scheduler tasks while it waits, callbacks of the batch included
+    void wait(const FileReadHandle& batch);
+    void readAll(const std::vector<std::string>& paths, FileReadCallback onRead);
+
+    // Reads on the calling thread, for single files a loader needs before it can go on
+    bool read(const std::string& path, std::vector<unsigned char>& bytes);
+
+    const char* backendName() const;
+    FileReadStats takeStats();
+
+private:
+    // The io_uring thread, only on Linux
+    struct Backend;
+
+    void deliver(const FileReadHandle& batch, size_t index, std::vector<unsigned char>& bytes, bool ok);
+    // Requests that started, or ended when negative
+    void trackDepth(int change);
+    void countFile(size_t bytes, bool ok);
+
+    std::unique_ptr<Backend>    backend;
+
+    std::mutex                  statsMutex;
+    FileReadStats               stats;
+    size_t                      depth = 0;
+    double                      depthIntegralMs = 0.0;
+    std::chrono::steady_clock::time_point lastDepthChange;
+};
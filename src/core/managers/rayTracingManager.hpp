@@ -14,11 +14,18 @@ public:
     void setupAccelerationStructures(const std::vector<Mesh*>& meshes);
     void setupTriangleResources(const std::vector<Mesh*>& meshes);
     
+    // For scene reloads that keep every mesh in place. Indices are into the same meshes
+    // the structures were built from.
+    void refitAccelerationStructures(const std::vector<Mesh*>& meshes, const std::vector<size_t>& movedMeshes);
+    void updateTriangleResources(const std::vector<Mesh*>& meshes, const std::vector<size_t>& changedMeshes);
+    
     MTL::AccelerationStructure* getPrimitiveAccelerationStructure() const;
     MTL::Buffer* getResourceBuffer() const;
     size_t getTotalTriangles() const { return totalTriangles; }
     
 private:
+    void releaseAccelerationStructures();
+    
     MTL::Device* device;
     ResourceManager* resourceManager;
     
@@ -26,4 +33,10 @@ private:
     std::vector<MTL::AccelerationStructure*> primitiveAccelerationStructures;
     MTL::Buffer* resourceBuffer = nullptr;
     size_t totalTriangles = 0;
+    
+    MTL::PrimitiveAccelerationStructureDescriptor*  accelerationStructureDescriptor = nullptr;
+    MTL::Buffer*                                    mergedVertexBuffer = nullptr;
+    MTL::Buffer*                                    mergedIndexBuffer = nullptr;
+    std::vector<size_t>                             meshVertexOffsets;
+    std::vector<size_t>                             meshTriangleOffsets;
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "rayTracingManager.hpp"
+#include "../taskScheduler.hpp"
 
 RayTracingManager::RayTracingManager(MTL::Device* device, ResourceManager* resourceManager)
     : device(device), resourceManager(resourceManager), totalTriangles(0) {
@@ -6,40 +7,108 @@ RayTracingManager::RayTracingManager(MTL::Device* device, ResourceManager* resou
 
 RayTracingManager::~RayTracingManager() {
     // Resources are managed by the ResourceManager, so we don't need to explicitly release them
+    if (accelerationStructureDescriptor) {
+        accelerationStructureDescriptor->release();
+    }
+}
+
+namespace {
+
+struct TriangleData {
+    simd::float4 normals[3];
+    simd::float4 colors[3];
+};
+
+void writeTransformedVertices(const Mesh& mesh, Vertex* destination) {
+    matrix_float4x4 modelMatrix = mesh.getTransformMatrix();
+
+    for (size_t i = 0; i < mesh.vertices.size(); i++) {
+        destination[i] = mesh.vertices[i];
+        destination[i].position = modelMatrix * mesh.vertices[i].position;
+    }
+}
+
+void writeTriangleData(const Mesh& mesh, TriangleData* destination) {
+    simd::float4 meshColor;
+    
+    if (mesh.meshInfo.isEmissive) {
+        meshColor = simd::float4{
+            mesh.meshInfo.emissiveColor.x,
+            mesh.meshInfo.emissiveColor.y,
+            mesh.meshInfo.emissiveColor.z,
+            -1.0f  // Emissive
+        };
+    } else {
+        meshColor = simd::float4{
+            mesh.meshInfo.color.x,
+            mesh.meshInfo.color.y,
+            mesh.meshInfo.color.z,
+            1.0f  // Non-emissive
+        };
+    }
+    
+    size_t triangleIndex = 0;
+    for (size_t i = 0; i < mesh.vertexIndices.size(); i += 3) {
+        TriangleData& triangle = destination[triangleIndex++];
+
+        for (size_t j = 0; j < 3; ++j) {
+            size_t vertexIndex = mesh.vertexIndices[i + j];
+            triangle.normals[j] = mesh.vertices[vertexIndex].normal;
+            triangle.colors[j] = meshColor;
+        }
+    }
+}
+
 }
 
 void RayTracingManager::setupAccelerationStructures(const std::vector<Mesh*>& meshes) {
+    // Rebuilding after a scene reload replaces everything from the previous build
+    releaseAccelerationStructures();
+    
     // Create a separate command queue for acceleration structure building
     MTL::CommandQueue* commandQueue = device->newCommandQueue();
     MTL::CommandBuffer* commandBuffer = commandQueue->commandBuffer();
 
-    std::vector<Vertex> mergedVertices;
-    std::vector<uint32_t> mergedIndices;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (const auto& mesh : meshes) {
+        vertexCount += mesh->vertices.size();
+        indexCount += mesh->vertexIndices.size();
+    }
+
+    std::vector<Vertex> mergedVertices(vertexCount);
+    std::vector<uint32_t> mergedIndices(indexCount);
 
     size_t vertexOffset = 0;
+    size_t indexOffset = 0;
+    std::vector<size_t> meshIndexOffsets;
     totalTriangles = 0;
+    meshVertexOffsets.clear();
     
     // One acceleration structure for all the meshes. In a dynamic scene, you might want to create one per mesh or group of meshes.
     for (const auto& mesh : meshes) {
-        matrix_float4x4 modelMatrix = mesh->getTransformMatrix();
-
-        for (const auto& vertex : mesh->vertices) {
-            Vertex transformedVertex = vertex;
-            transformedVertex.position = modelMatrix * vertex.position;
-            mergedVertices.push_back(transformedVertex);
-        }
-
-        for (size_t index : mesh->vertexIndices) {
-            mergedIndices.push_back(static_cast<uint32_t>(index + vertexOffset));
-        }
-
+        meshVertexOffsets.push_back(vertexOffset);
+        meshIndexOffsets.push_back(indexOffset);
         vertexOffset += mesh->vertices.size();
+        indexOffset += mesh->vertexIndices.size();
         totalTriangles += mesh->triangleCount;
     }
     
-    // Use ResourceManager to create vertex and index buffers
+    // Every mesh fills its own range of the merged arrays
+    TaskScheduler::shared().parallelFor(meshes.size(), [&](size_t m) {
+        const Mesh& mesh = *meshes[m];
+        writeTransformedVertices(mesh, mergedVertices.data() + meshVertexOffsets[m]);
+
+        uint32_t* indices = mergedIndices.data() + meshIndexOffsets[m];
+        for (size_t i = 0; i < mesh.vertexIndices.size(); i++) {
+            indices[i] = static_cast<uint32_t>(mesh.vertexIndices[i] + meshVertexOffsets[m]);
+        }
+    });
+    
+    // Use ResourceManager to create vertex and index buffers. The vertex buffer stays around
+    // so moved meshes can be rewritten in place and refit.
     size_t vertexBufferSize = mergedVertices.size() * sizeof(Vertex);
-    MTL::Buffer* mergedVertexBuffer = resourceManager->createBuffer(
+    mergedVertexBuffer = resourceManager->createBuffer(
         vertexBufferSize, 
         mergedVertices.data(), 
         MTL::ResourceStorageModeShared, 
@@ -47,7 +116,7 @@ void RayTracingManager::setupAccelerationStructures(const std::vector<Mesh*>& me
     );
 
     size_t indexBufferSize = mergedIndices.size() * sizeof(uint32_t);
-    MTL::Buffer* mergedIndexBuffer = resourceManager->createBuffer(
+    mergedIndexBuffer = resourceManager->createBuffer(
         indexBufferSize, 
         mergedIndices.data(), 
         MTL::ResourceStorageModeShared, 
@@ -67,10 +136,11 @@ void RayTracingManager::setupAccelerationStructures(const std::vector<Mesh*>& me
 
     NS::Array* geometryDescriptors = NS::Array::array(geometryDescriptor);
 
-    // Set the triangle geometry descriptors in the acceleration structure descriptor
-    MTL::PrimitiveAccelerationStructureDescriptor* accelerationStructureDescriptor = 
-        MTL::PrimitiveAccelerationStructureDescriptor::alloc()->init();
+    // Set the triangle geometry descriptors in the acceleration structure descriptor.
+    // Kept for refits, which have to use the descriptor the structure was built with.
+    accelerationStructureDescriptor = MTL::PrimitiveAccelerationStructureDescriptor::alloc()->init();
     accelerationStructureDescriptor->setGeometryDescriptors(geometryDescriptors);
+    accelerationStructureDescriptor->setUsage(MTL::AccelerationStructureUsageRefit);
 
     // Get acceleration structure sizes
     MTL::AccelerationStructureSizes sizes = device->accelerationStructureSizes(accelerationStructureDescriptor);
@@ -102,8 +172,6 @@ void RayTracingManager::setupAccelerationStructures(const std::vector<Mesh*>& me
     primitiveAccelerationStructures.push_back(accelerationStructure);
 
     geometryDescriptor->release();
-    geometryDescriptors->release();
-    accelerationStructureDescriptor->release();
     
     // Let ResourceManager handle the release
     resourceManager->releaseResource(scratchBuffer);
@@ -112,11 +180,59 @@ void RayTracingManager::setupAccelerationStructures(const std::vector<Mesh*>& me
     commandQueue->release();
 }
 
+void RayTracingManager::refitAccelerationStructures(const std::vector<Mesh*>& meshes, const std::vector<size_t>& movedMeshes) {
+    assert(meshes.size() == meshVertexOffsets.size() && "Refit needs the meshes the structure was built from");
+    if (movedMeshes.empty() || primitiveAccelerationStructures.empty()) return;
+
+    // Shared storage, the new positions are visible to the GPU without a blit
+    Vertex* mergedVertices = static_cast<Vertex*>(mergedVertexBuffer->contents());
+    TaskScheduler::shared().parallelFor(movedMeshes.size(), [&](size_t i) {
+        size_t meshIndex = movedMeshes[i];
+        writeTransformedVertices(*meshes[meshIndex], mergedVertices + meshVertexOffsets[meshIndex]);
+    });
+
+    MTL::AccelerationStructureSizes sizes = device->accelerationStructureSizes(accelerationStructureDescriptor);
+    MTL::Buffer* scratchBuffer = resourceManager->createBuffer(
+        std::max<size_t>(sizes.refitScratchBufferSize, 1),
+        nullptr,
+        MTL::ResourceStorageModePrivate,
+        "refitScratchBuffer"
+    );
+
+    MTL::CommandQueue* commandQueue = device->newCommandQueue();
+    MTL::CommandBuffer* commandBuffer = commandQueue->commandBuffer();
+
+    // A null destination refits in place
+    MTL::AccelerationStructureCommandEncoder* commandEncoder = commandBuffer->accelerationStructureCommandEncoder();
+    commandEncoder->refitAccelerationStructure(primitiveAccelerationStructures[0], accelerationStructureDescriptor, nullptr, scratchBuffer, 0);
+    commandEncoder->endEncoding();
+
+    commandBuffer->commit();
+    commandBuffer->waitUntilCompleted();
+
+    resourceManager->releaseResource(scratchBuffer);
+    commandQueue->release();
+}
+
+void RayTracingManager::releaseAccelerationStructures() {
+    for (MTL::AccelerationStructure* accelerationStructure : primitiveAccelerationStructures) {
+        resourceManager->releaseResource(accelerationStructure);
+    }
+    primitiveAccelerationStructures.clear();
+    
+    resourceManager->releaseResource(mergedVertexBuffer);
+    resourceManager->releaseResource(mergedIndexBuffer);
+    mergedVertexBuffer = nullptr;
+    mergedIndexBuffer = nullptr;
+    
+    if (accelerationStructureDescriptor) {
+        accelerationStructureDescriptor->release();
+        accelerationStructureDescriptor = nullptr;
+    }
+}
+
 void RayTracingManager::setupTriangleResources(const std::vector<Mesh*>& meshes) {
-    struct TriangleData {
-        simd::float4 normals[3];
-        simd::float4 colors[3];
-    };
+    resourceManager->releaseResource(resourceBuffer);
     
     size_t resourceStride = sizeof(TriangleData);
     size_t bufferLength = resourceStride * totalTriangles;
@@ -130,36 +246,26 @@ void RayTracingManager::setupTriangleResources(const std::vector<Mesh*>& meshes)
 
     TriangleData* resourceBufferContents = (TriangleData*)((uint8_t*)(resourceBuffer->contents()));
     size_t triangleIndex = 0;
+    meshTriangleOffsets.clear();
 
     for (int m = 0; m < meshes.size(); m++) {
-        simd::float4 meshColor;
-        
-        if (meshes[m]->meshInfo.isEmissive) {
-            meshColor = simd::float4{
-                meshes[m]->meshInfo.emissiveColor.x,
-                meshes[m]->meshInfo.emissiveColor.y,
-                meshes[m]->meshInfo.emissiveColor.z,
-                -1.0f  // Emissive
-            };
-        } else {
-            meshColor = simd::float4{
-                meshes[m]->meshInfo.color.x,
-                meshes[m]->meshInfo.color.y,
-                meshes[m]->meshInfo.color.z,
-                1.0f  // Non-emissive
-            };
-        }
-        
-        for (size_t i = 0; i < meshes[m]->vertexIndices.size(); i += 3) {
-            TriangleData& triangle = resourceBufferContents[triangleIndex++];
-
-            for (size_t j = 0; j < 3; ++j) {
-                size_t vertexIndex = meshes[m]->vertexIndices[i + j];
-                triangle.normals[j] = meshes[m]->vertices[vertexIndex].normal;
-                triangle.colors[j] = meshColor;
-            }
-        }
+        meshTriangleOffsets.push_back(triangleIndex);
+        triangleIndex += meshes[m]->vertexIndices.size() / 3;
     }
+    
+    TaskScheduler::shared().parallelFor(meshes.size(), [&](size_t m) {
+        writeTriangleData(*meshes[m], resourceBufferContents + meshTriangleOffsets[m]);
+    });
+}
+
+void RayTracingManager::updateTriangleResources(const std::vector<Mesh*>& meshes, const std::vector<size_t>& changedMeshes) {
+    assert(meshes.size() == meshTriangleOffsets.size() && "Update needs the meshes the resources were built from");
+    
+    TriangleData* resourceBufferContents = (TriangleData*)((uint8_t*)(resourceBuffer->contents()));
+    TaskScheduler::shared().parallelFor(changedMeshes.size(), [&](size_t i) {
+        size_t meshIndex = changedMeshes[i];
+        writeTriangleData(*meshes[meshIndex], resourceBufferContents + meshTriangleOffsets[meshIndex]);
+    });
 }
 
 MTL::AccelerationStructure* RayTracingManager::getPrimitiveAccelerationStructure() const {
@@ -9,12 +9,7 @@
 #include "../debug/debug.hpp"
 #include "../editor/editor.hpp"
 #include "../../data/shaders/shaderTypes.hpp"
-
-// You can try different max cascade levels
-constexpr int MAX_CASCADE_LEVEL = 6;
-// You can't put any value of probe spacing and base ray
-constexpr int PROBE_SPACING = 4;
-constexpr int BASE_RAY = 16;
+#include "../cascadeConfig.hpp"
 
 class RenderPassManager {
 public:
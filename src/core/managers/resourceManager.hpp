@@ -2,6 +2,7 @@
 
 #include "../pch.hpp"
 #include <Metal/Metal.hpp>
+#include <mutex>
 #include "../vertexData.hpp"
 #include "resourceNames.hpp"
 
@@ -48,6 +49,11 @@ public:
     void releaseTexture(MTL::Texture*& texture);
 private:
     MTL::Device* device;
+    
+    // Resources are created from startup tasks as well, the bookkeeping below is shared.
+    // Recursive since e.g. createTexture looks up and releases the texture it replaces.
+    mutable std::recursive_mutex mutex;
+    
     std::vector<MTL::Resource*> managedResources;
     
     // Keep track of resources already in the managed list
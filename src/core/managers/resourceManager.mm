@@ -18,6 +18,7 @@ MTL::Buffer* ResourceManager::createBuffer(size_t size, const void* initialData,
         buffer = device->newBuffer(size, options);
     }
     
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     if (buffer && label) {
         buffer->setLabel(NS::String::string(label, NS::ASCIIStringEncoding));
         registerResource(buffer, label);
@@ -40,6 +41,7 @@ MTL::Buffer* ResourceManager::createBuffer(size_t size, const void* initialData,
 
 void ResourceManager::createTexture(const MTL::TextureDescriptor* descriptor, TextureName name) {
     std::string textureLabel = ResourceNames::toString(name);
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     
     // Check if a texture with this name already exists
     if (hasTexture(name)) {
@@ -127,6 +129,7 @@ MTL::AccelerationStructure* ResourceManager::createAccelerationStructure(
     
     MTL::AccelerationStructure* accelStructure = device->newAccelerationStructure(size);
     
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     if (accelStructure && label) {
         accelStructure->setLabel(NS::String::string(label, NS::ASCIIStringEncoding));
         registerResource(accelStructure, label);
@@ -142,6 +145,7 @@ MTL::AccelerationStructure* ResourceManager::createAccelerationStructure(
 
 void ResourceManager::registerResource(MTL::Resource* resource, const std::string& name) {
     if (!resource || name.empty()) return;
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     
     // Check if a resource with this name already exists
     auto it = resourceRegistry.find(name);
@@ -163,6 +167,7 @@ void ResourceManager::registerResource(MTL::Resource* resource, BufferName name)
 }
 
 void ResourceManager::unregisterResource(const std::string& name) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     resourceRegistry.erase(name);
 }
 
@@ -199,6 +204,7 @@ MTL::Buffer* ResourceManager::getBufferByName(const std::string& name) const {
 }
 
 MTL::Resource* ResourceManager::getResourceByName(const std::string& name) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     auto it = resourceRegistry.find(name);
     if (it != resourceRegistry.end()) {
         return it->second;
@@ -216,6 +222,7 @@ MTL::Buffer* ResourceManager::getBuffer(BufferName name) const {
 
 void ResourceManager::releaseResource(MTL::Resource* resource) {
     if (!resource) return;
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     
     // Remove from managed resources list
     auto it = std::find(managedResources.begin(), managedResources.end(), resource);
@@ -244,6 +251,7 @@ void ResourceManager::releaseTexture(MTL::Texture*& texture) {
 }
 
 void ResourceManager::releaseAllResources() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     managedResources.clear();
     resourceTracker.clear();
     resourceRegistry.clear();
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "pch.hpp"
+
+// Queue with any number of producers and a single consumer that never takes a lock.
+// Producers push onto a list with one compare and swap, the consumer takes the whole list
+// with one exchange and hands the values out in the order they were pushed. Taking
+// everything at once means nodes are never popped while someone else pushes, so there
+// is no ABA problem to worry about.
+template<typename T>
+class MpscQueue {
+public:
+    MpscQueue() = default;
+    ~MpscQueue() { drain([](T&&) {}); }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node{std::move(value), head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Consumer only. Calls consume for every value pushed so far and returns their count.
+    template<typename Consume>
+    size_t drain(Consume&& consume) {
+        Node* node = head.exchange(nullptr, std::memory_order_acquire);
+
+        // The list is newest first
+        Node* ordered = nullptr;
+        while (node) {
+            Node* next = node->next;
+            node->next = ordered;
+            ordered = node;
+            node = next;
+        }
+
+        size_t count = 0;
+        while (ordered) {
+            Node* next = ordered->next;
+            consume(std::move(ordered->value));
+            delete ordered;
+            ordered = next;
+            count++;
+        }
+        return count;
+    }
+
+    bool empty() const { return head.load(std::memory_order_acquire) == nullptr; }
+
+private:
+    struct Node {
+        T       value;
+        Node*   next;
+    };
+
+    std::atomic<Node*> head{nullptr};
+};
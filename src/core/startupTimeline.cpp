@@ -0,0 +1,60 @@
+#include "startupTimeline.hpp"
+#include "taskScheduler.hpp"
+
+#include <cstdio>
+
+namespace {
+
+constexpr int TIMELINE_BAR_WIDTH = 48;
+
+}
+
+StartupTimeline::StartupTimeline()
+: origin(Clock::now()) {
+}
+
+double StartupTimeline::elapsedMs() const {
+    return std::chrono::duration<double, std::milli>(Clock::now() - origin).count();
+}
+
+void StartupTimeline::measure(const std::string& name, const std::function<void()>& body) {
+    double startMs = elapsedMs();
+    body();
+    double endMs = elapsedMs();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stages.push_back({name, TaskScheduler::shared().currentWorker(), startMs, endMs});
+}
+
+void StartupTimeline::print(std::ostream& out) const {
+    std::vector<Stage> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sorted = stages;
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Stage& a, const Stage& b) { return a.startMs < b.startMs; });
+
+    double totalMs = 0.0;
+    for (const Stage& stage : sorted) {
+        totalMs = std::max(totalMs, stage.endMs);
+    }
+    double msPerColumn = std::max(totalMs, 1e-3) / TIMELINE_BAR_WIDTH;
+
+    char header[160];
+    std::snprintf(header, sizeof(header), "  %-22s %8s %8s %8s  %-9s", "Startup stage", "start", "end", "ms", "thread");
+    out << header << std::endl;
+    for (const Stage& stage : sorted) {
+        std::string thread = stage.worker < 0 ? "main" : "worker " + std::to_string(stage.worker);
+
+        int first = std::min(TIMELINE_BAR_WIDTH - 1, static_cast<int>(stage.startMs / msPerColumn));
+        int last = std::max(first, std::min(TIMELINE_BAR_WIDTH - 1, static_cast<int>(stage.endMs / msPerColumn)));
+        std::string bar(TIMELINE_BAR_WIDTH, ' ');
+        std::fill(bar.begin() + first, bar.begin() + last + 1, '#');
+
+        char row[160];
+        std::snprintf(row, sizeof(row), "  %-22s %8.1f %8.1f %8.1f  %-9s |%s|",
+                      stage.name.c_str(), stage.startMs, stage.endMs, stage.endMs - stage.startMs,
+                      thread.c_str(), bar.c_str());
+        out << row << std::endl;
+    }
+}
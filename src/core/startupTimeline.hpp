@@ -0,0 +1,34 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include <functional>
+#include <mutex>
+#include <ostream>
+
+// Records when each startup stage ran and on which thread, relative to the moment the
+// timeline was created. Stages may be measured from any thread.
+class StartupTimeline {
+public:
+    StartupTimeline();
+
+    void measure(const std::string& name, const std::function<void()>& body);
+    double elapsedMs() const;
+
+    // One row per stage in start order, with a bar showing where it sits in the whole startup
+    void print(std::ostream& out) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stage {
+        std::string name;
+        int         worker;     // Scheduler worker, -1 for any other thread
+        double      startMs;
+        double      endMs;
+    };
+
+    Clock::time_point   origin;
+    mutable std::mutex  mutex;
+    std::vector<Stage>  stages;
+};
@@ -0,0 +1,318 @@
+#include "taskScheduler.hpp"
+
+namespace {
+
+// Lets push and pop find the deque of the calling worker
+thread_local const TaskScheduler*   currentScheduler = nullptr;
+thread_local size_t                 currentIndex = 0;
+// Tasks running on the calling thread's stack, nested ones included
+thread_local int                    runningTasks = 0;
+
+// How long waitUntil sleeps at most before checking its condition again
+constexpr std::chrono::milliseconds WAIT_RECHECK_INTERVAL{1};
+
+}
+
+TaskScheduler::TaskScheduler(size_t threadCount) {
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    // Started once every deque exists, since workers steal from each other right away
+    for (size_t i = 0; i < threadCount; i++) {
+        workers[i]->thread = std::thread(&TaskScheduler::workerLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+
+    for (std::unique_ptr<Worker>& worker : workers) {
+        // A task that calls exit() destroys the shared scheduler from one of its workers
+        if (worker->thread.get_id() == std::this_thread::get_id()) {
+            worker->thread.detach();
+        } else {
+            worker->thread.join();
+        }
+    }
+}
+
+TaskScheduler& TaskScheduler::shared() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+size_t TaskScheduler::defaultThreadCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+int TaskScheduler::currentWorker() const {
+    return currentScheduler == this ? static_cast<int>(currentIndex) : -1;
+}
+
+TaskHandle TaskScheduler::spawn(std::function<void()> work, const std::vector<TaskHandle>& dependencies, TaskGroup group) {
+    TaskHandle task = std::make_shared<Task>();
+    task->work = std::move(work);
+    task->group = group;
+
+    for (const TaskHandle& dependency : dependencies) {
+        if (!dependency) continue;
+
+        // run() marks a task finished under the same lock it takes the dependents with, so a
+        // dependency that is not finished here is guaranteed to release this task later
+        std::lock_guard<std::mutex> lock(dependency->dependentsMutex);
+        if (!dependency->done()) {
+            task->blockers++;
+            dependency->dependents.push_back(task);
+        }
+    }
+
+    if (--task->blockers == 0) {
+        push(task);
+    }
+    return task;
+}
+
+std::future<void> TaskScheduler::submit(std::function<void()> work) {
+    auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(work));
+    std::future<void> future = packaged->get_future();
+    spawn([packaged]() { (*packaged)(); });
+    return future;
+}
+
+void TaskScheduler::wait(const TaskHandle& task) {
+    if (!task) return;
+    waitUntil([&task]() { return task->done(); }, task.get());
+}
+
+void TaskScheduler::wait(const std::vector<TaskHandle>& tasks) {
+    for (const TaskHandle& task : tasks) {
+        wait(task);
+    }
+}
+
+void TaskScheduler::waitUntil(const std::function<bool()>& condition, TaskGroup group) {
+    const bool insideTask = runningTasks > 0;
+    while (true) {
+        // Read before the condition, so a task finishing in between ends the sleep below
+        uint64_t seenCompletions = completions.load();
+        if (condition()) return;
+        if (!insideTask) {
+            if (runOne()) continue;
+        } else if (group) {
+            if (TaskHandle task = popGroup(group)) {
+                run(task);
+                continue;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        waiters++;
+        progress.wait_for(lock, WAIT_RECHECK_INTERVAL, [this, seenCompletions]() {
+            return completions.load() != seenCompletions || queuedTasks.load() > 0;
+        });
+        waiters--;
+    }
+}
+
+void TaskScheduler::parallelFor(size_t count, const std::function<void(size_t)>& body, size_t grain) {
+    parallelForRange(count, grain, [&body](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            body(i);
+        }
+    });
+}
+
+void TaskScheduler::parallelForRange(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+
+    grain = std::max<size_t>(grain, 1);
+    size_t chunks = (count + grain - 1) / grain;
+    if (chunks == 1) {
+        body(0, count);
+        return;
+    }
+
+    // Helpers may start after the caller already drained everything, so they only
+    // hold on to shared state and never to the caller's stack
+    struct Range {
+        std::atomic<size_t>     next{0};
+        std::atomic<size_t>     done{0};
+        size_t                  count;
+        size_t                  chunks;
+        size_t                  grain;
+        std::function<void(size_t, size_t)> body;
+        std::mutex              errorMutex;
+        std::exception_ptr      error;
+    };
+    auto range = std::make_shared<Range>();
+    range->count = count;
+    range->chunks = chunks;
+    range->grain = grain;
+    range->body = body;
+
+    auto drain = [](Range& r) {
+        size_t chunk;
+        while ((chunk = r.next.fetch_add(1)) < r.chunks) {
+            size_t begin = chunk * r.grain;
+            try {
+                r.body(begin, std::min(r.count, begin + r.grain));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(r.errorMutex);
+                if (!r.error) r.error = std::current_exception();
+            }
+            r.done.fetch_add(1);
+        }
+    };
+
+    size_t helpers = std::min(chunks - 1, workers.size());
+    for (size_t i = 0; i < helpers; i++) {
+        spawn([range, drain]() { drain(*range); }, {}, range.get());
+    }
+
+    drain(*range);
+    waitUntil([&range]() { return range->done.load() == range->chunks; }, range.get());
+
+    if (range->error) {
+        std::rethrow_exception(range->error);
+    }
+}
+
+void TaskScheduler::push(TaskHandle task) {
+    if (currentScheduler == this) {
+        Worker& worker = *workers[currentIndex];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        injected.push_back(std::move(task));
+    }
+    queuedTasks++;
+    notify(true, true);
+}
+
+TaskHandle TaskScheduler::pop() {
+    if (queuedTasks.load() == 0) return nullptr;
+
+    size_t first = 0;
+    if (currentScheduler == this) {
+        Worker& worker = *workers[currentIndex];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.tasks.empty()) {
+            TaskHandle task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            queuedTasks--;
+            return task;
+        }
+        first = currentIndex + 1;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        if (!injected.empty()) {
+            TaskHandle task = std::move(injected.front());
+            injected.pop_front();
+            queuedTasks--;
+            return task;
+        }
+    }
+
+    // Steal the oldest task, starting next to our own deque so thieves spread out
+    for (size_t i = 0; i < workers.size(); i++) {
+        Worker& victim = *workers[(first + i) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            TaskHandle task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queuedTasks--;
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
+TaskHandle TaskScheduler::popGroup(TaskGroup group) {
+    if (queuedTasks.load() == 0) return nullptr;
+
+    auto take = [this, group](std::deque<TaskHandle>& tasks) -> TaskHandle {
+        for (auto it = tasks.begin(); it != tasks.end(); ++it) {
+            if ((*it)->group == group || it->get() == group) {
+                TaskHandle task = std::move(*it);
+                tasks.erase(it);
+                queuedTasks--;
+                return task;
+            }
+        }
+        return nullptr;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        if (TaskHandle task = take(injected)) return task;
+    }
+    for (const std::unique_ptr<Worker>& worker : workers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if (TaskHandle task = take(worker->tasks)) return task;
+    }
+    return nullptr;
+}
+
+bool TaskScheduler::runOne() {
+    TaskHandle task = pop();
+    if (!task) return false;
+    run(task);
+    return true;
+}
+
+void TaskScheduler::run(const TaskHandle& task) {
+    runningTasks++;
+    task->work();
+    runningTasks--;
+    task->work = nullptr;
+
+    std::vector<TaskHandle> released;
+    {
+        std::lock_guard<std::mutex> lock(task->dependentsMutex);
+        task->finished.store(true, std::memory_order_release);
+        released.swap(task->dependents);
+    }
+    for (TaskHandle& dependent : released) {
+        if (--dependent->blockers == 0) {
+            push(std::move(dependent));
+        }
+    }
+
+    completions++;
+    notify(false, true);
+}
+
+void TaskScheduler::notify(bool newTask, bool progressMade) {
+    // Sleepers register before checking their condition under the lock, so a change made
+    // before this check is either seen by them or finds them registered here
+    bool wakeWorker = newTask && sleepers.load() > 0;
+    bool wakeWaiters = progressMade && waiters.load() > 0;
+    if (!wakeWorker && !wakeWaiters) return;
+
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    if (wakeWorker) wakeUp.notify_one();
+    if (wakeWaiters) progress.notify_all();
+}
+
+void TaskScheduler::workerLoop(size_t index) {
+    currentScheduler = this;
+    currentIndex = index;
+
+    while (true) {
+        if (runOne()) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepers++;
+        wakeUp.wait(lock, [this]() { return stopping.load() || queuedTasks.load() > 0; });
+        sleepers--;
+        if (stopping.load() && queuedTasks.load() == 0) return;
+    }
+}
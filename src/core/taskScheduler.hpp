@@ -0,0 +1,152 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+// Tag that ties tasks to the work that waits for them, usually the address of the batch or
+// range they belong to. Waits inside a task only help with tasks of their own group.
+using TaskGroup = const void*;
+
+// Unit of work for the TaskScheduler. Handles keep a task alive so it can be waited on
+// and used as a dependency of tasks spawned later, also after it has finished.
+class Task {
+public:
+    bool done() const { return finished.load(std::memory_order_acquire); }
+
+private:
+    friend class TaskScheduler;
+
+    std::function<void()>               work;
+    TaskGroup                           group = nullptr;
+    // Unfinished dependencies, plus one held by spawn until all of them are registered
+    std::atomic<uint32_t>               blockers{1};
+    std::atomic<bool>                   finished{false};
+    std::mutex                          dependentsMutex;
+    std::vector<std::shared_ptr<Task>>  dependents;
+};
+
+using TaskHandle = std::shared_ptr<Task>;
+
+// Work stealing scheduler shared by the loaders and the CPU side of the frame.
+//
+// Every worker owns a deque. It pushes and pops its own tasks at the back, so nested work
+// stays hot in its cache, and idle workers steal the oldest task from the front of another
+// deque. Tasks spawned from other threads go through a shared queue. Threads that wait on
+// the scheduler run pending tasks instead of blocking, so waiting inside a task is safe.
+// Inside a task the wait only runs tasks of the group it waits for: an unrelated task
+// picked up there would sit on top of the waiting one, and if it blocks on something the
+// waiting task is about to provide, such as a TextureRegistry slot, neither can go on.
+//
+// Spawned tasks must not throw, use submit to get exceptions back through a future.
+// parallelFor and parallelReduce rethrow the first exception of their body in the caller.
+class TaskScheduler {
+public:
+    explicit TaskScheduler(size_t threadCount = defaultThreadCount());
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    static TaskScheduler& shared();
+    static size_t defaultThreadCount();
+
+    // Runs once every dependency has finished
+    TaskHandle spawn(std::function<void()> work, const std::vector<TaskHandle>& dependencies = {}, TaskGroup group = nullptr);
+    // For results that are picked up by code outside the scheduler
+    std::future<void> submit(std::function<void()> work);
+
+    // Inside a task this may run the awaited task itself, but nothing else
+    void wait(const TaskHandle& task);
+    void wait(const std::vector<TaskHandle>& tasks);
+    // Runs tasks until the condition holds: any task when called outside of a task, only
+    // those spawned with `group` inside one. The condition is checked again whenever a task
+    // finishes, and at least once a millisecond for state changed outside the scheduler.
+    void waitUntil(const std::function<bool()>& condition, TaskGroup group = nullptr);
+
+    // Splits [0, count) into chunks of grain indices. The caller works on the chunks as well
+    // and waits like waitUntil until the last one is done, so these nest freely.
+    void parallelFor(size_t count, const std::function<void(size_t)>& body, size_t grain = 1);
+    void parallelForRange(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body);
+
+    // map(begin, end) reduces one chunk, combine(a, b) joins two results. The partial results
+    // are combined in chunk order, so the result does not depend on the thread count.
+    template<typename T, typename Map, typename Combine>
+    T parallelReduce(size_t count, size_t grain, T identity, const Map& map, const Combine& combine);
+
+    // co_await schedule() continues the coroutine as a task on one of the workers
+    auto schedule() {
+        struct Awaiter {
+            TaskScheduler& scheduler;
+            bool await_ready() const noexcept { return false; }
+            // The coroutine may already run, and finish, on a worker before spawn returns
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.spawn([handle]() { handle.resume(); }); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this};
+    }
+
+    size_t threadCount() const { return workers.size(); }
+    // Index of the calling thread among the workers, -1 if it is not one of them
+    int currentWorker() const;
+
+private:
+    struct Worker {
+        std::thread             thread;
+        std::mutex              mutex;
+        std::deque<TaskHandle>  tasks;
+    };
+
+    void workerLoop(size_t index);
+    void push(TaskHandle task);
+    TaskHandle pop();
+    // Takes a queued task of the group, or the task `group` points to, wherever it is queued
+    TaskHandle popGroup(TaskGroup group);
+    bool runOne();
+    void run(const TaskHandle& task);
+    void notify(bool newTask, bool progressMade);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex              injectedMutex;
+    std::deque<TaskHandle>  injected;
+
+    // Tasks sitting in any of the queues
+    std::atomic<size_t>     queuedTasks{0};
+    // Bumped whenever a task finishes, wakes threads in waitUntil
+    std::atomic<uint64_t>   completions{0};
+
+    // Idle workers sleep on wakeUp until there is a task, threads in waitUntil on progress
+    // until there is a task or one finished
+    std::mutex              sleepMutex;
+    std::condition_variable wakeUp;
+    std::condition_variable progress;
+    std::atomic<size_t>     sleepers{0};
+    std::atomic<size_t>     waiters{0};
+    std::atomic<bool>       stopping{false};
+};
+
+template<typename T, typename Map, typename Combine>
+T TaskScheduler::parallelReduce(size_t count, size_t grain, T identity, const Map& map, const Combine& combine) {
+    if (count == 0) return identity;
+
+    grain = std::max<size_t>(grain, 1);
+    size_t chunks = (count + grain - 1) / grain;
+    std::vector<T> partials(chunks, identity);
+
+    parallelForRange(count, grain, [&](size_t begin, size_t end) {
+        partials[begin / grain] = map(begin, end);
+    });
+
+    T result = identity;
+    for (const T& partial : partials) {
+        result = combine(result, partial);
+    }
+    return result;
+}
@@ -13,9 +13,16 @@ struct Vertex {
 	int32_t normalTextureIndex;
 };
 
+// Where a texture lives inside its atlas page. The shader maps the wrapped mesh UV
+// with atlasUV = uvOffset + fract(uv) * uvScale and samples the page in `layer`.
 struct TextureInfo {
+    simd::float2 uvScale;
+    simd::float2 uvOffset;
+    int layer;
     int width;
     int height;
+    // Entries in the info buffer, the same in each of them, for the shader's bounds check
+    int count;
 };
 
 struct VertexData {
@@ -1,4 +1,11 @@
 #include "debug.hpp"
+#include "../core/taskScheduler.hpp"
+
+namespace {
+
+constexpr size_t SPHERES_PER_TASK = 64;
+
+}
 
 Debug::Debug(MTL::Device* device) : metalDevice(device) {}
 
@@ -97,17 +104,24 @@ void Debug::drawSpheres(const std::vector<simd::float4>& spherePositions, float
     DebugLineVertex* lineVertices = reinterpret_cast<DebugLineVertex*>(lineBuffer->contents());
     uint32_t* lineCount = reinterpret_cast<uint32_t*>(lineCountBuffer->contents());
 
-    size_t lineIndex = currentLineCount;
-    for (const auto& position : spherePositions) {
-        if (position.w == -1.0)
-            color = float3{1.0, 0.0, 0.0}; // min probes
-        else
-            color = float3{0.0, 0.0, 1.0}; // max probes
-        
-        addSphereLines(position.xyz, radius, color, slices, stack, lineVertices, lineIndex);
+    // Every sphere has the same number of lines, so each one can write its own range
+    size_t linesPerSphere = size_t(slices) * stack * 4;
+    auto sphereColor = [](const simd::float4& position) {
+        return position.w == -1.0 ? float3{1.0, 0.0, 0.0}  // min probes
+                                  : float3{0.0, 0.0, 1.0}; // max probes
+    };
+    
+    size_t firstLine = currentLineCount;
+    TaskScheduler::shared().parallelFor(spherePositions.size(), [&](size_t i) {
+        size_t lineIndex = firstLine + i * linesPerSphere;
+        addSphereLines(spherePositions[i].xyz, radius, sphereColor(spherePositions[i]), slices, stack, lineVertices, lineIndex);
+    }, SPHERES_PER_TASK);
+    
+    if (!spherePositions.empty()) {
+        color = sphereColor(spherePositions.back());
     }
 
-    currentLineCount = lineIndex;
+    currentLineCount = firstLine + spherePositions.size() * linesPerSphere;
     *lineCount = static_cast<uint32_t>(currentLineCount);
 }
 
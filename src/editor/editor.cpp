@@ -98,6 +98,32 @@ void Editor::debugWindow() {
     
     ImGui::PopItemWidth();
     
+    if (ImGui::CollapsingHeader("Texture Streaming", !ImGuiTreeNodeFlags_DefaultOpen)) {
+        const TextureStreamingStats& stats = textureStreaming;
+        const float MB = 1024.0f * 1024.0f;
+        
+        ImGui::SliderInt("Budget (MB)", &debug.textureBudgetMB, 16, 4096);
+        ImGui::Text("Streamed: %.1f / %.1f MB", stats.streamedBytes / MB, stats.budgetBytes / MB);
+        ImGui::Text("Base mips: %.1f MB", stats.baseBytes / MB);
+        ImGui::Text("Pending: %.1f MB in %d loads", stats.pendingBytes / MB, stats.loadsInFlight);
+        ImGui::Text("Bandwidth: %.1f MB/s", stats.bandwidthMBps);
+        ImGui::Text("Uploaded: %.1f MB total", stats.totalUploadedBytes / MB);
+        ImGui::Text("At target: %d / %d atlases", stats.atlasesAtTarget, stats.atlasCount);
+        ImGui::Text("Evictions: %d", stats.evictions);
+    }
+    
+    if (ImGui::CollapsingHeader("Asset Streaming", !ImGuiTreeNodeFlags_DefaultOpen)) {
+        const AssetStreamingStats& stats = assetStreaming;
+        
+        ImGui::Text("Queued: %d visible, %d prefetch, %d background",
+                    stats.queued[static_cast<int>(AssetPriority::Visible)],
+                    stats.queued[static_cast<int>(AssetPriority::Prefetch)],
+                    stats.queued[static_cast<int>(AssetPriority::Background)]);
+        ImGui::Text("Loading: %d", stats.loadsInFlight);
+        ImGui::Text("Completed: %d, failed: %d, cancelled: %d", stats.completed, stats.failed, stats.cancelled);
+        ImGui::Text("Last load: %.1f ms", stats.lastLoadMs);
+    }
+    
     // Restore original settings
     ImGui::PopItemWidth();
     ImGui::PopStyleVar(2);
@@ -6,6 +6,8 @@
 #include <GLFW/glfw3.h>
 #include <simd/simd.h>
 #include "../../external/imgui/imgui.h"
+#include "components/textureStreamer.hpp"
+#include "components/assetStreamer.hpp"
 
 class Editor {
 public:
@@ -17,7 +19,11 @@ public:
         int debugCascadeLevel = -1;
         float intervalLength = 1.0f;
         simd::float3 cameraPosition = simd::float3{7.0f, 5.0f, 0.0f};
+        int textureBudgetMB = static_cast<int>(TEXTURE_STREAMING_DEFAULT_BUDGET >> 20);
     } debug;
+    
+    TextureStreamingStats textureStreaming;
+    AssetStreamingStats assetStreaming;
 
     Editor(GLFWwindow* window, MTL::Device* device);
     ~Editor();
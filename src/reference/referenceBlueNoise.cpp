@@ -0,0 +1,346 @@
+#include "referenceBlueNoise.hpp"
+
+const uint8_t reference::BLUE_NOISE[BLUE_NOISE_SIZE * BLUE_NOISE_SIZE * 2] = {
+    245,  90, 130,  65, 168, 243,  73, 129, 214,  74,  95, 249,   7,  30, 111,  49,  44, 228, 177,  64, 145, 187, 221, 124,
+    170,  78, 236, 203, 129, 130,  86,  67, 187, 106,  68,  24, 108,  50, 192, 243,  88,  34, 178,  83, 228, 135,   8, 211,
+     77,  59,  42, 171, 196, 252,  96, 132,  78,  86, 203,  31, 162, 200, 132,  78, 245, 223, 189,  56,  64,  14, 100,  87,
+    243, 151,  19, 239, 214, 127, 132, 202, 172,  95,  54,  67,  88, 114, 180,  83, 108, 246, 218, 121, 194,  51,  14, 151,
+    132, 111, 183,  42,   9, 145, 207, 120, 167, 184, 132,  36, 194, 163, 249, 189,  41, 232,  71,  44, 240, 154,   7,  90,
+    176, 124, 135, 167, 228, 105, 192,  51,  20, 224, 100, 159,  41, 184, 181,  40,  19, 214, 253, 172, 165, 112, 188, 206,
+    231, 143,  65,   4,  15, 254,  94, 154,  51,  51, 202, 175, 149,  12,  38, 231, 246, 155, 158, 176,  50,  74, 139, 144,
+    255, 208,  19, 164,  99, 108, 201,  23, 238, 187, 122,  90, 217,  36,  15,  68, 146, 233,  45, 143, 232, 161, 113,  43,
+      6, 119,  90, 167, 222, 142, 141, 231, 117,  20, 155, 187,  77,  79, 251,   0,   2, 175, 147, 139, 199, 211,  19,   7,
+    232, 179,  57,  25, 140, 201, 236, 236,  70,  21,  49, 228, 246, 199, 105,  16,  84,  83,  54, 214,   2,  59,  97, 102,
+    172,  14,  19,  71, 146, 182, 219, 215,  61,  56,  36, 251, 103,  15,  54, 197, 157,  25, 219, 113, 140,   8, 230, 143,
+    121,  95,  55,  16, 138, 133,  27,  72,  87, 178, 130, 104, 241,  82, 194,  25, 119, 234,   1, 102, 100, 147, 211,  36,
+     12, 216, 124,  93, 225, 196,  26, 104,  67,  11, 210,  63, 132, 248,  59,  46, 161, 221,  23, 120, 171, 154, 254, 190,
+    109,  14, 188,  58,  26, 212,  65,  97, 182, 247, 156,  28,  41, 185,  26,  63, 195, 106,  59,  45, 183, 216,  43, 117,
+     98, 227, 235,  40,  68, 237, 130,  57, 162, 153,  83,  98,  34, 133, 174,  73, 115, 164, 200,  95, 142,  57,  27, 255,
+    180, 110, 238, 152, 150, 239, 213, 125, 126, 197, 195, 247, 106, 109,  84,   5, 164, 139, 254,  80, 124, 156, 180, 130,
+    197, 246,  67,  83,  23, 231,  89,  55, 194, 194,  76, 234, 224,  45, 106, 242, 159,  24, 210, 219,  35, 192, 152, 118,
+     72, 210, 254,  69, 181, 199,  66, 122, 166,  59,  82,   1, 201, 254, 171,  44, 114, 220, 151, 186,  38, 126, 191, 150,
+     85,  78, 106,   4,  39, 241,  69, 107, 130, 219, 224, 126,  87, 177, 140,   2, 208, 138, 107, 201, 255,  83,  82, 128,
+    216, 250,   8, 166, 112, 145, 206,  64, 166,  23, 118, 158,  36, 103, 210, 128,  11, 206, 241, 241, 104,  45, 213, 193,
+      2,   0,  92, 124, 164, 180,  66, 142, 215,  46, 109,   4,  34, 177,  76,  24,  59,  86, 245, 149,  43,  39, 201, 169,
+     25, 230, 210,  33,   0, 206,  84,  63,  34,  44, 115, 168, 249, 204, 164, 122,   3, 153, 150,  81,  41, 170, 200,  97,
+      6, 158,  57,  58, 109, 139, 186,  40,  23, 156, 126,   7,  48,  88, 136, 240, 239, 191,  19, 164,  99, 119,  46, 137,
+    235, 158,  80,  89, 218,  17,  11, 229, 246, 174, 148, 205, 207,  51, 181, 168,   2,  74,  51,  35, 169,  87, 240, 238,
+     13,  68,  53,  41, 176, 224, 131,   9, 166, 205, 233,  31, 143,  94,  83, 243,  16, 196, 222,  84, 152, 188,  96,  30,
+    176,  70, 123,  13,  64, 174, 145,  87, 250, 245,  36, 213, 230,  31, 125,  75,  19, 196, 143, 222, 186,  70, 227, 136,
+    167, 209,  25,  56, 157, 222, 134,  91, 111, 191,  75, 120, 151,  99, 240, 178, 212, 136, 147, 106,  52,  29, 205,  71,
+    107,  12, 237, 220, 181,  32,  84, 202, 228, 117, 168,   9, 245, 226,  83,  94, 213, 248, 163, 185, 224,  47,  90, 143,
+     35,  27, 216,  76, 122, 214, 189,  19,   0,  71, 164, 242, 110,  39, 177, 103, 129,  60,  53, 130, 228,  97,  89,  17,
+    158, 145, 205, 231, 103, 191,  37, 153, 125, 115, 219, 172,  67,  99,  21, 157,  95,  55,  36, 119,  63, 179, 245,  15,
+    190, 135,  54,  50,  77, 252, 254, 171,  46,  96, 196, 225,  23, 115, 168, 138,  54,  60, 187, 150,  78,  99, 203, 231,
+     57, 121, 255, 165,  85,  98,  11, 243, 120,  25,  98, 164, 220, 127,  57,  20, 236,  66, 174, 239,  49,   7, 131, 215,
+      9,  22,  92, 226, 173, 158,  31, 254, 133, 184,  61, 108,  22, 140, 116,  68, 136, 250,  69, 182,  13,  77, 141, 166,
+     43,  29, 102, 124,   9, 223, 196, 109, 148, 176, 174,  95,  69,  54, 136, 235, 251, 181,  62, 115,  33, 203, 233, 144,
+     74, 189,  17,  30, 121, 215,  31, 254, 248, 179,  72, 111, 146,  19, 190,  51,  80, 219, 154,  15, 193, 241, 238, 134,
+    119, 192, 209, 223, 161,  73, 132, 232,  32, 109, 122, 214, 182,   4,   4, 141, 140, 209, 226, 156,  85,  24, 209, 234,
+    130,  39, 100, 183, 151,  11,   6, 158, 174,  22, 102,  60,  42,  35, 138, 181, 209, 109, 177,  76,   5, 251,  90, 184,
+    192, 146,  17,  49, 224, 160, 101,  74, 187,  94, 229, 187,  71,  42, 241,  89,  87, 131, 217,  52, 172, 237, 247,  16,
+     46, 151, 215,  43, 194, 131, 118, 201, 236,  57, 183, 150,  63,  70, 249,  12, 109, 250,  49, 205, 227, 147,  26, 106,
+     90,  29, 209, 165, 145,  65,  94,   7, 201, 245, 155, 162, 185,  77,  99, 136, 134,  42,  11,  67, 222, 209,  25, 130,
+    249,  92, 108, 198,   2,  70, 141,  37,  50,  88, 181,   2,  11, 148,  91,  43, 227, 166, 156,  65, 208, 119, 107,  79,
+     66,  37, 161,  58, 114, 195,  10,  82, 223, 205,  29, 112, 245, 250, 119,  85, 218, 203, 155, 235, 190, 139, 232, 218,
+     52,  49,  74, 206, 251,   2, 145, 102,  41, 219, 123, 128,  71, 194, 161, 249,  58, 151, 129, 123,  17,  67, 184, 203,
+    156,   2,  12, 211, 101, 171, 150,  85,  30, 195,  96, 101, 159, 233,  20,   3,  76, 241, 154, 100,  31, 193, 131, 158,
+     81,  42,   6, 124, 200,   5, 156, 196, 180,  49, 120, 216,  13, 126, 170, 225,  42,  88, 245,  48,  64, 117, 219,   2,
+     48, 193, 175, 100, 117, 161,  62, 250, 164,  32,  41, 180,  90, 151, 215, 116,  76, 253, 252, 171, 108, 102, 199, 207,
+     62,  28,  18, 187,  86, 226, 232, 161,  29, 238, 246, 129,  44, 105, 182,   5,  73, 163, 165,  70,  49, 132,  89,  46,
+     32, 185,  71, 114,  14,  87, 110,  13, 161, 148,  31, 117, 198, 174, 111,  41, 168,  80, 243,  27, 204, 108,  35,  13,
+    252, 221, 198,  33,  95, 236, 118, 167,  40, 101, 197, 148,  72,  33, 207, 115, 127, 218, 184,  24, 253,  65,  50, 116,
+    226, 175, 108,  19, 215, 218, 193,  87, 170, 228, 242,  66, 114, 167,  75, 233,  37,  79, 240, 152,  58,  98, 221,  22,
+    128, 141, 105, 180,   5, 237, 195, 212, 151, 144, 241, 228,  93,  13, 206,  79, 133, 141, 234,  60, 197, 229, 170,  22,
+     28, 203, 150,  53,  44, 126, 168, 237, 242,  86, 116, 133,  47,  23, 175,  98, 128,  15, 193, 188,  97, 251, 146, 141,
+    232, 216, 126,  30, 206, 223, 179, 148, 234,   2, 133,  66, 201, 168, 246, 249,  89, 193, 130,  60, 222, 238,  59, 154,
+     20, 228,  82, 181, 141, 211, 107,  56,  25,  83, 144, 195,  51, 139, 221,  20, 248, 247, 138,  73,  48, 227, 239,  59,
+      4, 176,  61, 135,  88, 162, 140, 204, 177,  78,   1, 139,  88,  50,  52, 117,  20,  23, 140, 185,  56,  93, 229, 133,
+    149,  15, 104, 252, 189, 194,  83,  41,  24, 207, 214, 105, 141,  66,  88,  29,  33,  87,  73,  50,  16, 170, 182, 113,
+     52, 216,  10,   5, 123,  97,  62, 159, 115,  78, 229, 188,  84,  19,   3,  70, 141, 156, 188, 249, 217,  54, 150, 213,
+     74, 170,   7,  64, 216,  42,  58,  90,  14, 180, 102,  58,  25, 100,  64, 175, 146, 241, 100, 209,  55,  40,  28, 101,
+    182,  23,   6,  81, 153, 133, 101,  12, 184,  98, 226,  67,   1, 131, 172, 169,  83,   4, 213, 100, 167,  59,  74, 118,
+      8,  40, 108, 188, 177, 125,  83,   8, 162, 236, 217,  45, 116,  89,  29, 225, 206,  30, 124, 253, 248, 170, 149, 211,
+    221, 144,  94, 246, 191,  35,  22, 213, 213, 114,   9,  60, 135, 173, 253,  77, 157, 243,  51,  10, 173, 148, 234, 175,
+    125, 118, 213, 246, 156, 200, 103,  39, 223, 183,  82, 242, 155, 129, 244, 211,  21,  33, 192, 137, 126, 220, 222, 175,
+     72,   9,  32, 104,  93, 191,  19, 125, 241,  80, 120, 149, 160, 224,  84, 119, 251,  11, 194, 246, 158, 127, 240,  21,
+      1,  83, 218, 121, 166, 143, 117, 225, 206, 159,  76, 217, 240, 179,  45,  53, 210, 255, 118, 160,  68,  37, 235, 241,
+     40, 148, 120, 229,  20, 182, 186, 219, 151, 163, 212,  92,  29, 206, 124, 145, 193,  99,  20, 196, 237,  15, 155, 150,
+     71,  58,  39, 125, 167,  97,  63,   1, 119,  74,  35, 108, 165,  58, 128, 162,  88, 188, 169,  31,  69, 136,  38, 110,
+    203, 159, 115,  57,  67, 225,  13, 194, 190,  72,  48, 133, 252,  22,  29,  95, 137, 150, 188,  73,  37,  48, 208, 174,
+     99, 110, 174, 248,  56,  93, 202,  46, 107, 206, 249, 141, 135,  33, 170, 231,  56,   8, 198, 199,  37,  30, 176, 165,
+    137, 208,  46,  75, 115, 194,  88, 162, 187,  51,  42, 199,  80,   9, 142,  62, 228, 123,  36,  36, 174, 103,  86, 208,
+    149, 120,  28,  18, 137, 204, 193, 114, 161, 172, 247,  29, 103,  78, 224,   9,  88, 142,  56,  53, 231,  26, 149, 252,
+     64,  62, 105, 169,  48, 243, 183, 107, 223, 190, 101, 219, 193,  37,  14, 183, 207, 204, 233, 154,  72, 227, 248,   7,
+     47,  90, 187, 241, 230, 221,  99,  16,   2, 202, 181, 126, 243,  94, 101,  41, 147,   5,  79, 233, 117, 156, 174,  59,
+     59, 205, 239, 116, 113,  20,  76, 224,  11,  61, 153,   4,  39, 154, 144, 122,  14, 239, 178,  85,  46,  61, 211, 173,
+    109, 114, 229,  88,  99, 243,  22,  53, 226, 102,  74, 147, 210,  35,  31, 226, 125, 110, 255, 238, 177, 183,  11,  93,
+     61, 246, 109, 192, 133,   6,   9, 151, 255,  77, 179, 185,  53,  92,  94,  48,   8, 213, 142, 131,  62, 251,  38, 105,
+    130, 199, 196, 230,  98,  82,  15, 180, 242, 118, 204,  30, 145,  79,  91, 134,  10,   9, 134, 159, 238,  84,  79, 243,
+    156,  52, 105,  28,   3, 127, 199, 199, 113, 144,  26,  71, 144, 100, 123,  50, 222, 180,  81,  26, 135, 254,  23, 165,
+    202, 211, 165, 104,  15, 177, 217, 223,  90,  10,   0, 253, 164, 139, 134, 185, 255,  84, 212, 168,  89, 197, 237,  68,
+     66,  23, 227, 183,  85, 154, 129, 254,   1,  45,  71, 139, 150, 181, 184, 123, 121,  22,   6, 239, 167,  62, 228, 136,
+    151,  15,  65,  77, 105, 151, 195,  27, 244, 167, 160,  73, 219, 230, 192,  41,  72, 221, 110, 135, 227, 245, 209,  69,
+     77,  98, 198, 195, 235,  62, 166, 125,   5,  37, 254, 167,  45, 132, 175,   2,  78, 221, 121, 156,  34, 199, 251,  40,
+     61, 238, 176,  66,  31, 116, 122, 137,  49, 174, 184,  99, 141, 254,  59,  61, 158,  20, 243, 171,  63, 208, 200, 153,
+     45, 229, 161,  80,  58, 111, 216, 140,  41,  52, 233,  84,  66,  31, 141, 123, 193,  76, 231, 163,  51,  98, 182,  42,
+     64, 241,  28, 129, 123,  37, 187, 233, 112, 113, 151, 215,  23,   3, 164, 101, 254, 203, 192,  16,  51,  66, 243, 229,
+     89, 160, 193, 186,  56,  88, 101, 216,  17, 171, 204,  43,  29, 124, 131, 222,  90,  54,  24, 138,  53, 117, 100, 174,
+     37,  60, 164,  26,  18, 164, 127,   7, 178, 144,  31,  42, 116, 176,  81,  15, 185, 241, 139,  94, 113,  64, 155, 204,
+    223, 102,   2,  51, 187, 228, 160,  95, 110, 179, 217, 206, 148,  24, 196, 227, 255,  10,  27,  77, 225, 186,  97, 113,
+    208, 218,   9,  43,  89, 117, 152,   1,  15, 132, 250,  60, 188, 201, 124,  14,  86, 184, 110, 245, 183, 145,  33, 198,
+    103,  49, 127, 189,  21,  26, 202, 217, 102, 108, 229,  12, 169, 211,   4,  96,  51, 149, 215,  53, 199, 129,  40,  73,
+     92, 223, 114, 148,  14, 193, 133,  82,  35,   2, 217, 111, 142,  28, 238, 201,  79, 101, 172, 253, 232, 191,  48,  97,
+    215, 203, 185,  18, 126,  85, 237, 250, 203, 103, 138, 214, 244, 119,  49, 230, 103,  19, 146, 239, 212,  87,  24, 211,
+    227, 147,  63, 189,  28,  22, 194, 246,  52, 144, 135,  75,  73,  20, 231, 122,  45, 143,  84,  53,   5, 163,  66, 104,
+    100, 213, 169, 146,  81,  36,  38, 163, 178,  93, 128, 247, 227, 188, 176,  86, 113, 241,  97,  34,  28, 156, 145, 234,
+    242,  68,   8, 114, 155,   2, 251, 228,  57,  89, 209, 237,  79, 149, 146,  70,  42, 200, 154, 139,  75,  77, 247, 177,
+    101,  18, 137, 193,  73, 242, 179, 160, 219,  26, 153,  97, 231,  47, 173, 210,  66, 135, 159, 249,  10, 155, 127,  48,
+     40, 131, 111,   4, 144,  69,  72,  25, 157, 159,   2, 237,  83, 146, 152,   1,  22, 198,  63,  38,  88,  80, 217, 189,
+      0, 106, 250, 163,  55, 134,  97,  71, 161, 112, 107,  49, 211, 162,  85, 119, 247,  34, 102, 183, 209, 165,  22, 253,
+    128,   4, 201,  83, 238, 240, 116,  39, 215,  63,  12, 195, 137, 234, 240,   5, 108, 137,  29,  69,  75,  29,  39, 145,
+    235, 207, 203, 176,  72,  94, 173, 126,  49,  41, 210, 210,  71, 158, 132,  36,  12, 136, 161, 116, 241,   7, 114, 177,
+    219,  49,  16, 165, 127, 243, 190,  42,  36, 227, 227,  86,  10, 109, 119,  43,  57, 177,  27, 234,  79, 119, 207, 171,
+    111,  36, 249,  64,  93, 191, 185,  80, 209, 235, 247, 150,  11, 177, 180, 226, 108, 111, 251,  46,  58, 186, 220,  64,
+    177, 168, 120, 132, 190, 155, 156,  51,  72,  65, 172, 203, 131,  27, 200, 221,  10,  10, 244, 229, 143, 198,  16,  84,
+    169, 233,  36, 211, 151, 104, 182,  65,  95, 216, 165, 194,  37, 112, 182, 178, 152, 132,  49,  89, 198, 120,  61,  56,
+    219, 202, 148, 231, 193, 168, 134,  51,  59, 110, 156,  72,   4,  24, 227, 222,  95, 170, 117,  79, 192, 101, 223, 182,
+     87,  58, 177, 211,  34,  82,  67, 251, 180,  95,  93,  22, 209, 114,  59,  64, 144, 133, 173, 164,  84,  11, 236, 203,
+    135, 130, 193,  61, 104,  12,  17, 242,  49, 100, 195, 224,  32, 122,  70,  20, 137, 210,  56,  92,  92,  40, 223, 134,
+     33,  77, 195, 213, 136,  96,  42, 121, 104, 222,  12,  22, 233, 208,  40, 253, 119, 174, 231, 122,  35,  45,  79, 181,
+    178, 158,  44, 101,  70,  65, 187,   6, 117, 132, 234,  52,  68,  18,  13, 152, 249, 131,  55,  30, 136, 156,  18,  13,
+     83, 223, 244,  22, 121, 245, 166, 179,   1, 102,  87,  17, 253, 125,  16, 218, 218,   7,  91, 252, 123, 192, 196, 141,
+     34,  12, 169, 249,  18, 199,  43,  18, 111, 242, 233, 161, 138,  32,   5, 135, 251, 223, 157, 190,  24, 155, 233, 201,
+     96,  29,  26, 215, 197,  67, 159, 252,  42,  87, 248, 188, 166, 152, 143,  79, 233, 142, 123,   9, 153, 181, 224, 157,
+     21,  60, 165, 116, 200, 190, 124, 248,  68,  29, 163, 171,  96,  11, 202, 246, 246,  44, 146,  93,  82, 113, 207,   8,
+     22,  80, 100, 230, 217,  94, 154, 241, 114, 130, 235,  33, 130, 249, 221, 154,  48, 176,  89,  92, 137, 189, 219, 231,
+    114,  44,  79,  97, 210, 248, 229,  59, 106, 192, 187, 158,  22,  80,  96,  34, 211, 154,  48,  72, 180, 184, 118,  90,
+    168, 159,  45, 121, 248,  44, 141,  97,  62,  63, 236, 115, 134,  46, 156, 145,  58,  71, 205, 106,  99, 188, 195,  54,
+    121, 121,  53,   1,  82,  84, 167, 247, 124,  99, 253, 182,  63, 118, 108, 146,   1,  19,  91, 232,  59,  34, 216, 195,
+     75, 217,   6,  49, 175,  95,  87, 245, 115,  34, 242, 225,  45,  14, 149, 149,  20,  62, 235, 127,   6, 197,  73, 154,
+     30,  72, 171, 233,  54, 191, 137, 148, 162, 212, 187,  19,   5, 144,  60,  58, 206,  78,  26, 190,  86, 114,   3, 207,
+    163,  35, 202, 241,  25, 121, 188,  73, 160, 166,   0, 199, 173,  78,  63, 143,  39, 109, 141,  47,  67, 217, 233, 127,
+    127, 210, 153, 246,  68,  38,  97, 229,  28,  63, 208, 208,  78, 175,  15, 233, 186, 152, 102, 220,  78, 178, 245, 127,
+    171, 205,  23,   8,  77, 226,  42, 147, 227,  74, 143, 214, 193,  38,   5, 138, 210,  55,  45,   6, 149, 224, 224,  44,
+    205, 103, 180, 163, 118, 123,  34,  67, 185, 111, 102, 166, 253, 204,  60,  77, 186, 139,   1, 167,  78,  83, 228, 207,
+    192, 104, 115, 238, 179,  87, 131,  30, 220, 132, 109, 171, 199,  57, 243,  35,  87,  99,  67, 169, 254, 196, 134,   1,
+     95, 215, 168, 149, 196,  15, 148,  87, 107,  61, 254, 143,  59,   2,  98, 208,  43,  23, 244, 118, 117, 227, 149,   8,
+    204, 236, 252,  90, 164, 173,  34,   1, 200,  54,  11, 110, 221, 135, 244,  14, 187, 148, 147,  31, 106,  82, 164,   0,
+    222, 196,  31,  24, 196,  85,   1,  35, 120, 234, 220,  93, 150, 171, 175,  24, 106, 238,  28, 162, 244, 110, 109, 176,
+     72, 236, 179, 154,  15,  81, 130, 174,  71, 200,  21,  54, 238, 222, 135,  14, 205, 255,  25,  30, 144, 129,  40,   0,
+    208, 194, 155, 109, 131,  53, 103, 179,  31,   5,  86, 221, 253,  52,  56, 187, 153, 218,  91,   3,   9, 124,  42, 246,
+    222, 136, 113,  43, 151, 117,  39, 252, 228, 103,  53,  52, 244, 231,  72, 169,  38, 219, 175, 192, 128, 103, 210, 252,
+    143,  56,  88, 182, 193,  39,  26, 164,  93, 124,   5,  30, 112, 254,  80, 138, 176, 199, 104,  79,  41, 191, 133, 170,
+     58, 103,   3, 237, 239, 117,  67, 137, 127,  56,  52, 105, 147, 244, 213, 161,  89,  60,  46, 118, 249,  43,   9, 196,
+    211, 100,  88,  60,  55, 204, 162,  21, 234,  70, 120, 196,  92, 131, 245,  21, 167, 247,  97,  94, 152, 140,  53, 178,
+     84,  84, 168, 153, 222, 213, 125,  65,  93, 234, 236,  29,  50, 251, 216, 131, 170,  42, 146, 161,  38, 115, 211, 147,
+     25,  79, 237, 103, 189, 201, 127,  67, 170, 182,  13, 233, 203,  81, 179, 164,  18,  32, 110, 183, 136, 129,  15,  28,
+    227, 113,  81,  43,   8,  81, 239, 152,  22, 129,  62,  91, 234, 216,  49,  71, 221, 206, 131, 187, 194,  68,  50, 100,
+    242, 162, 144,  21, 205, 242,  86,  53, 172, 212, 122,  69, 214, 185,  24, 250, 182, 167, 254, 209, 110, 133,  66,  14,
+    182, 187, 137, 141, 113, 247,  63,  76, 157, 132, 185,  11, 133, 254,  36, 124, 202,  96,  24,  33, 190, 229,  53, 111,
+     36,  69, 196,   4, 218, 206,  10,  43, 242, 106, 109, 226,  65,  47,  12, 119, 176, 174,  24,  92, 189, 152,  68, 213,
+     10,  81, 204, 194,  77,  25, 121, 244, 178,  18,  72, 227, 143, 162,  57,  23, 241, 219, 101,  12,  51,  63, 125, 142,
+     80, 209, 191,  93, 214, 244, 166,  72, 122, 160, 203, 236, 149,  13, 108, 171, 185, 224, 157,  19, 121, 147, 177, 106,
+     73,  50, 167, 143, 228,  15,  24, 213, 122, 232,  62,  41,  14, 122, 236,  92,  30,   6, 199, 157,  95,  44, 157,  18,
+     82,  90,   8,  33, 166,  69,  35, 225, 238,  82,  21, 215, 197,   5,  83, 153, 237, 222,  16, 186, 217,  46,  99, 158,
+    142, 180,  67, 208, 159,  52, 222, 152, 140, 189, 114, 123,  68, 158, 184, 240, 130,  17,  35, 188, 191,  80, 246, 147,
+    148,  13,  85, 220, 114,  70, 247,  17, 138, 121, 102, 232, 231,  99, 159,  67,   1, 177, 111,  49, 215, 142,  30,  90,
+    192, 124,  77, 200, 213, 106, 238, 237, 161,  16,  33,  60,  63, 151,  93,   5,  47, 206, 182, 131,  64, 187,  34,  68,
+    225,  38,  83, 192,   7, 249, 208,   5, 103, 229,  15, 168, 151, 116,  88,  56, 211,  88, 158, 153, 189, 205, 100, 175,
+    148, 132,  64, 228,  38, 107, 229, 214, 137, 148, 198, 194, 225, 113,  98, 170, 155,  37,  55, 105, 224,  57, 145, 173,
+     40,  34, 123, 112,  61,  79, 252, 231,   3,  19, 229, 137, 106,  84,  81, 244,   8,  39, 255, 222,  28,  76,  94,  56,
+    162, 134, 215, 163,  80,  28, 118, 247,  38, 191, 229, 108, 158,  40,  45, 203, 179, 174,  27,  55,  60, 157, 195, 135,
+     46, 209, 248, 115,  94, 248, 156,  35, 133, 151,  38, 169, 141,  45,   1, 180,  97, 126, 222, 197, 146, 108, 252, 224,
+     25,  91, 231,  50, 101, 102, 211, 240, 135, 115,  46,  82, 252, 127, 142, 176,  38,  92, 239,  36,  59, 244, 110, 191,
+    255, 135,  36,  10,  75,  70, 220, 252, 118,  29, 248, 189, 183,  72, 112, 124,  54,  51,  29, 228, 122,   6,  69, 253,
+    189, 146, 125, 193,   5, 126, 168, 211, 104,  92, 201, 241, 177, 145,  80,  62, 167, 117, 197, 218,  32,  10, 128, 171,
+    208,  98, 171,  25, 148, 182, 226, 116,  51, 200,   6, 233, 143,  99, 199, 130,  60,  55, 207, 168,   3, 241,  76, 141,
+    218,  93, 123,   8, 242, 254,  84,  36, 132,  83, 185,   6,  65, 189,  14,  73, 113,  58, 250,   3, 177, 216,  67,  82,
+    195,  26, 120, 247,  11,  42, 178, 166, 110,  26, 159, 198,   0, 141,  76,  25, 166, 213, 114, 164, 186,  44,  69,  65,
+    174, 215, 129, 131, 203,  73, 184,  26,   8, 172, 130, 220, 180, 113,  47,  48,   6,  86, 159, 152,  22,  11,  73, 244,
+    241, 178, 153,  84, 209, 130,  16,  55, 251,  91,  85,  16, 212, 237,  68,  70, 246,  23,  19, 183, 143,   1,  37, 195,
+    121,  94,  56, 162, 245,  59, 184, 125,  62, 212,  40, 143, 109, 252,  77,  88, 186,  13, 250,  41, 102,  68,  20, 208,
+    169,   4,  93,  80, 135, 125, 192,  28,  97, 221, 164, 197,  12, 108, 150, 185, 224, 224,  24, 161, 170, 104, 208, 230,
+     54, 120,  89, 255,  21, 101, 156, 141, 243, 160,  52,  69,  83, 188, 205, 134,  61,  80, 133, 254, 246, 175, 193,  61,
+     28, 149, 236,  11,  17, 239,  95, 185, 221,  21,  27, 157,  79, 202,  48, 101, 165, 237,  87,  35, 233, 164, 141, 195,
+    203, 231,  86, 101, 217, 207, 134,  37, 190, 158,  94,  21,  47, 187, 175, 219, 107, 155,  38, 205, 134,  45, 185, 137,
+     48, 163,  93, 119, 231, 214, 208,  42,  97, 249, 153,  30,  16, 231, 145, 197,  92,  71, 238,   2, 201,  50,  21, 165,
+    127, 218, 158, 111,  69, 175, 237, 141, 122, 230, 224, 195,  24, 160, 254,  50,  57,  74,  37, 149, 204,  22, 105,  64,
+     41, 131, 119,  49,  79,  28, 230, 202, 161,  86, 189,  34, 222, 186, 108,  53,  32, 228, 136, 116, 230,   9, 151, 234,
+     38,  46, 216, 120,  90,   3,  48, 227, 147,  91, 104, 204, 204, 110,  54, 140, 159,  96, 121, 254, 246,   0, 143, 123,
+    216,  54, 105,  85,  26, 129,  61,   6, 172, 138, 106,  57,  51, 173, 169, 116,   2,  64, 220, 237,  77, 103, 140,  33,
+    229,  74, 163, 116,  24, 179, 225,  96, 114, 251, 162,  58,  70,  85,  11, 149, 181, 176, 225, 103,  75, 138, 215,  42,
+    116, 112,   0, 179, 138, 225, 230, 126,  59,  74,  33, 153, 210, 250, 179,  33,  46,  90,  73,  19, 162, 107, 112, 248,
+    144, 179, 237, 118, 175, 238,  71, 170, 212,  95, 252, 246, 147, 140,   4, 174, 104, 210,  37, 130, 129, 235,  78,  13,
+    214, 173, 174,  89,  18, 213, 100, 150, 191,  96,  14, 208, 122,  72, 179, 166, 225, 126,  74,  50, 136,  75, 232, 222,
+      4,  38, 102,  62, 195, 178,  20, 153,  67, 212, 192, 184, 243, 247, 123,  72, 225, 214,  16,  26, 252, 249, 115, 144,
+     40,  91, 124, 202, 245, 136,  11, 165,  54, 247, 204,   3,  91, 223, 150,  31,   0, 199, 192,  12, 127, 229, 250, 128,
+     49,  69, 108,   7,  30, 186, 178,  84,  50, 240, 163, 147,  82,  96, 173,  23, 197, 205, 117,  10,  89,  59,   5, 184,
+    138, 122, 200, 223,  34,  64, 185, 209,  16,   0,  90,  87, 128,  42,   7, 213, 162,  10,  96, 191,  49,  74, 199,  16,
+     69,  58, 228, 154, 152,  77,   7, 107, 193, 202,  65,  32, 123,  59, 248, 175,  75,  17, 163, 186, 238, 137,  64,  37,
+      7, 248, 167, 193,  35,  20, 190, 160,  69, 197, 173, 113,  43, 230, 234,  78, 117,  18,   0, 108, 153,  31,  39, 160,
+     77, 104, 190, 181, 139,  80,  71,   1, 206, 224, 177,  46, 155,  14,  99,  62, 183, 193, 121,  88,  70, 145, 236,  65,
+     57, 154, 212, 105,  31, 188,  88,  25, 139, 213, 165, 238, 241, 157, 129,  19, 199, 211, 251,  34,  40,  61, 101, 245,
+     12, 173, 246, 134, 150, 103, 221, 236, 104,  47, 243, 138,  86, 166, 232,  36,  66, 145, 198, 227, 228, 125,  55, 155,
+    190,  63,  25, 113, 125, 225, 240, 162,  16, 242, 179,  24,  56, 219, 254,  46,  99, 151,  35, 129, 166, 251, 204, 105,
+     50, 225, 109,  54,  32, 236, 140,  99, 202,  12, 117, 174,  89, 118, 251, 243, 128,  83, 212,  13,  92, 138, 163,  45,
+    139, 242,  85, 145, 178, 202, 211,  48, 100, 236, 159, 123,  31,  53, 223, 195,  89, 155,  20, 118,  60, 180, 214, 231,
+     33, 129, 249,  43,  15, 176, 177, 117, 136, 239, 104,  40, 171, 167, 220,  55, 197,  93,  19, 118,  60, 198,  95,  67,
+     14, 128,  70, 168, 147, 195, 216, 113, 129,  39,  74,  79,  48, 212, 171, 162,  61,   8,  18, 202, 159,  82, 119, 111,
+    147, 194,  40,  51, 101, 178, 139,  26, 243, 200,  77, 137, 170,  41, 140, 104, 110,  89,  84, 195, 207, 119, 116, 177,
+    144, 238, 232,   1,  87,  73,   2, 143, 136,  34, 186, 121, 219, 156,  95,  78, 244, 220,  52, 142, 181,  67,  24,  33,
+    148, 151,  13, 181,  58, 209, 220,  96,  34, 172, 253,  66,  50, 128, 133,  90,  12,  14, 242, 211,  56, 165, 184,  97,
+    149,  28, 109, 252, 239,  76, 133, 105,  82,  24, 147, 207, 200, 233,  95,   9,  41,  78, 245, 212,  62, 133,   7, 248,
+     78, 150, 120,  30, 212,  47, 151, 107, 224, 255, 119,  14, 189,  87,  20, 140, 178, 233, 234, 190,  27,  27, 203,  68,
+    132,  99, 192, 243,  44, 183, 219,  17,   0, 250, 172,  75, 208, 103,  18, 233, 113,  85, 218, 252,  34,   2, 202, 180,
+    231,  47, 165, 136,  40,  12,  17,  66, 185,  93,  51, 208, 214, 164, 155, 197, 236,  86,  21, 209,  80,  22, 170, 191,
+     15, 109, 154,  47, 223, 202,  65,  95, 100, 219, 237,  54, 113, 125, 182,  27,  75, 220, 198,   3, 112, 233, 225, 192,
+     66, 146, 201,  36, 124, 240,   7, 134, 231, 205,  44,  56, 197, 146,   3, 219, 170, 156,  47,  98, 115,  53, 217, 138,
+     18, 192, 158,  96, 116,  13, 148,  71, 236, 201, 168, 178,  42, 136, 185, 215,  81,  77,  37, 153, 244, 224,  61,  55,
+     91,   0, 159, 152, 119, 120,  81, 219, 253, 144, 108,  32,  74, 123, 184,  61,  93, 136, 250, 217,  78,   7, 161, 149,
+     62,  45, 181, 165,  94, 117,  53, 217,   5,  80, 129, 249, 243, 162, 153, 228,  75,  34, 132, 118,  27,  50, 104,  20,
+     67, 243, 126, 172, 208,  56,  57, 253, 111,   2,  37, 157, 125, 237, 210, 121, 169,   7, 194, 244,  30,  74, 131, 189,
+     10, 151, 160, 115,  25,  53,  90, 163, 171,  76, 150, 111, 105,  64,  77,   8, 136,  85, 164, 177,  70,  39,  98,   4,
+    189, 194, 228,  71,  65, 170, 166, 255,  85,  34, 189, 161, 230, 122,  47, 230,  93,  20,  22,  86, 253, 232, 105,   4,
+      4, 188, 168,  44, 135, 201, 109, 107, 207, 178,  43,  86, 223, 252,  22,  49, 153, 172,  10,  77, 234, 230, 136, 160,
+     52,  40, 126, 171,  30, 118, 234, 206, 142,  66,  13, 189, 252,  21, 149, 145, 191, 205,  96,  27,  64, 105, 219, 191,
+    194, 143,  94, 223, 247, 181, 200, 135, 179, 110,  42,  71, 253, 147, 136, 128, 198, 177, 239,  75,  86,  28,   3, 186,
+     45, 146,  76, 169, 152, 106, 241,  42,  97, 253, 216,  82, 139, 216, 245,  30,  42, 248,  19, 185, 214, 219, 255, 167,
+     32, 230, 205, 114, 116, 240, 247,  91,  28, 128, 129, 226,  11,  16, 254, 115, 138,  62,  27, 222,  74, 186, 203,  48,
+    176, 111, 139, 159,  65,  57, 126, 169, 229, 102, 201, 133,  54,  18, 227, 235,   8,  65, 139, 205, 190,  18,  99, 106,
+     54, 193, 169,   5, 200, 212,  27, 101, 163, 198, 205,  81, 103,  31, 190, 245,  44, 132, 125,  99, 207, 237,  74,  63,
+    226, 180, 173, 127,  29,  51, 113,  82,   7,   8, 167,  99,  45,  67, 120, 234,  13,  11, 157, 212,  98,  38,   7,  89,
+     74, 226, 183, 105, 162, 210, 139,  59, 252,  85, 120,  20, 213, 202,  60, 138, 190,  12,  46, 176,  70, 102, 178, 137,
+    119,  10, 191, 127,  50,  44,  95, 102, 180,  21,  13, 141, 218, 199,  58,  61, 157, 175,  83,  36, 199, 150, 107, 204,
+     54,  89, 223,   1, 127, 140,   0,  80, 111, 208, 221, 249, 191, 124,  45,  34, 147, 240,  93,  68,  20, 172, 156, 121,
+     83, 147, 173,  40,  65, 166, 241, 130, 211, 240, 116,  91,  90,  50,  65, 140, 237,  13,  16, 232,  69, 179, 224,  91,
+     86,  11, 171, 197, 104,  40,  24, 156,  44,   4, 122, 234, 202, 210,  52, 167, 235, 243, 147, 152,  71,  37, 230, 196,
+     86,  92, 219, 159, 193, 240, 147,  16, 229, 198,  28,  44,  53, 137, 103, 250, 197, 116,  22, 224,  92,  52,   6, 235,
+    166,  66, 123, 209, 230,  39,  12, 168,  84, 205, 225,  89, 158, 153, 128, 210,  68,  74, 153,  49,  43, 160, 138,  17,
+    183, 248, 237, 108,  36,  73, 173, 239, 209, 130,  98, 169, 160, 245, 248,  31,  39, 149,  85,   9,  12,  93, 169, 196,
+     74, 142, 241, 218, 187,  89, 123,  29, 249, 247,  32,  96, 129, 223,   2,  68, 141,  34,  37, 157, 226, 180, 145, 255,
+    107,  65, 180, 113, 131, 153, 151,  53,   4, 225, 235, 164,  59, 122, 144,  85, 160, 111,  84,  37, 251, 138, 139,  63,
+     90,  23, 211, 203,  17, 114, 172, 169, 134,  51,  30, 126,  67, 184,  46, 111, 122,  67,  92, 165, 220,   6, 174, 174,
+     68,  34, 229, 190, 181, 128, 146,  90, 248, 155,  30, 120, 101, 231, 207,  79, 144,  53,  63, 240,   3,  26, 233, 182,
+    201, 254, 110, 122, 240, 214,  92,  98,   4, 137, 111, 198,  69,  47, 149, 181,   9,  22,  43,  55, 183, 107,  65, 198,
+    199,  67, 152, 179, 233, 222, 208,  74,  26,  14, 107,  48,  41, 185,  68, 209, 202,  57, 110, 177, 229,  15, 180, 143,
+     79, 208, 192, 109,  13,  18, 171, 126,  43, 203, 249,  37,  54, 215, 209, 134,  34,  76, 186,  29, 112, 210, 243, 255,
+    189,  71,   2, 190,  66,  93, 182, 227,  23, 125, 124,  86, 191, 253,  51,   0, 250, 220, 100,  73, 178,  22, 243, 151,
+    160, 235, 200, 123,   9, 221, 147,  79,  32, 100, 133, 150,  49,  16, 112, 181,  74,  31, 199, 193, 162,   3,  41, 144,
+    251, 188, 113, 123, 174,  62,  39, 108,  81,   1,  17, 173, 169,  33,  64,  79, 196, 222, 216,   5, 127, 158, 226,  95,
+     91, 221, 239, 191, 140,  84,  20, 235, 125, 129, 102,  43,  55, 108, 120, 166, 140, 255, 177, 118, 215, 155, 159,   6,
+     14, 135,  52, 110,  91, 196, 160,  83,  47, 234, 245,  56, 124, 191,  83,  81, 197, 168,   9, 100,  96,   3, 118, 247,
+    163, 182,  78, 104, 214,  52,  21, 145, 131, 204, 231, 157, 110,  16, 164, 172,  43,  46, 226, 186,  80,  61, 111, 144,
+    158, 100,   1, 194, 215, 249, 110,  49,  21,  86,  70,  27, 234, 193, 106,  56, 247, 241,  82, 206, 208,  70, 226, 238,
+     18, 112, 132,  59,  59, 251, 187, 106,  91,  19,  23, 224, 216, 162, 132, 204, 247,  82, 188, 142, 123, 232, 230, 183,
+     39,  57, 156, 120,  24, 236,  55,  33, 188, 144, 116, 123,  73,   6, 220, 160, 169,  21, 243, 228,  33, 143,  79,  27,
+    252, 192,   2,  62,  92,  98, 238, 226, 140,  73, 186, 244, 211,  45,  19, 162, 109,   1, 214, 134,  58, 243, 157,  27,
+    231, 212, 137,  55, 219, 161,  65, 119, 241,  21, 134, 229,  48, 170,  98,  11,  61, 123,  33,  57, 196, 245, 219, 105,
+     98, 217, 154, 133, 239,  28,  35, 235, 204, 164, 138,  38,  81, 132,  39, 174, 143, 214, 186, 142, 127, 107,  57, 157,
+    166,  10,   1, 123, 153,  45,  39, 166,  97, 215, 239,  88, 149, 159,   6, 210, 124,  47, 196,  93,  73, 134, 154,  36,
+     95, 238,  55,  48,  25, 114, 142,  18, 100, 152, 180, 195,  82,  81, 251, 176, 158,  64,  14, 255, 207,  47,  46, 209,
+     87,  95,   7, 187, 185,  52, 160,  86, 198, 129,  62, 235, 128,  31,  35, 167,  76, 188, 115,  24, 253, 122,  69, 223,
+    139,  98, 174, 175,  22,  71, 103, 147,  33, 115,  74, 237, 184,  84,  25, 198, 175,  69,  12, 137, 157,  87, 204, 240,
+    176, 100, 143, 212,  78,  35,  15, 148,  60,   7, 133,  77,   9, 196,  71, 110, 184,  81,  57,  15, 235, 207, 169,  96,
+    212,   4,  88,  68,  18, 248, 218,  38, 197, 185,  93, 222, 188,  98, 124, 139, 173,   9, 204,  37,  80, 134, 224,  70,
+    165, 183, 242, 247,  47,   9,  28, 186, 213, 102, 163, 157, 223, 209,  72,  69, 244, 251,   7,  40, 211, 106, 133,  10,
+     37, 204,  96, 101, 178, 172, 148,  75, 228, 120, 132, 246, 213, 152,  97, 217,  44,   0, 150, 204, 226, 146, 205,  47,
+    172,  89,   5, 142, 153, 200,  39,  64, 226,  29,  80, 204, 191,  46, 251, 224, 122,  10, 206, 186, 152,  32,  47, 147,
+    103, 213, 221,  44,  76, 185, 250,  28,  18,  75, 236, 136, 122, 187, 161,  87, 253, 175, 206, 242, 173, 155, 117,  45,
+    218, 227,  97, 181,  26, 115, 118,  51,  53, 230, 254, 170, 154, 201,  36,  87, 119, 135,  52,  28, 241,  75,  71, 245,
+     14, 195,  50, 172, 116, 239,  35,  24,  63, 126, 105, 168, 147,  75, 185, 216, 116,  60,   0,  13, 106, 178, 201,  91,
+     43, 131, 149, 214, 111, 148,  65, 241, 195, 128, 235,  25, 120, 220,  60, 139,  27,  35, 107,  12,  63,  66,  22, 104,
+    234, 172, 115,  72,  18, 110, 102, 249,  53, 217, 232,   7,  93, 103, 200, 155, 121, 253,  11, 130, 143, 108,  50, 170,
+    166,  90,   4, 134,  90,  60, 247, 252, 188,   8, 127, 110,  39, 225, 114, 161,  56,   0,  91, 250, 199,  52,  46, 226,
+    110, 112,  31,  63,  86,  17, 144, 213,  18, 127, 245,  62, 134, 246, 198, 159,   5, 130, 105,  20, 180, 114,  77,  54,
+    228, 236, 145, 177,  27, 155, 216,  48, 156, 115, 253,  60, 188, 102, 143, 190, 206,  90,   9,  44, 226, 146,  82, 116,
+    249, 244,  60, 137, 176, 228, 132,  32,  86, 172, 171,  16, 232,  74,  18, 182, 163,  54,  79, 159,   1,  69, 246, 238,
+    191, 178, 154, 202, 240, 163, 136, 232, 175,  43, 193, 190,  81,  17, 157, 130, 187,  61, 133, 173,  25, 237, 179,  48,
+     60, 184, 240,  77,  98,  19, 217, 245,  71,  38, 228, 218, 116, 160,  61, 100, 146, 178,   6, 130, 198,  57, 152, 201,
+    218, 107, 167, 167,   9,  21, 223, 128, 186,  32,  64, 198, 240, 139, 181,  96,  50, 169, 159,   9,  70,  88, 177,  32,
+    227, 197,  63,  78, 132, 150, 203, 214,   8,   0, 101, 101, 176, 199, 129,  16,  82, 226, 104, 153,  23, 218, 232,   2,
+     90, 206, 175, 236, 128,  16,  21, 199, 138,  35, 198,  73,  35, 109, 225, 201,  15,  57,  55, 121, 205, 229,  99,  31,
+     45,  94, 215, 195, 139,   2, 171, 105,  89,  45,  43,  79, 202, 123,  76,  23,   4, 140,  58, 239, 249,  86,  36, 161,
+    220, 206,  66,  27, 247,  82, 106, 117, 162,   9, 207, 215,  34, 146, 179, 196,  18,  69, 135, 122, 195, 200,  27,  25,
+    225,  78,  80, 238, 242,  32, 101, 146,  30,  65, 130, 209,  76,  84, 148, 217,  95, 161, 135, 253,   2,  76, 225,  36,
+    101, 231, 202, 192,  37, 138,  88, 218, 145, 104,  28, 255, 242,  38,  44, 171, 158, 122, 249,  67,  61, 251, 203, 131,
+      4,  91, 181,  32,  59,  72, 130, 142,  30,  52,  68, 109, 194, 157,  49,  94, 231, 169,  75, 190, 153,   1,  95, 148,
+    246, 246, 118,  85, 183, 160, 142, 210, 255, 139, 111, 232,  31, 122,  67, 207, 222, 150,  12, 252, 122,  95, 165, 210,
+    110,  56, 210, 117, 142, 216, 121,  39,  10, 107,  87, 146, 151, 194,  45, 227,   3, 134, 128,  95,  82,  52, 148, 162,
+    104, 102, 238,   6,  44, 242, 176,  52,  99, 155, 160, 189,  46,  89, 179, 230, 206,  14, 249, 136,  44, 185, 234,  58,
+     25, 100, 213,   3, 164, 187,  75, 151, 126, 109,  15,  49, 250,  70, 116, 174, 215,   6, 170,  61,  94, 186, 118,  88,
+    191, 224,  85,  20,  31, 148, 114,  55, 235, 210, 145, 183, 210, 239, 168, 120, 246, 180, 115, 221, 217,  66,  96, 254,
+    170,  49, 114, 127,   6, 235, 213,  97, 135,  43,  36, 184,  70,   7,  23, 111,  85,  41, 178,  78, 201, 172, 126,  57,
+    159,  25,  98, 180, 252,   6,  32, 148, 225, 184,  90,  75,  47,  11, 173, 179, 206, 251, 111,  69, 195,  43, 221, 161,
+     71,  25, 230, 182, 189, 234,  56,  30, 205, 221, 161, 176,  73,  82, 126, 140, 212, 217,  16,  10, 137, 124,  70, 173,
+      3, 222, 103, 109, 175,  36, 117, 153, 184, 229,  56, 121, 112,  54,  32, 239, 211,  23, 172, 203, 151, 245,  52, 121,
+      8, 155,  75, 228, 207, 128,  17,  26,  55, 159, 138, 192, 221,  80, 160, 172,  47,   6,  77, 105,  16, 158,  97,  14,
+     43,  84, 157,  31,  11, 134, 143,  19,  29, 211, 255,  84, 179,  31,  58, 165, 194, 207, 165, 133, 236,  64, 213, 253,
+    156, 190,  57,  20,  15, 242, 243,  92,  48, 222, 206, 129, 183,  68,  62, 225, 150,  34, 186, 244,  23, 152, 231,  92,
+     57, 131, 160,   2,  19, 216, 131,  90, 173, 244, 113,  72,  15, 112, 253, 141,  31,  62,  91, 127,   2, 194, 248,  38,
+     56, 113, 187,  61, 230, 251, 118,  42, 196,  80,  55, 193, 152, 247,  12,  18,  80,  82, 252, 205, 194, 168, 145,  91,
+    233, 132,  64, 160,  98,  17, 237,  89, 194,  45, 125, 200, 146,  74, 239, 242, 174, 108, 202,  45,  21, 232,  92, 119,
+    189, 243, 250,  41, 119,  63, 219, 208, 191, 246,  79, 166, 240, 200, 201, 107,  72, 146,  44, 182, 126, 220,  80,  71,
+     17,  15,  92, 104, 112, 222,   4, 152, 130,  53, 233, 163, 105, 108, 150, 145,  78,  37,  20, 193, 136, 112,  84, 169,
+      8,  96, 239, 127, 102, 201, 134,  47,  77, 232, 246, 183,  41, 115,  94, 144, 239,  50,  50, 202, 162,   4, 137, 170,
+    107, 255, 224,  21, 174,  98, 148, 236, 112, 171,  29, 198,  84,  96, 163, 157, 244,  21,  91,  61, 232, 129, 204, 176,
+    140,  48,  41, 140,  96,  12,   7, 221,  87,  59,  40,  81, 131, 227, 176, 189,  29, 107,  62,  13, 223, 146,  41,  54,
+    106, 203,  69, 136, 126,  24, 229,  94,  33, 201, 138, 140,  64, 187, 162, 125,  24, 101, 128,  44,  55,  70, 106, 235,
+    182,   9, 216,  58, 158, 112, 238, 140, 204, 242, 142, 197,  53,  33, 186,  91,  76, 124, 206, 217,  42,   4, 192, 208,
+    119,  76, 233, 248, 172,  12, 107,  53, 212, 233,  52,  18, 166,  66, 201, 168,   1,  31, 214,  81, 146, 206, 189,  15,
+     29, 176,  87, 131, 220, 225,  69,  81, 197,  48, 130, 207,  37, 158,  78,   5, 208,  76, 236,  27, 142, 138,  39, 210,
+     19, 232, 131, 167,  69,  92,  30, 226, 173, 110, 124, 244, 237,  39, 158, 194, 183, 114, 203, 174,  14,  35, 220, 140,
+    111, 247, 160, 166,  91, 221,   6,  94, 164,   3, 248, 165,  13, 217, 168,  56, 105, 156, 180,  75,   1,  29, 242, 225,
+     94,  17, 150, 150, 231, 192,   5,  86, 138, 167,  92, 249,  22,  25, 108, 161,  38,  50, 227,  79, 167, 168, 249,  13,
+     28, 239,  96,  73, 170, 183,   8,  56, 218, 166,  60, 139,  38,  88, 244, 212, 123, 144, 146, 182,  30, 113,  89, 217,
+    121, 101, 172, 159, 106,  58,  65, 248, 211, 104, 143,  37,   7,  94, 171, 150,  22, 184,  57, 115, 241,  63, 181, 223,
+     17, 126, 102, 243,  64,  51, 180, 115, 220, 149, 160,  38, 105, 202, 224,   8,  53,  70, 209, 184,  23,  97,  68, 148,
+    118, 253, 246,   3, 142, 216,  78,  55,  46,  78, 253,  27, 186, 120, 135, 188, 212, 251,  86,  66, 144, 124,  60, 183,
+    205,   9,  81, 250, 214,  91,  52, 165, 198,  57,  34, 231, 212, 128, 168,  35,  40, 117, 245, 201,  66,  95, 187, 228,
+    129, 128,  73, 183,  14, 113, 121, 203, 151, 149, 224,  40,  66, 135, 139, 114,  85, 232, 162,  27, 202, 188,  12, 119,
+     70,  33, 196,  81, 255, 255,  63,   8, 232, 133,  48, 235,  17,  25, 250, 153, 125,  67, 182, 190,  99, 242, 247,  12,
+    119, 216, 210,  33,  89, 141, 139, 181,  51,  92, 168, 156, 205, 189, 117,   0,  44, 255, 198,  83,  10, 141, 167, 118,
+     84, 217, 109, 161, 179,  24, 221,  76,  32,  49,  54, 122,  96,  92, 170, 185, 214, 132,  21, 213,  67,  62, 112,  38,
+     50, 145,  30,  85, 191, 234, 234,  35,  43, 113, 152, 214, 127, 132, 108, 203, 176, 111,  70, 177, 115,   3,  81, 215,
+    194, 142, 122,  47, 221,  76,   0, 193, 155,   1, 213,  41,  93, 251, 197,  61,  40,  99, 111, 226, 188, 199, 255,  20,
+     26,  97, 106,  47, 145, 242,  94, 159, 175,  60,  25, 208, 100, 150, 184,  54, 135, 197, 203,  74,  85, 181, 165, 121,
+     26, 223,  53, 140, 226,  28,  36, 123,  72,  75, 159,  97,   5, 250, 194,  17, 120,  41, 255, 220,   8,  71,  86, 106,
+    138,  54,  62, 214, 250, 181, 145,  30, 235,  51,   3, 124, 140, 229,  92, 198, 154, 170, 189, 232, 232, 157,   0, 206,
+    126,  15, 148, 173, 198, 229, 240, 110, 169, 177, 222,  21, 117, 200,  94,  97,   9, 162, 254,  63,  30,  40, 226,  14,
+     10,  76, 142, 255, 250,  97,  20,  66, 149, 239,  52, 175, 170,  19, 101, 151, 247, 102,  49, 215, 175, 137,  64,  27,
+    240, 177,   4,   7,  50,  84, 125, 170, 171, 221, 237, 128,  47,  72, 216,   1, 132, 227, 225,  98, 157,  25,  40, 173,
+     10, 116, 153,  38, 222, 212, 115,   0, 196,  85,  81,  48, 155, 202, 134, 156, 188, 228, 238, 167,  98, 195, 220,  59,
+     34, 121,  75, 201, 152,  26, 230, 169, 185, 125,  90,  10, 114,  75,  36, 153,  69, 236, 195,  68,  51,   6, 255, 135,
+     13, 103,  73,  18, 112,  68, 205,  41,  60, 106,  99,  81,  33, 155,  80,  10,   4, 239, 139, 129,  70,  52, 175, 224,
+    135, 140, 186, 187,  74, 235, 162, 171,  96, 149, 188,  46,  56, 197, 215, 157,  98,  29, 204, 107,  32, 204,  76, 245,
+    141,  65,  24, 165, 125,  86, 217, 234, 141, 125, 161, 154,  92, 250, 208,  63,  72, 143,   9, 204, 184, 180,  79, 112,
+     17, 169,  56, 135, 119, 200, 242,  88,  73, 245, 103, 143,  32,  96,  58, 164, 240, 253,   3, 111, 209, 178, 107,  66,
+     16,  41,  47,   3, 147, 105,  63, 149, 165, 240, 209,  87, 105, 139,  27, 227, 239,  95,  14, 197, 214, 244, 188, 103,
+    129, 192, 218, 172, 117,  90, 167, 211, 210,  37, 131, 244,  28, 149, 152, 220, 243, 128, 176, 250, 223,  46, 155,  99,
+    106, 191, 203,  76,  19, 168, 239,   0,  45,  81, 113,  24, 215, 116,  51,  89, 236, 223,  31, 133, 130,  19, 163, 114,
+     13, 212, 229,  83, 120, 135, 183,  50, 232, 118, 200,  17, 102, 190,  17,  48,  78,  75, 192, 187, 235,  43,  29, 109,
+    140,  11, 225,  35, 117,  88, 152, 250, 248,  29, 188,  50,  85, 234, 206,   6, 167,  62, 230, 218, 183,  22, 127, 189,
+    149,  63,  94,  14, 174, 218,  65,  92, 223, 240, 124, 130, 181, 212,  19,  77, 234, 173, 131,  11,  51, 186, 171,  38,
+    124, 155, 154,  58,  53, 133, 163,  16,  17,  39,  96, 142,  26, 251,  82,  55,  43, 178, 237, 119, 178,  88,  87, 189,
+     44,   0,  16, 180, 123,  69,  49, 207, 182, 147, 230,  32,  60, 254, 158, 105, 195, 197,  88, 245,  13,  55, 145, 207,
+    120,  10, 200,  68,  68, 182, 241, 230,  83,  41, 144, 166,  60,   5,   7, 218,  87, 175,  42, 229, 164, 145, 251, 209,
+     38, 116, 113,  23,  58, 200, 178, 235, 102, 165,  41, 218, 201,  59,  61, 150, 104, 190,  33,  77, 142, 126,   0, 156,
+     50, 179, 134, 112,  20,  48,  77, 127, 217, 230,  45, 147, 254, 120,  29,  23, 196, 152,  74, 184, 247,  46, 107,  27,
+     82, 226,   0,  55, 199, 109,  70, 249,  32,  20, 226, 176, 105, 220,  78,  83, 247, 205, 177, 109, 227,  23, 148, 156,
+    195,  76, 103, 200,  62,  28, 200,  59, 137, 230, 213, 142,  75,  28, 252, 226,  91, 120,  37,  57, 129, 210, 104, 157,
+     26, 131, 244,  38, 172, 154, 207, 178,  81, 125,   2, 244, 172,  94, 113, 141,  44,  73, 197, 248, 252, 194, 154,  94,
+    218,  32, 129,  72,  67, 101, 181,   3, 137, 244, 227, 138,  11,  93, 154,  72, 248, 120,  83, 185, 165, 100,   6,   8,
+    233, 225, 174, 107, 216, 205, 112,  39, 197,  83,  93, 238, 244, 198, 190, 158,  12,  78, 165,  39, 118, 173, 141, 198,
+     91,  71, 163,  99,  35, 253, 142, 114, 190, 136, 161, 159, 250, 207,  98,  72, 144, 235, 183, 112,   4,  46, 202, 164,
+    136, 232,  48,  61,  66, 126, 126, 220,  21,  11, 163, 240,   5, 137, 248, 169, 109,  93, 160, 112, 191, 164,   8,  85,
+    146,   7, 171, 179, 207,  89,  75,  17, 218,  65, 133, 227,  66, 102,  33,  75, 250,  32, 103, 200, 223,  52,  27, 163,
+    181,  22, 125, 125,  99,  58,  33, 154, 175, 133, 108, 254, 234,  42,   3, 163,  85,  65, 206, 179, 126, 220,  68,  15,
+    191, 144,  21,  47, 134, 233, 209, 132,  76,  64, 128, 166,  54,  13, 254, 252,  30, 136, 158,  26,  61,  98, 144,   5,
+    100, 207, 204, 104,  57, 248, 228,  54,  10, 221, 212,   8,  55, 170, 230,  64,  27, 192, 114,  85,  46,   3, 212, 127,
+     87, 146,  58,  26, 235, 199, 115, 100,  33,   0, 155, 151, 199, 190, 242,  91,  79, 163, 214, 107, 121,  40,  39, 215,
+     81,  17,  23, 246,  59,  44, 221, 192, 116, 240,  29, 138, 237, 219,   3, 117, 157, 173,  47, 193, 115,   5, 154, 238,
+    185, 147, 137, 110,  58,   8, 155, 216, 238, 186,  10, 106,  71, 237, 211,  11,  55, 181,  23, 108, 150, 196, 199, 214,
+     47, 112, 169,  32,  95,  55,  35, 161, 220, 255, 112,  26, 242, 196,  42, 160, 154,  36,  23, 215,  97,  91, 168, 184,
+     80,  69, 222, 217, 118, 173,  42,  62, 235, 236,  26, 134,  79,  18, 156,  88, 112, 142, 184, 119, 128, 207,  94,  21,
+    205, 236,  73,  39, 154, 219,  13, 182,
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <simd/simd.h>
+
+#include <cstdint>
+
+namespace reference {
+
+constexpr uint32_t BLUE_NOISE_SIZE = 64;
+
+// Two independent 64x64 blue noise masks, interleaved, tiling without seams. Each was made
+// with void and cluster on the torus: gaussian energy with sigma 1.5 cut off at 6 pixels,
+// a 10% initial pattern from a fixed seed (1 and 2), ranks scaled to 0..255 so every value
+// appears 16 times.
+extern const uint8_t BLUE_NOISE[BLUE_NOISE_SIZE * BLUE_NOISE_SIZE * 2];
+
+// Both masks at a pixel, wrapped, as values in [0, 1)
+inline simd::float2 blueNoise(uint32_t x, uint32_t y) {
+    const uint8_t* texel = BLUE_NOISE + ((y % BLUE_NOISE_SIZE) * BLUE_NOISE_SIZE + x % BLUE_NOISE_SIZE) * 2;
+    return simd::float2{(texel[0] + 0.5f) / 256.0f, (texel[1] + 0.5f) / 256.0f};
+}
+
+}
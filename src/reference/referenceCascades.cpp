@@ -0,0 +1,517 @@
+#include "referenceCascades.hpp"
+#include "referenceBlueNoise.hpp"
+#include "../core/taskScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+using namespace reference;
+
+namespace {
+
+// Rays per task, enough that scheduling stays small next to the tracing
+constexpr size_t RAYS_PER_TASK = 16384;
+
+// Magic numbers of the kernel, the first interval ends at this distance and every level
+// is four times as long as the one below
+constexpr float BASE_CASCADE_RANGE = 0.016f;
+constexpr float CASCADE_RANGE_MULTIPLIER = 4.0f;
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+simd::float4 combine(simd::float4 traced, simd::float4 upper) {
+    simd::float3 rgb = xyz(traced) + xyz(upper) * traced.w;
+    return simd::float4{rgb.x, rgb.y, rgb.z, traced.w * upper.w};
+}
+
+}
+
+simd::float2 CascadeLevelLayout::probeUV(uint32_t probe) const {
+    return simd::float2{(probe % gridX + 0.5f) / gridX, (probe / gridX + 0.5f) / gridY};
+}
+
+simd::float3 CascadeLevelLayout::rayDirection(uint32_t ray) const {
+    return rayDirection(ray, simd::float2{0.5f, 0.5f});
+}
+
+simd::float3 CascadeLevelLayout::rayDirection(uint32_t ray, simd::float2 cellOffset) const {
+    return octDecode(simd::float2{(ray % raysPerDim + cellOffset.x) / raysPerDim, (ray / raysPerDim + cellOffset.y) / raysPerDim});
+}
+
+CascadeLevelLayout makeCascadeLevelLayout(int level, uint32_t width, uint32_t height, const ReferenceCascadeSettings& settings) {
+    CascadeLevelLayout layout;
+    layout.level = level;
+    layout.tileSize = settings.probeSpacing * (1u << level);
+    layout.gridX = (width + layout.tileSize - 1) / layout.tileSize;
+    layout.gridY = (height + layout.tileSize - 1) / layout.tileSize;
+    layout.raysPerDim = settings.baseRaysPerDim << level;
+    layout.numRays = layout.raysPerDim * layout.raysPerDim;
+
+    float start = (level == 0) ? 0.0f : BASE_CASCADE_RANGE * std::pow(CASCADE_RANGE_MULTIPLIER, float(level - 1));
+    float end = BASE_CASCADE_RANGE * std::pow(CASCADE_RANGE_MULTIPLIER, float(level));
+    layout.intervalStart = start * settings.intervalLength;
+    layout.intervalEnd = end * settings.intervalLength;
+    return layout;
+}
+
+ReferenceCascades::ReferenceCascades(const ReferenceScene& scene, TaskScheduler& scheduler, const ReferenceCascadeSettings& settings)
+: scene(scene)
+, scheduler(scheduler)
+, settings(settings) {
+}
+
+bool ReferenceCascades::resize(uint32_t width, uint32_t height) {
+    bool changed = levels.size() != size_t(settings.levels);
+    levels.resize(settings.levels);
+    for (int l = 0; l < settings.levels; l++) {
+        Level& level = levels[l];
+        CascadeLevelLayout layout = makeCascadeLevelLayout(l, width, height, settings);
+        changed = changed || layout.gridX != level.layout.gridX || layout.gridY != level.layout.gridY;
+        level.layout = layout;
+        level.traced.resize(level.layout.rayCount());
+        level.merged.resize(level.layout.rayCount());
+        level.probes.resize(level.layout.probeCount());
+    }
+    return changed;
+}
+
+void ReferenceCascades::render(const ReferenceGBuffer& buffer, const FrameData& frame, CascadeSchedule schedule, uint32_t levelMask) {
+    gBuffer = &buffer;
+    frameData = &frame;
+    if (resize(frame.framebuffer_width, frame.framebuffer_height)) {
+        levelMask = ALL_LEVELS;
+    }
+    levelMask &= (1u << levelCount()) - 1;
+    for (int l = 0; l < levelCount(); l++) {
+        if (levelMask & (1u << l)) levels[l].tracedFrame = frame.frame_index;
+    }
+
+    stats = {};
+    auto start = Clock::now();
+    if (settings.probeTable) {
+        auto probeStart = Clock::now();
+        buildProbeTables();
+        stats.probeMs = elapsedMs(probeStart);
+    }
+    classifyProbes();
+    if (schedule == CascadeSchedule::Fused) {
+        renderFused(levelMask);
+    } else {
+        renderSplit(levelMask);
+    }
+    stats.totalMs = elapsedMs(start);
+
+    stats.liveRays.resize(levelCount());
+    for (int l = 0; l < levelCount(); l++) {
+        stats.liveRays[l] = uint64_t(levels[l].liveProbes.size()) * levels[l].layout.numRays;
+        if (levelMask & (1u << l)) stats.raysTraced += stats.liveRays[l];
+        stats.skippedProbes += levels[l].layout.probeCount() - levels[l].liveProbes.size();
+    }
+    stats.tracedLevels = levelMask;
+    countProbeWork(levelMask);
+    countMergeWork();
+    gBuffer = nullptr;
+    frameData = nullptr;
+}
+
+void ReferenceCascades::renderFused(uint32_t levelMask) {
+    // One dependent dispatch per level, like dispatchRaytracing
+    for (int l = levelCount() - 1; l >= 0; l--) {
+        Level& level = levels[l];
+        const uint32_t numRays = level.layout.numRays;
+        size_t probesPerTask = std::max<size_t>(RAYS_PER_TASK / numRays, 1);
+        bool top = (l == levelCount() - 1);
+        bool retrace = (levelMask & (1u << l)) != 0;
+
+        scheduler.parallelForRange(level.liveProbes.size(), probesPerTask, [&](size_t begin, size_t end) {
+            for (size_t live = begin; live < end; live++) {
+                uint32_t probe = level.liveProbes[live];
+                UpperProbes upper = top ? UpperProbes{} : upperProbes(level, probe);
+                for (uint32_t ray = 0; ray < numRays; ray++) {
+                    size_t index = size_t(probe) * numRays + ray;
+                    simd::float4 traced = retrace ? trace(level, probe, ray) : level.traced[index];
+                    level.traced[index] = traced;
+                    level.merged[index] = top ? traced : combine(traced, mergeUpper(level, upper, ray));
+                }
+            }
+        });
+
+        if (settings.prefilterUpper && l > 0) {
+            prefilter(level);
+        }
+    }
+}
+
+void ReferenceCascades::renderSplit(uint32_t levelMask) {
+    // Tracing needs nothing from the other levels, so the probes of all of them go into
+    // one parallel loop and no level waits for another
+    struct Range {
+        int         level;
+        uint32_t    begin;
+        uint32_t    end;
+    };
+    std::vector<Range> ranges;
+    for (int l = levelCount() - 1; l >= 0; l--) {
+        if (!(levelMask & (1u << l))) continue;
+        const Level& level = levels[l];
+        const uint32_t liveCount = uint32_t(level.liveProbes.size());
+        uint32_t probesPerTask = std::max<uint32_t>(uint32_t(RAYS_PER_TASK / level.layout.numRays), 1);
+        for (uint32_t begin = 0; begin < liveCount; begin += probesPerTask) {
+            ranges.push_back({l, begin, std::min(begin + probesPerTask, liveCount)});
+        }
+    }
+
+    auto traceStart = Clock::now();
+    scheduler.parallelFor(ranges.size(), [&](size_t r) {
+        Level& level = levels[ranges[r].level];
+        const uint32_t numRays = level.layout.numRays;
+        for (uint32_t live = ranges[r].begin; live < ranges[r].end; live++) {
+            uint32_t probe = level.liveProbes[live];
+            for (uint32_t ray = 0; ray < numRays; ray++) {
+                level.traced[size_t(probe) * numRays + ray] = trace(level, probe, ray);
+            }
+        }
+    });
+    stats.traceMs = elapsedMs(traceStart);
+
+    // The merge still goes top down, but every step is only interpolation
+    auto mergeStart = Clock::now();
+    for (uint32_t probe : levels.back().liveProbes) {
+        size_t first = size_t(probe) * levels.back().layout.numRays;
+        std::copy_n(levels.back().traced.begin() + first, levels.back().layout.numRays, levels.back().merged.begin() + first);
+    }
+    if (settings.prefilterUpper && levelCount() > 1) {
+        prefilter(levels.back());
+    }
+    for (int l = levelCount() - 2; l >= 0; l--) {
+        Level& level = levels[l];
+        const uint32_t numRays = level.layout.numRays;
+        size_t probesPerTask = std::max<size_t>(RAYS_PER_TASK / numRays, 1);
+
+        scheduler.parallelForRange(level.liveProbes.size(), probesPerTask, [&](size_t begin, size_t end) {
+            for (size_t live = begin; live < end; live++) {
+                uint32_t probe = level.liveProbes[live];
+                UpperProbes upper = upperProbes(level, probe);
+                for (uint32_t ray = 0; ray < numRays; ray++) {
+                    size_t index = size_t(probe) * numRays + ray;
+                    level.merged[index] = combine(level.traced[index], mergeUpper(level, upper, ray));
+                }
+            }
+        });
+
+        if (settings.prefilterUpper && l > 0) {
+            prefilter(level);
+        }
+    }
+    stats.mergeMs = elapsedMs(mergeStart);
+}
+
+void ReferenceCascades::buildProbeTables() {
+    // Levels that keep their traced intervals still need the current positions for the merge
+    for (Level& level : levels) {
+        scheduler.parallelForRange(level.layout.probeCount(), 256, [&](size_t begin, size_t end) {
+            for (size_t probe = begin; probe < end; probe++) {
+                level.probes[probe] = computeProbe(level.layout, uint32_t(probe));
+            }
+        });
+    }
+}
+
+void ReferenceCascades::classifyDensity(std::vector<uint8_t>& needed) {
+    const CascadeLevelLayout& layout = levels[0].layout;
+    density.size = 2 * layout.tileSize;
+    density.countX = (gBuffer->width + density.size - 1) / density.size;
+    density.countY = (gBuffer->height + density.size - 1) / density.size;
+    density.coarse.assign(size_t(density.countX) * density.countY, 0);
+
+    // The mip whose texels cover exactly one block. Blocks cut off by the framebuffer
+    // edge are not in it and stay fine.
+    ReferenceDepthPyramid pyramid = buildDepthPyramid(*gBuffer);
+    const uint32_t mip = uint32_t(std::log2(float(density.size)));
+
+    scheduler.parallelFor(density.countY, [&](size_t by) {
+        for (uint32_t bx = 0; bx < density.countX; bx++) {
+            simd::float2 minMax = pyramid.at(mip, bx, uint32_t(by));
+            if (minMax.x <= 0.0f || minMax.y - minMax.x > minMax.x * settings.flatDepthRatio) continue;
+
+            simd::float3 normalSum{0.0f, 0.0f, 0.0f};
+            for (uint32_t y = uint32_t(by) * density.size; y < (uint32_t(by) + 1) * density.size; y++) {
+                for (uint32_t x = bx * density.size; x < (bx + 1) * density.size; x++) {
+                    normalSum += xyz(gBuffer->normal[size_t(y) * gBuffer->width + x]);
+                }
+            }
+            float spread = 1.0f - simd::length(normalSum) / float(density.size * density.size);
+            density.coarse[by * density.countX + bx] = spread < settings.flatNormalSpread;
+        }
+    });
+
+    // The coarse probes, every other one, are always needed. Pixels of fine blocks read the
+    // two probes around them in each direction, with the coordinates of the gather.
+    needed.assign(layout.probeCount(), 0);
+    for (uint32_t y = 0; y < layout.gridY; y += 2) {
+        for (uint32_t x = 0; x < layout.gridX; x += 2) {
+            needed[size_t(y) * layout.gridX + x] = 1;
+        }
+    }
+    auto probeRange = [](uint32_t firstPixel, uint32_t lastPixel, uint32_t pixels, uint32_t grid) {
+        auto base = [&](uint32_t pixel) {
+            float coord = (pixel + 0.5f) / pixels * grid - 0.5f;
+            return std::clamp(int(std::floor(coord)), 0, std::max(int(grid) - 2, 0));
+        };
+        return std::make_pair(base(firstPixel), std::min(base(lastPixel) + 1, int(grid) - 1));
+    };
+    for (uint32_t by = 0; by < density.countY; by++) {
+        for (uint32_t bx = 0; bx < density.countX; bx++) {
+            if (density.coarse[size_t(by) * density.countX + bx]) continue;
+            auto [firstX, lastX] = probeRange(bx * density.size, std::min((bx + 1) * density.size, gBuffer->width) - 1, gBuffer->width, layout.gridX);
+            auto [firstY, lastY] = probeRange(by * density.size, std::min((by + 1) * density.size, gBuffer->height) - 1, gBuffer->height, layout.gridY);
+            for (int y = firstY; y <= lastY; y++) {
+                for (int x = firstX; x <= lastX; x++) {
+                    needed[size_t(y) * layout.gridX + x] = 1;
+                }
+            }
+        }
+    }
+}
+
+void ReferenceCascades::classifyProbes() {
+    const bool skip = settings.skipEmptyProbes && settings.probeTable;
+    std::vector<uint8_t> needed;
+    density = {};
+    if (settings.adaptiveDensity) {
+        classifyDensity(needed);
+    }
+
+    for (int l = 0; l < levelCount(); l++) {
+        Level& level = levels[l];
+        const uint32_t numRays = level.layout.numRays;
+        level.liveProbes.clear();
+
+        if (!skip && needed.empty()) {
+            level.liveProbes.resize(level.layout.probeCount());
+            std::iota(level.liveProbes.begin(), level.liveProbes.end(), 0u);
+            continue;
+        }
+
+        // Nothing in front of the far plane, so every interval misses and the merge just
+        // hands the sky down. Lower levels still read these probes in their merge.
+        level.sky.resize(numRays);
+        for (uint32_t ray = 0; ray < numRays; ray++) {
+            level.sky[ray] = missRadiance(level.layout.rayDirection(ray));
+        }
+        const bool top = (l == levelCount() - 1);
+        const simd::float4 nothing{0.0f, 0.0f, 0.0f, 1.0f};
+
+        for (uint32_t probe = 0; probe < level.layout.probeCount(); probe++) {
+            // Probes left out by the adaptive density are never read, they keep what they had
+            if (l == 0 && !needed.empty() && !needed[probe]) continue;
+            if (!skip || level.probes[probe].valid) {
+                level.liveProbes.push_back(probe);
+                continue;
+            }
+            size_t first = size_t(probe) * numRays;
+            std::copy(level.sky.begin(), level.sky.end(), level.merged.begin() + first);
+            if (top) {
+                std::copy(level.sky.begin(), level.sky.end(), level.traced.begin() + first);
+            } else {
+                std::fill_n(level.traced.begin() + first, numRays, nothing);
+            }
+        }
+    }
+}
+
+void ReferenceCascades::countProbeWork(uint32_t levelMask) {
+    for (int l = 0; l < levelCount(); l++) {
+        const Level& level = levels[l];
+        if (settings.probeTable) {
+            stats.depthFetches += level.layout.probeCount();
+            for (const Probe& probe : level.probes) {
+                if (!probe.valid) stats.emptyProbes++;
+            }
+            continue;
+        }
+
+        // One position per traced ray, then the probe itself and the four upper probes for
+        // the merge weights of every probe below the top level
+        if (levelMask & (1u << l)) stats.depthFetches += level.layout.rayCount();
+        if (l < levelCount() - 1) stats.depthFetches += 5 * uint64_t(level.layout.probeCount());
+    }
+    stats.positionTransforms = stats.depthFetches;
+}
+
+void ReferenceCascades::countMergeWork() {
+    for (int l = 0; l < levelCount() - 1; l++) {
+        const CascadeLevelLayout& layout = levels[l].layout;
+        const uint64_t mergedRays = uint64_t(levels[l].liveProbes.size()) * layout.numRays;
+        if (settings.prefilterUpper) {
+            // Four cells averaged per prefiltered cell, then one per upper probe
+            stats.mergeFetches += 4 * uint64_t(levels[l + 1].layout.probeCount()) * layout.numRays + 4 * mergedRays;
+        } else {
+            stats.mergeFetches += 16 * mergedRays;
+        }
+    }
+}
+
+void ReferenceCascades::prefilter(Level& level) {
+    auto start = Clock::now();
+
+    // The level below has half the rays per dimension, and each of its cell centers lies on
+    // the corner between four cells of this level. The four direction taps of the merge
+    // weigh those cells equally, so their plain average is the same interpolation.
+    const uint32_t raysPerDim = level.layout.raysPerDim;
+    const uint32_t lowerRaysPerDim = raysPerDim / 2;
+    const uint32_t lowerNumRays = lowerRaysPerDim * lowerRaysPerDim;
+    level.prefiltered.resize(size_t(level.layout.probeCount()) * lowerNumRays);
+
+    size_t probesPerTask = std::max<size_t>(RAYS_PER_TASK / level.layout.numRays, 1);
+    scheduler.parallelForRange(level.layout.probeCount(), probesPerTask, [&](size_t begin, size_t end) {
+        for (size_t probe = begin; probe < end; probe++) {
+            const simd::float4* rays = level.merged.data() + probe * level.layout.numRays;
+            simd::float4* filtered = level.prefiltered.data() + probe * lowerNumRays;
+            for (uint32_t y = 0; y < lowerRaysPerDim; y++) {
+                for (uint32_t x = 0; x < lowerRaysPerDim; x++) {
+                    const simd::float4* cell = rays + (2 * y) * raysPerDim + 2 * x;
+                    filtered[y * lowerRaysPerDim + x] = (cell[0] + cell[1] + cell[raysPerDim] + cell[raysPerDim + 1]) * 0.25f;
+                }
+            }
+        }
+    });
+    stats.prefilterMs += elapsedMs(start);
+}
+
+ReferenceCascades::Probe ReferenceCascades::computeProbe(const CascadeLevelLayout& layout, uint32_t index) const {
+    simd::float2 probeUV = layout.probeUV(index);
+    simd::float2 probeNDC{probeUV.x * 2.0f - 1.0f, -(probeUV.y * 2.0f - 1.0f)};
+
+    Probe probe;
+    probe.depth = gBuffer->sampleDepth(probeUV);
+    probe.worldPosition = reconstructWorldPositionFromLinearDepth(probeNDC, probe.depth, *frameData);
+    probe.valid = probe.depth < frameData->far_plane;
+    return probe;
+}
+
+simd::float3 ReferenceCascades::probeWorldPosition(const Level& level, uint32_t probe) const {
+    return settings.probeTable ? level.probes[probe].worldPosition : computeProbe(level.layout, probe).worldPosition;
+}
+
+simd::float2 ReferenceCascades::rayJitter(int l, uint32_t probe) const {
+    if (!settings.jitterRays) return simd::float2{0.5f, 0.5f};
+
+    const CascadeLevelLayout& layout = levels[l].layout;
+    // The levels read the tile at different places so their offsets do not line up
+    simd::float2 noise = blueNoise(probe % layout.gridX + 23 * layout.level, probe / layout.gridX + 41 * layout.level);
+    // R2 steps, which keep the offsets of the last few frames of a probe spread over the
+    // cell. Double so that late frames do not lose the fraction.
+    double frame = levels[l].tracedFrame;
+    return simd::float2{float(std::fmod(noise.x + frame * 0.7548776662466927, 1.0)),
+                        float(std::fmod(noise.y + frame * 0.5698402909980532, 1.0))};
+}
+
+simd::float4 ReferenceCascades::trace(const Level& level, uint32_t probe, uint32_t ray) const {
+    const CascadeLevelLayout& layout = level.layout;
+    simd::float3 worldPos = probeWorldPosition(level, probe);
+    simd::float3 rayDir = layout.rayDirection(ray, rayJitter(layout.level, probe));
+
+    ReferenceHit hit;
+    if (scene.intersect(worldPos, rayDir, layout.intervalStart, layout.intervalEnd, hit)) {
+        const ReferenceMaterial& material = scene.material(hit.triangle);
+        simd::float3 emitted = material.isEmissive ? material.color : simd::float3{0.0f, 0.0f, 0.0f};
+        return simd::float4{emitted.x, emitted.y, emitted.z, 0.0f};
+    }
+
+    // Only the top level sees the sky, lower levels get it through the merge
+    if (layout.level == levelCount() - 1) {
+        return missRadiance(rayDir);
+    }
+    return simd::float4{0.0f, 0.0f, 0.0f, 1.0f};
+}
+
+ReferenceCascades::UpperProbes ReferenceCascades::upperProbes(const Level& level, uint32_t probe) const {
+    const Level& upperLevel = levels[level.layout.level + 1];
+    const CascadeLevelLayout& upper = upperLevel.layout;
+    simd::float2 probeUV = level.layout.probeUV(probe);
+    simd::float3 currentWorldPos = probeWorldPosition(level, probe);
+
+    // Bilinear probe interpolation setup
+    simd::float2 upperGridCoord{probeUV.x * upper.gridX - 0.5f, probeUV.y * upper.gridY - 0.5f};
+    int upperBaseX = int(std::floor(upperGridCoord.x));
+    int upperBaseY = int(std::floor(upperGridCoord.y));
+    simd::float2 upperFrac{fract(upperGridCoord.x), fract(upperGridCoord.y)};
+
+    UpperProbes result;
+    simd::float3 probeWorldPos[4];
+    for (int i = 0; i < 4; i++) {
+        int x = std::clamp(upperBaseX + (i & 1), 0, int(upper.gridX) - 1);
+        int y = std::clamp(upperBaseY + (i >> 1), 0, int(upper.gridY) - 1);
+        result.index[i] = uint32_t(y) * upper.gridX + uint32_t(x);
+        probeWorldPos[i] = probeWorldPosition(upperLevel, result.index[i]);
+    }
+
+    result.weights = bilinearWeights(getBilinear3dRatioIter(probeWorldPos, currentWorldPos, upperFrac, 2));
+    return result;
+}
+
+simd::float4 ReferenceCascades::mergeUpper(const Level& level, const UpperProbes& upperProbes, uint32_t ray) const {
+    const Level& upperLevel = levels[level.layout.level + 1];
+    const CascadeLevelLayout& upper = upperLevel.layout;
+
+    simd::float4 accumulated{0.0f, 0.0f, 0.0f, 0.0f};
+    if (settings.prefilterUpper) {
+        for (int p = 0; p < 4; p++) {
+            accumulated += upperLevel.prefiltered[size_t(upperProbes.index[p]) * level.layout.numRays + ray] * component(upperProbes.weights, p);
+        }
+        return accumulated;
+    }
+
+    // Direction cells around the ray in the upper level
+    simd::float2 octDir = octEncode(level.layout.rayDirection(ray));
+    simd::float2 dirGridCoord{octDir.x * upper.raysPerDim - 0.5f, octDir.y * upper.raysPerDim - 0.5f};
+    int dirBaseX = int(std::floor(dirGridCoord.x));
+    int dirBaseY = int(std::floor(dirGridCoord.y));
+    simd::float4 dirWeights = bilinearWeights(simd::float2{fract(dirGridCoord.x), fract(dirGridCoord.y)});
+
+    for (int p = 0; p < 4; p++) {
+        float probeWeight = component(upperProbes.weights, p);
+        if (probeWeight <= 0.0f) continue;
+
+        const simd::float4* probeRays = upperLevel.merged.data() + size_t(upperProbes.index[p]) * upper.numRays;
+        simd::float4 probeRadiance{0.0f, 0.0f, 0.0f, 0.0f};
+        for (int d = 0; d < 4; d++) {
+            int x = std::clamp(dirBaseX + (d & 1), 0, int(upper.raysPerDim) - 1);
+            int y = std::clamp(dirBaseY + (d >> 1), 0, int(upper.raysPerDim) - 1);
+            probeRadiance += probeRays[y * upper.raysPerDim + x] * component(dirWeights, d);
+        }
+        accumulated += probeRadiance * probeWeight;
+    }
+    return accumulated;
+}
+
+simd::float4 ReferenceCascades::missRadiance(simd::float3 rayDir) const {
+    return (settings.sky || settings.sun) ? skyAndSun(rayDir) : simd::float4{0.0f, 0.0f, 0.0f, 1.0f};
+}
+
+simd::float4 ReferenceCascades::skyAndSun(simd::float3 rayDir) const {
+    simd::float3 result{0.0f, 0.0f, 0.0f};
+
+    if (settings.sun) {
+        simd::float3 sunDirection = simd::normalize(-xyz(frameData->sun_eye_direction));
+        const float sunSize = 0.97f;
+        if (simd::dot(rayDir, sunDirection) > sunSize) {
+            result += xyz(frameData->sun_color) * frameData->sun_specular_intensity;
+        }
+    }
+
+    if (settings.sky && rayDir.y > 0.0f) {
+        const simd::float3 skyZenithColor{0.0f, 0.4f, 0.8f};
+        const simd::float3 skyHorizonColor{0.3f, 0.6f, 0.8f};
+        simd::float3 skyGradient = lerp(skyHorizonColor, skyZenithColor, std::sqrt(rayDir.y));
+        result += skyGradient * (frameData->sun_specular_intensity * 0.5f);
+    }
+
+    return simd::float4{result.x, result.y, result.z, 1.0f};
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <simd/simd.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../core/cascadeConfig.hpp"
+#include "referenceCommon.hpp"
+#include "referenceFrame.hpp"
+#include "referenceScene.hpp"
+
+class TaskScheduler;
+
+// What dispatchRaytracing puts into CascadeData, plus the editor defaults
+struct ReferenceCascadeSettings {
+    int     levels = MAX_CASCADE_LEVEL;
+    int     probeSpacing = PROBE_SPACING;
+    float   intervalLength = 1.0f;
+    bool    sky = true;
+    bool    sun = true;
+    // Reconstruct every probe once per frame into a table instead of once per ray in the
+    // trace and five times per ray in the merge. Off only to measure the difference.
+    bool    probeTable = true;
+    // Average every finished level down to the rays of the level below, so its merge takes
+    // one sample per upper probe instead of four. Off only to measure the difference.
+    bool    prefilterUpper = true;
+    // Trace and merge only the probes with geometry under them. Probes on the far plane,
+    // which includes every probe of an empty tile, only see the sky and get it without
+    // tracing. Needs the probe table.
+    bool    skipEmptyProbes = true;
+    // Cascade 0 traces only every other probe in both directions on flat blocks of 2x2
+    // probes: the depth range from the min/max pyramid is below flatDepthRatio of the
+    // nearest depth and the normals spread less than flatNormalSpread, 1 minus the length
+    // of their average. The gather reads the coarse probes there.
+    bool    adaptiveDensity = false;
+    float   flatDepthRatio = 0.02f;
+    float   flatNormalSpread = 0.005f;
+    // Rays per side of the octahedral map of cascade 0, doubled every level. The kernel has 4.
+    uint32_t baseRaysPerDim = 4;
+    // Every ray samples a point of its octahedral cell that moves from frame to frame instead
+    // of the cell center, so accumulating frames integrates the cells. The point is the same
+    // for all rays of a probe: the blue noise of the probe, shifted every frame along the R2
+    // sequence by FrameData::frame_index. The gather weighs the rays by where they pointed,
+    // the 16 tap merge without prefilterUpper still reads the upper level at cell centers.
+    bool    jitterRays = false;
+};
+
+// Which cascade 0 blocks are flat enough for the coarse probes, one entry per block of
+// 2x2 probes. Empty unless adaptiveDensity is set.
+struct CascadeDensityBlocks {
+    uint32_t                size = 0;
+    uint32_t                countX = 0;
+    uint32_t                countY = 0;
+    std::vector<uint8_t>    coarse;
+
+    bool isCoarse(uint32_t pixelX, uint32_t pixelY) const {
+        return !coarse.empty() && coarse[size_t(pixelY / size) * countX + pixelX / size] != 0;
+    }
+};
+
+// Probe grid, rays and interval of one level, computed like the ray tracing kernel does
+struct CascadeLevelLayout {
+    int         level = 0;
+    uint32_t    tileSize = 0;
+    uint32_t    gridX = 0;
+    uint32_t    gridY = 0;
+    uint32_t    raysPerDim = 0;
+    uint32_t    numRays = 0;
+    float       intervalStart = 0.0f;
+    float       intervalEnd = 0.0f;
+
+    uint32_t probeCount() const { return gridX * gridY; }
+    size_t rayCount() const { return size_t(probeCount()) * numRays; }
+    // Screen UV of the probe center
+    simd::float2 probeUV(uint32_t probe) const;
+    // Center of the octahedral cell of the ray
+    simd::float3 rayDirection(uint32_t ray) const;
+    // A point inside the cell, cellOffset from 0 to 1 on both axes
+    simd::float3 rayDirection(uint32_t ray, simd::float2 cellOffset) const;
+};
+
+CascadeLevelLayout makeCascadeLevelLayout(int level, uint32_t width, uint32_t height, const ReferenceCascadeSettings& settings);
+
+// How the levels are computed. Both give the same radiance, they only differ in what may
+// run at the same time.
+enum class CascadeSchedule {
+    // Trace and merge in one pass per level, from the top level down, like raytracingKernel.
+    // A level can only start once the level above it is finished.
+    Fused,
+    // Traces every level at once into raw interval radiance and transmittance, then merges
+    // the levels top down in a separate, much cheaper pass
+    Split,
+};
+
+struct ReferenceCascadeStats {
+    // Building the probe tables, part of totalMs
+    double      probeMs = 0.0;
+    // Split only, Fused does both at once and only fills totalMs. The merge includes the
+    // prefiltering.
+    double      traceMs = 0.0;
+    double      mergeMs = 0.0;
+    double      prefilterMs = 0.0;
+    double      totalMs = 0.0;
+    uint64_t    raysTraced = 0;
+    // Rays of the live probes of every level, what tracing the level costs this frame
+    // whether it was traced or not
+    std::vector<uint64_t>   liveRays;
+    // Levels that were traced, bit N for level N. The others reused their stored intervals.
+    uint32_t    tracedLevels = 0;
+    // Depth samples and view to world transforms spent on probe positions
+    uint64_t    depthFetches = 0;
+    uint64_t    positionTransforms = 0;
+    // Probes of all levels whose depth sample saw only empty pixels
+    uint64_t    emptyProbes = 0;
+    // Probes that were not traced and merged: empty ones, resolved from the sky model, and
+    // the cascade 0 probes the adaptive density leaves out
+    uint64_t    skippedProbes = 0;
+    // Radiance samples read by the merge and the prefiltering
+    uint64_t    mergeFetches = 0;
+};
+
+// CPU version of the radiance cascades pass, for measuring changes to the algorithm before
+// they go into the Metal kernels. It follows ray_trace.metal step by step, except that the
+// radiance of a level is kept per probe and ray instead of in a texture: the merge reads
+// the four ray cells around a direction where the kernel takes four bilinear taps between
+// texels, which gives the same interpolation without the extra blur.
+class ReferenceCascades {
+public:
+    static constexpr uint32_t ALL_LEVELS = ~0u;
+
+    ReferenceCascades(const ReferenceScene& scene, TaskScheduler& scheduler, const ReferenceCascadeSettings& settings = {});
+
+    // Traces the levels in levelMask and keeps the traced intervals of the others from the
+    // last frame. Every level is merged again, so new radiance of an upper level still
+    // reaches the ones below. All levels are traced after a resize.
+    void render(const ReferenceGBuffer& gBuffer, const FrameData& frameData, CascadeSchedule schedule, uint32_t levelMask = ALL_LEVELS);
+
+    int levelCount() const { return static_cast<int>(levels.size()); }
+    const CascadeLevelLayout& layout(int level) const { return levels[level].layout; }
+    // Merged radiance of a level, probe major, the rays of a probe in octahedral cell order.
+    // The alpha is the transmittance of everything merged into the interval.
+    const std::vector<simd::float4>& radiance(int level) const { return levels[level].merged; }
+
+    const ReferenceCascadeSettings& getSettings() const { return settings; }
+    const ReferenceCascadeStats& getStats() const { return stats; }
+
+    // What the trace and the merge need to know about a probe, computed once per frame
+    struct Probe {
+        simd::float3    worldPosition;
+        float           depth = 0.0f;
+        // False when the depth sample only saw empty pixels, the probe sits on the far plane
+        bool            valid = false;
+    };
+    const std::vector<Probe>& probes(int level) const { return levels[level].probes; }
+    const CascadeDensityBlocks& densityBlocks() const { return density; }
+    // Where in their octahedral cells the rays of a probe pointed when the level was last
+    // traced, for CascadeLevelLayout::rayDirection. The cell centers without jitterRays.
+    simd::float2 rayJitter(int level, uint32_t probe) const;
+
+private:
+    struct Level {
+        CascadeLevelLayout          layout;
+        std::vector<Probe>          probes;
+        // Probes to trace and merge, all of them unless empty ones are skipped
+        std::vector<uint32_t>       liveProbes;
+        // What every ray of an empty probe sees, the sky model or nothing
+        std::vector<simd::float4>   sky;
+        // Radiance of the interval alone in rgb, 1 if the ray left it without a hit in alpha
+        std::vector<simd::float4>   traced;
+        std::vector<simd::float4>   merged;
+        // Merged radiance averaged down to the ray cells of the level below, probe major
+        std::vector<simd::float4>   prefiltered;
+        // FrameData::frame_index of the last trace, picks the jitter
+        uint32_t                    tracedFrame = 0;
+    };
+
+    // True when the probe grids changed and nothing stored can be reused
+    bool resize(uint32_t width, uint32_t height);
+    void renderFused(uint32_t levelMask);
+    void renderSplit(uint32_t levelMask);
+    void buildProbeTables();
+    // Fills the live probe lists and writes the sky into the empty probes
+    void classifyProbes();
+    // Marks the flat blocks and which cascade 0 probes the gather can do without
+    void classifyDensity(std::vector<uint8_t>& needed);
+    void countProbeWork(uint32_t levelMask);
+    void countMergeWork();
+    void prefilter(Level& level);
+
+    Probe computeProbe(const CascadeLevelLayout& layout, uint32_t probe) const;
+    // From the table, or reconstructed on the spot when it is turned off
+    simd::float3 probeWorldPosition(const Level& level, uint32_t probe) const;
+    simd::float4 trace(const Level& level, uint32_t probe, uint32_t ray) const;
+    // The four upper probes around a probe with their 3D-aware bilinear weights, the same
+    // for every ray of the probe
+    struct UpperProbes {
+        uint32_t        index[4];
+        simd::float4    weights;
+    };
+    UpperProbes upperProbes(const Level& level, uint32_t probe) const;
+    // Radiance of the level above coming in along the ray, interpolated between the upper
+    // probes and the four ray cells around the direction, or read from the prefiltered
+    // cell of the ray
+    simd::float4 mergeUpper(const Level& level, const UpperProbes& upper, uint32_t ray) const;
+    simd::float4 skyAndSun(simd::float3 rayDir) const;
+    // What a ray that hits nothing brings back from the top level
+    simd::float4 missRadiance(simd::float3 rayDir) const;
+
+    const ReferenceScene&       scene;
+    TaskScheduler&              scheduler;
+    ReferenceCascadeSettings    settings;
+    std::vector<Level>          levels;
+    CascadeDensityBlocks        density;
+
+    // Only set during render
+    const ReferenceGBuffer*     gBuffer = nullptr;
+    const FrameData*            frameData = nullptr;
+
+    ReferenceCascadeStats       stats;
+};
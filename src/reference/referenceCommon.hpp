@@ -0,0 +1,95 @@
+#pragma once
+
+#include <simd/simd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "../../data/shaders/shaderTypes.hpp"
+
+// C++ versions of the helpers the cascade shaders share, written so each one reads like
+// its Metal counterpart in common.hpp and ray_trace.metal.
+
+namespace reference {
+
+// Like Metal, NaN goes to 0, which the 3D bilinear ratios rely on when two probes coincide
+inline float saturate(float x) { return std::fmin(std::fmax(x, 0.0f), 1.0f); }
+inline float fract(float x) { return x - std::floor(x); }
+
+inline simd::float3 lerp(simd::float3 a, simd::float3 b, float t) { return a + (b - a) * t; }
+inline simd::float4 lerp(simd::float4 a, simd::float4 b, float t) { return a + (b - a) * t; }
+
+inline simd::float3 xyz(simd::float4 v) { return simd::float3{v.x, v.y, v.z}; }
+
+inline simd::float2 signNotZero(simd::float2 v) {
+    return simd::float2{(v.x >= 0.0f) ? 1.0f : -1.0f, (v.y >= 0.0f) ? 1.0f : -1.0f};
+}
+
+inline simd::float2 octEncode(simd::float3 n) {
+    float invL1 = 1.0f / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+    simd::float2 p{n.x * invL1, n.y * invL1};
+    if (n.z <= 0.0f) {
+        simd::float2 s = signNotZero(p);
+        p = simd::float2{(1.0f - std::abs(p.y)) * s.x, (1.0f - std::abs(p.x)) * s.y};
+    }
+    return simd::float2{p.x * 0.5f + 0.5f, p.y * 0.5f + 0.5f};
+}
+
+inline simd::float3 octDecode(simd::float2 f) {
+    f = simd::float2{f.x * 2.0f - 1.0f, f.y * 2.0f - 1.0f};
+    simd::float3 n{f.x, f.y, 1.0f - std::abs(f.x) - std::abs(f.y)};
+    if (n.z < 0.0f) {
+        simd::float2 s = signNotZero(simd::float2{n.x, n.y});
+        n = simd::float3{(1.0f - std::abs(f.y)) * s.x, (1.0f - std::abs(f.x)) * s.y, n.z};
+    }
+    return simd::normalize(n);
+}
+
+// Same reconstruction, including the bias against acne, as the ray tracing kernel. The
+// bias pulls the point towards the camera, 1 puts it on the surface.
+inline simd::float3 reconstructWorldPositionFromLinearDepth(simd::float2 ndc, float linearDepth, const FrameData& frameData,
+                                                            float depthBias = 0.98f) {
+    simd::float4 viewPos = matrix_multiply(frameData.projection_matrix_inverse, simd::float4{ndc.x, ndc.y, -1.0f, 1.0f});
+    viewPos = viewPos / viewPos.w;
+
+    float scale = linearDepth / std::abs(viewPos.z);
+
+    simd::float4 viewPosAtDepth{viewPos.x * scale * depthBias, viewPos.y * scale * depthBias, viewPos.z * scale * depthBias, 1.0f};
+    return xyz(matrix_multiply(frameData.view_matrix_inverse, viewPosAtDepth));
+}
+
+inline float projectLinePerpendicular(simd::float3 lineStart, simd::float3 lineEnd, simd::float3 point) {
+    simd::float3 line = lineEnd - lineStart;
+    return saturate(simd::dot(point - lineStart, line) / simd::dot(line, line));
+}
+
+// 3D-aware bilinear ratios of dstPoint between four probes laid out as a 2x2 quad
+inline simd::float2 getBilinear3dRatioIter(const simd::float3 srcPoints[4], simd::float3 dstPoint, simd::float2 initRatio, int iterCount) {
+    simd::float2 ratio = initRatio;
+
+    for (int i = 0; i < iterCount; i++) {
+        simd::float3 mixedY1 = lerp(srcPoints[0], srcPoints[2], ratio.y);
+        simd::float3 mixedY2 = lerp(srcPoints[1], srcPoints[3], ratio.y);
+        ratio.x = projectLinePerpendicular(mixedY1, mixedY2, dstPoint);
+
+        simd::float3 mixedX1 = lerp(srcPoints[0], srcPoints[1], ratio.x);
+        simd::float3 mixedX2 = lerp(srcPoints[2], srcPoints[3], ratio.x);
+        ratio.y = projectLinePerpendicular(mixedX1, mixedX2, dstPoint);
+    }
+
+    return ratio;
+}
+
+inline simd::float4 bilinearWeights(simd::float2 ratio) {
+    return simd::float4{(1.0f - ratio.x) * (1.0f - ratio.y),
+                        ratio.x * (1.0f - ratio.y),
+                        (1.0f - ratio.x) * ratio.y,
+                        ratio.x * ratio.y};
+}
+
+inline float component(simd::float4 v, int i) {
+    return i == 0 ? v.x : i == 1 ? v.y : i == 2 ? v.z : v.w;
+}
+
+}
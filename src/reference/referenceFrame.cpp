@@ -0,0 +1,182 @@
+#include "referenceFrame.hpp"
+#include "../core/taskScheduler.hpp"
+
+#include "AAPLMathUtilities.h"
+
+using namespace reference;
+
+simd::float3 ReferenceCamera::front() const {
+    const float toRadians = float(M_PI) / 180.0f;
+    simd::float3 direction{std::cos(yaw * toRadians) * std::cos(pitch * toRadians),
+                           std::sin(pitch * toRadians),
+                           std::sin(yaw * toRadians) * std::cos(pitch * toRadians)};
+    return simd::normalize(direction);
+}
+
+FrameData makeReferenceFrameData(const ReferenceCamera& camera, uint32_t width, uint32_t height, uint32_t frameNumber,
+                                 const FrameData* previousFrame) {
+    FrameData frameData{};
+
+    simd::float3 front = camera.front();
+    simd::float3 right = simd::normalize(simd::cross(front, simd::float3{0.0f, 1.0f, 0.0f}));
+    simd::float3 up = simd::normalize(simd::cross(right, front));
+
+    float aspectRatio = float(width) / float(height);
+    frameData.projection_matrix = matrix_perspective_right_hand(camera.fov * float(M_PI) / 180.0f, aspectRatio, camera.nearPlane, camera.farPlane);
+    frameData.projection_matrix_inverse = simd::inverse(frameData.projection_matrix);
+    frameData.view_matrix = matrix_look_at_right_hand(camera.position, camera.position + front, up);
+    frameData.view_matrix_inverse = simd::inverse(frameData.view_matrix);
+    const FrameData& previous = previousFrame ? *previousFrame : frameData;
+    frameData.previous_view_projection_matrix = matrix_multiply(previous.projection_matrix, previous.view_matrix);
+
+    frameData.cameraUp       = simd::float4{up.x, up.y, up.z, 1.0f};
+    frameData.cameraRight    = simd::float4{right.x, right.y, right.z, 1.0f};
+    frameData.cameraForward  = simd::float4{front.x, front.y, front.z, 1.0f};
+    frameData.cameraPosition = simd::float4{camera.position.x, camera.position.y, camera.position.z, 1.0f};
+
+    frameData.framebuffer_width = width;
+    frameData.framebuffer_height = height;
+    frameData.near_plane = camera.nearPlane;
+    frameData.far_plane = camera.farPlane;
+    frameData.frame_index = frameNumber;
+
+    frameData.sun_color = simd::float4{0.95f, 0.95f, 0.9f, 1.0f};
+    frameData.sun_specular_intensity = 0.7f;
+
+    // Same oscillation as the renderer
+    float sunZ = std::sin(frameNumber * 0.02f) * 9.0f;
+    simd::float4 sunWorldPosition{0.0f, 10.0f, sunZ, 1.0f};
+    frameData.sun_eye_direction = -sunWorldPosition;
+    return frameData;
+}
+
+bool ReferenceGBuffer::isEmpty(uint32_t x, uint32_t y) const {
+    simd::float3 color = albedo[size_t(y) * width + x];
+    return color.x == 0.0f && color.y == 0.0f && color.z == 0.0f;
+}
+
+float ReferenceGBuffer::sampleDepth(simd::float2 uv) const {
+    float x = uv.x * width - 0.5f;
+    float y = uv.y * height - 0.5f;
+    int x0 = int(std::floor(x));
+    int y0 = int(std::floor(y));
+    float fx = x - x0;
+    float fy = y - y0;
+
+    auto texel = [&](int tx, int ty) {
+        tx = std::clamp(tx, 0, int(width) - 1);
+        ty = std::clamp(ty, 0, int(height) - 1);
+        return depth[size_t(ty) * width + tx];
+    };
+
+    float top = texel(x0, y0) * (1.0f - fx) + texel(x0 + 1, y0) * fx;
+    float bottom = texel(x0, y0 + 1) * (1.0f - fx) + texel(x0 + 1, y0 + 1) * fx;
+    return top * (1.0f - fy) + bottom * fy;
+}
+
+ReferenceGBuffer renderReferenceGBuffer(const ReferenceScene& scene, const FrameData& frameData, TaskScheduler& scheduler) {
+    ReferenceGBuffer gBuffer;
+    gBuffer.width = frameData.framebuffer_width;
+    gBuffer.height = frameData.framebuffer_height;
+    size_t pixelCount = size_t(gBuffer.width) * gBuffer.height;
+    gBuffer.albedo.assign(pixelCount, simd::float3{0.0f, 0.0f, 0.0f});
+    gBuffer.normal.assign(pixelCount, simd::float4{0.0f, 0.0f, 0.0f, 1.0f});
+    gBuffer.depth.assign(pixelCount, frameData.far_plane);
+
+    simd::float3 origin = xyz(frameData.cameraPosition);
+    simd::float3 forward = xyz(frameData.cameraForward);
+
+    scheduler.parallelFor(gBuffer.height, [&](size_t y) {
+        for (uint32_t x = 0; x < gBuffer.width; x++) {
+            simd::float2 ndc{(x + 0.5f) / gBuffer.width * 2.0f - 1.0f, -((y + 0.5f) / gBuffer.height * 2.0f - 1.0f)};
+            simd::float4 viewPos = matrix_multiply(frameData.projection_matrix_inverse, simd::float4{ndc.x, ndc.y, 1.0f, 1.0f});
+            viewPos = viewPos / viewPos.w;
+            simd::float4 worldDir = matrix_multiply(frameData.view_matrix_inverse, simd::float4{viewPos.x, viewPos.y, viewPos.z, 0.0f});
+            simd::float3 direction = simd::normalize(xyz(worldDir));
+
+            ReferenceHit hit;
+            if (!scene.intersect(origin, direction, frameData.near_plane, frameData.far_plane, hit)) continue;
+
+            size_t pixel = y * gBuffer.width + x;
+            const ReferenceMaterial& material = scene.material(hit.triangle);
+            simd::float3 normal = scene.normal(hit.triangle);
+            if (simd::dot(normal, direction) > 0.0f) normal = -normal;
+
+            gBuffer.albedo[pixel] = material.color;
+            gBuffer.normal[pixel] = simd::float4{normal.x, normal.y, normal.z, material.isEmissive ? -1.0f : 1.0f};
+            gBuffer.depth[pixel] = hit.distance * simd::dot(direction, forward);
+        }
+    }, 4);
+
+    return gBuffer;
+}
+
+ReferenceGBuffer downsampleGBuffer(const ReferenceGBuffer& gBuffer, uint32_t factor) {
+    ReferenceGBuffer low;
+    low.width = (gBuffer.width + factor - 1) / factor;
+    low.height = (gBuffer.height + factor - 1) / factor;
+    size_t pixelCount = size_t(low.width) * low.height;
+    low.albedo.resize(pixelCount);
+    low.normal.resize(pixelCount);
+    low.depth.resize(pixelCount);
+
+    for (uint32_t y = 0; y < low.height; y++) {
+        for (uint32_t x = 0; x < low.width; x++) {
+            size_t nearest = size_t(y * factor) * gBuffer.width + x * factor;
+            for (uint32_t sy = y * factor; sy < std::min((y + 1) * factor, gBuffer.height); sy++) {
+                for (uint32_t sx = x * factor; sx < std::min((x + 1) * factor, gBuffer.width); sx++) {
+                    size_t pixel = size_t(sy) * gBuffer.width + sx;
+                    if (gBuffer.depth[pixel] < gBuffer.depth[nearest]) nearest = pixel;
+                }
+            }
+
+            size_t pixel = size_t(y) * low.width + x;
+            low.albedo[pixel] = gBuffer.albedo[nearest];
+            low.normal[pixel] = gBuffer.normal[nearest];
+            low.depth[pixel] = gBuffer.depth[nearest];
+        }
+    }
+    return low;
+}
+
+simd::float2 ReferenceDepthPyramid::at(uint32_t mip, uint32_t x, uint32_t y) const {
+    if (mip >= mips.size() || x >= mips[mip].width || y >= mips[mip].height) return simd::float2{0.0f, 0.0f};
+    return mips[mip].minMax[size_t(y) * mips[mip].width + x];
+}
+
+ReferenceDepthPyramid buildDepthPyramid(const ReferenceGBuffer& gBuffer) {
+    ReferenceDepthPyramid pyramid;
+
+    ReferenceDepthPyramid::Mip base;
+    base.width = gBuffer.width;
+    base.height = gBuffer.height;
+    base.minMax.resize(gBuffer.depth.size());
+    for (size_t i = 0; i < gBuffer.depth.size(); i++) {
+        base.minMax[i] = simd::float2{gBuffer.depth[i], gBuffer.depth[i]};
+    }
+    pyramid.mips.push_back(std::move(base));
+
+    while (pyramid.mips.back().width > 1 || pyramid.mips.back().height > 1) {
+        const ReferenceDepthPyramid::Mip& src = pyramid.mips.back();
+        ReferenceDepthPyramid::Mip dst;
+        dst.width = std::max(src.width / 2, 1u);
+        dst.height = std::max(src.height / 2, 1u);
+        dst.minMax.resize(size_t(dst.width) * dst.height);
+
+        for (uint32_t y = 0; y < dst.height; y++) {
+            for (uint32_t x = 0; x < dst.width; x++) {
+                // A 1 texel wide source has no second column to read
+                uint32_t x1 = std::min(2 * x + 1, src.width - 1);
+                uint32_t y1 = std::min(2 * y + 1, src.height - 1);
+                simd::float2 d00 = src.minMax[size_t(2 * y) * src.width + 2 * x];
+                simd::float2 d10 = src.minMax[size_t(2 * y) * src.width + x1];
+                simd::float2 d01 = src.minMax[size_t(y1) * src.width + 2 * x];
+                simd::float2 d11 = src.minMax[size_t(y1) * src.width + x1];
+                dst.minMax[size_t(y) * dst.width + x] = simd::float2{std::min({d00.x, d10.x, d01.x, d11.x}),
+                                                                     std::max({d00.y, d10.y, d01.y, d11.y})};
+            }
+        }
+        pyramid.mips.push_back(std::move(dst));
+    }
+    return pyramid;
+}
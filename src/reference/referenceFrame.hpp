@@ -0,0 +1,70 @@
+#pragma once
+
+#include <simd/simd.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "referenceCommon.hpp"
+#include "referenceScene.hpp"
+
+class TaskScheduler;
+
+// The renderer's camera without the window input: same start, same angles, same matrices
+struct ReferenceCamera {
+    simd::float3    position = simd::float3{7.0f, 5.0f, 0.0f};
+    float           yaw = -180.0f;
+    float           pitch = -35.0f;
+    float           fov = 45.0f;
+    float           nearPlane = 0.1f;
+    float           farPlane = 100.0f;
+
+    simd::float3 front() const;
+};
+
+// Fills the fields of FrameData the cascade and gather shaders read, the way
+// Engine::updateWorldState does. The sun moves with frameNumber like in the renderer.
+// Without a previous frame the previous view projection is the current one.
+FrameData makeReferenceFrameData(const ReferenceCamera& camera, uint32_t width, uint32_t height, uint32_t frameNumber,
+                                 const FrameData* previousFrame = nullptr);
+
+// The parts of the G-buffer and the linear depth target the cascades use, from one primary
+// ray through every pixel center
+struct ReferenceGBuffer {
+    uint32_t                    width = 0;
+    uint32_t                    height = 0;
+    // Object color, zero where no geometry was hit, which the gather treats as sky
+    std::vector<simd::float3>   albedo;
+    // World space, w is -1 on emissive surfaces like the alpha of the normal target
+    std::vector<simd::float4>   normal;
+    // Linear view depth. The depth prepass clears to 1.0, the reference puts the far plane
+    // where no geometry was hit so those probes can be told apart.
+    std::vector<float>          depth;
+
+    bool isEmpty(uint32_t x, uint32_t y) const;
+    // Bilinear with clamp to edge, like depthSampler
+    float sampleDepth(simd::float2 uv) const;
+};
+
+ReferenceGBuffer renderReferenceGBuffer(const ReferenceScene& scene, const FrameData& frameData, TaskScheduler& scheduler);
+
+// One pixel per factor x factor block, the one nearest to the camera so thin foreground
+// geometry survives. Sizes round up, a partial block at the edge still gets a pixel.
+ReferenceGBuffer downsampleGBuffer(const ReferenceGBuffer& gBuffer, uint32_t factor);
+
+// The mips minMaxDepthKernel builds from the linear depth: every texel holds the smallest
+// and largest depth under it. Mip sizes round down like texture mips, so the last odd row
+// or column of a mip is not covered by the next one.
+struct ReferenceDepthPyramid {
+    struct Mip {
+        uint32_t                    width = 0;
+        uint32_t                    height = 0;
+        std::vector<simd::float2>   minMax;
+    };
+    std::vector<Mip>    mips;
+
+    // Zero min and max outside the mip
+    simd::float2 at(uint32_t mip, uint32_t x, uint32_t y) const;
+};
+
+ReferenceDepthPyramid buildDepthPyramid(const ReferenceGBuffer& gBuffer);
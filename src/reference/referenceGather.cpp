@@ -0,0 +1,306 @@
+#include "referenceGather.hpp"
+#include "../core/taskScheduler.hpp"
+
+using namespace reference;
+
+namespace {
+
+// renderSky looks at a fixed height, so the whole sky is the mid color
+simd::float3 renderSky(const FrameData& frameData) {
+    const simd::float3 skyMidColor{0.4f, 0.6f, 0.9f};
+    return skyMidColor * (frameData.sun_specular_intensity * 0.7f);
+}
+
+// Real spherical harmonics up to band 2
+void shBasis(simd::float3 d, float basis[9]) {
+    basis[0] = 0.282095f;
+    basis[1] = 0.488603f * d.y;
+    basis[2] = 0.488603f * d.z;
+    basis[3] = 0.488603f * d.x;
+    basis[4] = 1.092548f * d.x * d.y;
+    basis[5] = 1.092548f * d.y * d.z;
+    basis[6] = 0.315392f * (3.0f * d.z * d.z - 1.0f);
+    basis[7] = 1.092548f * d.x * d.z;
+    basis[8] = 0.546274f * (d.x * d.x - d.y * d.y);
+}
+
+int coefficientCount(int order) {
+    return (order + 1) * (order + 1);
+}
+
+// Cosine weighted average over the rays of a probe, the loop of final_gather_fragment. The
+// cosine is taken for the direction the ray was traced in, jittered or not.
+struct RayLoop {
+    const ReferenceCascades&            cascades;
+    const CascadeLevelLayout&           layout;
+    const std::vector<simd::float4>&    radiance;
+
+    explicit RayLoop(const ReferenceCascades& cascades) : cascades(cascades), layout(cascades.layout(0)), radiance(cascades.radiance(0)) {}
+
+    simd::float3 operator()(uint32_t probe, simd::float3 normal) const {
+        const simd::float4* probeRays = radiance.data() + size_t(probe) * layout.numRays;
+        const simd::float2 jitter = cascades.rayJitter(0, probe);
+        simd::float3 radianceSum{0.0f, 0.0f, 0.0f};
+        float totalWeight = 0.0f;
+
+        for (uint32_t ray = 0; ray < layout.numRays; ray++) {
+            float cosTheta = std::max(0.0f, simd::dot(normal, layout.rayDirection(ray, jitter)));
+            radianceSum += xyz(probeRays[ray]) * cosTheta;
+            totalWeight += cosTheta;
+        }
+        return (totalWeight > 0.0001f) ? radianceSum / totalWeight : simd::float3{0.0f, 0.0f, 0.0f};
+    }
+};
+
+// Pixel setup of final_gather_fragment. probeRadiance(probe, normal) gives the cosine
+// weighted average radiance of a probe for the normal. Without modulate the result is the
+// incoming radiance before the albedo, and empty pixels stay black.
+template<typename ProbeRadiance>
+ReferenceImage gather(const ReferenceCascades& cascades, const ReferenceGBuffer& gBuffer, const FrameData& frameData, bool drawSky,
+                      bool modulate, TaskScheduler& scheduler, const ProbeRadiance& probeRadiance) {
+    const CascadeLevelLayout& layout = cascades.layout(0);
+    const CascadeDensityBlocks& density = cascades.densityBlocks();
+    ReferenceImage image;
+    image.resize(gBuffer.width, gBuffer.height);
+
+    const int gridX = int(layout.gridX);
+    const int gridY = int(layout.gridY);
+
+    scheduler.parallelFor(gBuffer.height, [&](size_t y) {
+        for (uint32_t x = 0; x < gBuffer.width; x++) {
+            size_t pixel = y * gBuffer.width + x;
+            if (gBuffer.isEmpty(x, uint32_t(y))) {
+                simd::float3 sky = (drawSky && modulate) ? renderSky(frameData) : simd::float3{0.0f, 0.0f, 0.0f};
+                image.pixels[pixel] = simd::float4{sky.x, sky.y, sky.z, 1.0f};
+                continue;
+            }
+
+            simd::float3 albedo = gBuffer.albedo[pixel];
+            simd::float3 normal = xyz(gBuffer.normal[pixel]);
+            bool isEmissive = gBuffer.normal[pixel].w == -1.0f;
+            float currentDepth = gBuffer.depth[pixel];
+
+            // On flat blocks of the adaptive density the same interpolation runs over the
+            // coarse probes, every other one in both directions
+            const int step = density.isCoarse(x, uint32_t(y)) ? 2 : 1;
+            const int stepsX = (gridX + step - 1) / step;
+            const int stepsY = (gridY + step - 1) / step;
+
+            simd::float2 texCoords{(x + 0.5f) / gBuffer.width, (y + 0.5f) / gBuffer.height};
+            float probeCoordX = (texCoords.x * gridX - 0.5f) / step;
+            float probeCoordY = (texCoords.y * gridY - 0.5f) / step;
+            int probeBaseX = std::clamp(int(std::floor(probeCoordX)), 0, std::max(stepsX - 2, 0));
+            int probeBaseY = std::clamp(int(std::floor(probeCoordY)), 0, std::max(stepsY - 2, 0));
+            simd::float4 w = bilinearWeights(simd::float2{fract(probeCoordX), fract(probeCoordY)});
+
+            uint32_t probes[4];
+            float probeDepths[4];
+            for (int i = 0; i < 4; i++) {
+                int px = std::clamp(probeBaseX + (i & 1), 0, stepsX - 1) * step;
+                int py = std::clamp(probeBaseY + (i >> 1), 0, stepsY - 1) * step;
+                probes[i] = uint32_t(py * gridX + px);
+                probeDepths[i] = gBuffer.sampleDepth(layout.probeUV(probes[i]));
+            }
+
+            // Bilateral weights where the probes straddle a depth edge
+            float minDepth = std::min(std::min(probeDepths[0], probeDepths[1]), std::min(probeDepths[2], probeDepths[3]));
+            float maxDepth = std::max(std::max(probeDepths[0], probeDepths[1]), std::max(probeDepths[2], probeDepths[3]));
+            float averageDepth = (probeDepths[0] + probeDepths[1] + probeDepths[2] + probeDepths[3]) * 0.25f;
+            if ((maxDepth - minDepth) / averageDepth > 0.05f) {
+                w = simd::float4{w.x / (std::abs(probeDepths[0] - currentDepth) + 0.0001f),
+                                 w.y / (std::abs(probeDepths[1] - currentDepth) + 0.0001f),
+                                 w.z / (std::abs(probeDepths[2] - currentDepth) + 0.0001f),
+                                 w.w / (std::abs(probeDepths[3] - currentDepth) + 0.0001f)};
+            }
+            w = w / (w.x + w.y + w.z + w.w);
+
+            simd::float3 finalRadiance{0.0f, 0.0f, 0.0f};
+            if (isEmissive) {
+                // Does not depend on the probes, only on how the rays sample the hemisphere
+                float cosSquaredSum = 0.0f;
+                float totalWeight = 0.0f;
+                for (uint32_t ray = 0; ray < layout.numRays; ray++) {
+                    float cosTheta = std::max(0.0f, simd::dot(normal, layout.rayDirection(ray)));
+                    cosSquaredSum += cosTheta * cosTheta;
+                    totalWeight += cosTheta;
+                }
+                if (totalWeight > 0.0001f) {
+                    finalRadiance = albedo * (cosSquaredSum / totalWeight);
+                }
+            } else {
+                for (int p = 0; p < 4; p++) {
+                    finalRadiance += probeRadiance(probes[p], normal) * component(w, p);
+                }
+            }
+
+            simd::float3 color = modulate ? albedo * finalRadiance : finalRadiance;
+            image.pixels[pixel] = simd::float4{color.x, color.y, color.z, 1.0f};
+        }
+    }, 4);
+
+    return image;
+}
+
+}
+
+ReferenceImage referenceFinalGather(const ReferenceCascades& cascades, const ReferenceGBuffer& gBuffer, const FrameData& frameData,
+                                    bool drawSky, TaskScheduler& scheduler) {
+    return gather(cascades, gBuffer, frameData, drawSky, true, scheduler, RayLoop(cascades));
+}
+
+ReferenceImage referenceGatherIrradiance(const ReferenceCascades& cascades, const ReferenceGBuffer& gBuffer, const FrameData& frameData,
+                                         TaskScheduler& scheduler) {
+    return gather(cascades, gBuffer, frameData, false, false, scheduler, RayLoop(cascades));
+}
+
+std::vector<ProbeIrradiance> projectProbeIrradiance(const ReferenceCascades& cascades, int order, TaskScheduler& scheduler) {
+    const CascadeLevelLayout& layout = cascades.layout(0);
+    const std::vector<simd::float4>& radiance = cascades.radiance(0);
+    const int count = coefficientCount(order);
+
+    // Every ray stands for the same solid angle, like in the sums of the gather. The
+    // clamped cosine has the band factors pi, 2pi/3 and pi/4, divided by the pi the
+    // gather's normalization takes out again.
+    const float rayWeight = 4.0f * float(M_PI) / float(layout.numRays);
+    const float bandFactor[9] = {1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f};
+
+    auto fillRayBasis = [&](simd::float2 jitter, float* rayBasis) {
+        float basis[9];
+        for (uint32_t ray = 0; ray < layout.numRays; ray++) {
+            shBasis(layout.rayDirection(ray, jitter), basis);
+            for (int i = 0; i < 9; i++) {
+                rayBasis[ray * 9 + i] = basis[i] * rayWeight * bandFactor[i];
+            }
+        }
+    };
+
+    // Shared by all probes, unless every probe traced its rays somewhere else in the cells
+    const bool jittered = cascades.getSettings().jitterRays;
+    std::vector<float> sharedBasis(size_t(layout.numRays) * 9);
+    if (!jittered) fillRayBasis(simd::float2{0.5f, 0.5f}, sharedBasis.data());
+
+    std::vector<ProbeIrradiance> irradiance(layout.probeCount());
+    scheduler.parallelForRange(layout.probeCount(), 256, [&](size_t begin, size_t end) {
+        std::vector<float> probeBasis(jittered ? size_t(layout.numRays) * 9 : 0);
+        for (size_t probe = begin; probe < end; probe++) {
+            const float* rayBasis = sharedBasis.data();
+            if (jittered) {
+                fillRayBasis(cascades.rayJitter(0, uint32_t(probe)), probeBasis.data());
+                rayBasis = probeBasis.data();
+            }
+
+            ProbeIrradiance& result = irradiance[probe];
+            for (simd::float3& c : result.coefficients) {
+                c = simd::float3{0.0f, 0.0f, 0.0f};
+            }
+
+            const simd::float4* probeRays = radiance.data() + probe * layout.numRays;
+            for (uint32_t ray = 0; ray < layout.numRays; ray++) {
+                simd::float3 rayRadiance = xyz(probeRays[ray]);
+                for (int i = 0; i < count; i++) {
+                    result.coefficients[i] += rayRadiance * rayBasis[ray * 9 + i];
+                }
+            }
+        }
+    });
+    return irradiance;
+}
+
+simd::float3 evaluateIrradiance(const ProbeIrradiance& irradiance, simd::float3 normal, int order) {
+    float basis[9];
+    shBasis(normal, basis);
+
+    simd::float3 result{0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < coefficientCount(order); i++) {
+        result += irradiance.coefficients[i] * basis[i];
+    }
+    // Ringing of the truncated projection must not turn into negative light
+    return simd::max(result, simd::float3{0.0f, 0.0f, 0.0f});
+}
+
+ReferenceImage referenceFinalGather(const ReferenceCascades& cascades, const std::vector<ProbeIrradiance>& irradiance, int order,
+                                    const ReferenceGBuffer& gBuffer, const FrameData& frameData, bool drawSky, TaskScheduler& scheduler) {
+    return gather(cascades, gBuffer, frameData, drawSky, true, scheduler, [&](uint32_t probe, simd::float3 normal) {
+        return evaluateIrradiance(irradiance[probe], normal, order);
+    });
+}
+
+ReferenceImage upsampleGather(const ReferenceImage& lowIrradiance, const ReferenceGBuffer& lowGBuffer, const ReferenceGBuffer& gBuffer,
+                              const FrameData& frameData, bool drawSky, TaskScheduler& scheduler, const BilateralUpsampleSettings& settings) {
+    ReferenceImage image;
+    image.resize(gBuffer.width, gBuffer.height);
+
+    const float scaleX = float(lowGBuffer.width) / float(gBuffer.width);
+    const float scaleY = float(lowGBuffer.height) / float(gBuffer.height);
+    const int lowWidth = int(lowGBuffer.width);
+    const int lowHeight = int(lowGBuffer.height);
+
+    scheduler.parallelFor(gBuffer.height, [&](size_t y) {
+        for (uint32_t x = 0; x < gBuffer.width; x++) {
+            size_t pixel = y * gBuffer.width + x;
+            if (gBuffer.isEmpty(x, uint32_t(y))) {
+                simd::float3 sky = drawSky ? renderSky(frameData) : simd::float3{0.0f, 0.0f, 0.0f};
+                image.pixels[pixel] = simd::float4{sky.x, sky.y, sky.z, 1.0f};
+                continue;
+            }
+
+            simd::float3 normal = xyz(gBuffer.normal[pixel]);
+            float depth = gBuffer.depth[pixel];
+
+            float lowX = (x + 0.5f) * scaleX - 0.5f;
+            float lowY = (y + 0.5f) * scaleY - 0.5f;
+            int baseX = int(std::floor(lowX));
+            int baseY = int(std::floor(lowY));
+            simd::float4 bilinear = bilinearWeights(simd::float2{fract(lowX), fract(lowY)});
+
+            simd::float3 sum{0.0f, 0.0f, 0.0f};
+            float weightSum = 0.0f;
+            // Falls back to the closest sample in depth when the weights all vanish
+            simd::float3 closest{0.0f, 0.0f, 0.0f};
+            float closestDifference = INFINITY;
+
+            for (int i = 0; i < 4; i++) {
+                int sx = std::clamp(baseX + (i & 1), 0, lowWidth - 1);
+                int sy = std::clamp(baseY + (i >> 1), 0, lowHeight - 1);
+                if (lowGBuffer.isEmpty(uint32_t(sx), uint32_t(sy))) continue;
+
+                size_t sample = size_t(sy) * lowWidth + sx;
+                simd::float3 irradiance = xyz(lowIrradiance.pixels[sample]);
+                float depthDifference = std::abs(lowGBuffer.depth[sample] - depth) / depth;
+                float weight = component(bilinear, i)
+                             * std::exp(-depthDifference / settings.depthSigma)
+                             * std::pow(std::max(simd::dot(xyz(lowGBuffer.normal[sample]), normal), 0.0f), settings.normalPower);
+
+                sum += irradiance * weight;
+                weightSum += weight;
+                if (depthDifference < closestDifference) {
+                    closestDifference = depthDifference;
+                    closest = irradiance;
+                }
+            }
+
+            simd::float3 color = gBuffer.albedo[pixel] * ((weightSum > 0.0001f) ? sum / weightSum : closest);
+            image.pixels[pixel] = simd::float4{color.x, color.y, color.z, 1.0f};
+        }
+    }, 4);
+
+    return image;
+}
+
+ReferenceImage applyAlbedo(const ReferenceImage& irradiance, const ReferenceGBuffer& gBuffer, const FrameData& frameData, bool drawSky,
+                           TaskScheduler& scheduler) {
+    ReferenceImage image;
+    image.resize(gBuffer.width, gBuffer.height);
+
+    scheduler.parallelFor(gBuffer.height, [&](size_t y) {
+        for (uint32_t x = 0; x < gBuffer.width; x++) {
+            size_t pixel = y * gBuffer.width + x;
+            simd::float3 color = gBuffer.isEmpty(x, uint32_t(y))
+                ? (drawSky ? renderSky(frameData) : simd::float3{0.0f, 0.0f, 0.0f})
+                : gBuffer.albedo[pixel] * xyz(irradiance.pixels[pixel]);
+            image.pixels[pixel] = simd::float4{color.x, color.y, color.z, 1.0f};
+        }
+    }, 16);
+
+    return image;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "referenceCascades.hpp"
+#include "referenceFrame.hpp"
+#include "referenceImage.hpp"
+
+class TaskScheduler;
+
+// final_gather_fragment with bilinear probes: cosine weighted cascade 0 radiance of the
+// four nearest probes, bilateral weights on depth edges, times albedo. The result is linear,
+// before tonemapping. Pixels without geometry get the sky color when drawSky is set.
+ReferenceImage referenceFinalGather(const ReferenceCascades& cascades, const ReferenceGBuffer& gBuffer, const FrameData& frameData,
+                                    bool drawSky, TaskScheduler& scheduler);
+// The same gather before the albedo is applied, black where there is no geometry. This is
+// what a lower resolution gather hands to the upsampler.
+ReferenceImage referenceGatherIrradiance(const ReferenceCascades& cascades, const ReferenceGBuffer& gBuffer, const FrameData& frameData,
+                                         TaskScheduler& scheduler);
+
+struct BilateralUpsampleSettings {
+    // Depth differences are measured relative to the depth of the full resolution pixel
+    float   depthSigma = 0.02f;
+    // Exponent on the cosine between the normals
+    float   normalPower = 8.0f;
+};
+
+// Joint bilateral upsampling of a lower resolution gather to the full resolution G-buffer.
+// The bilinear weights of the four nearest low resolution pixels are scaled down by their
+// depth and normal difference to the full resolution pixel, then the result is multiplied
+// by the full resolution albedo.
+ReferenceImage upsampleGather(const ReferenceImage& lowIrradiance, const ReferenceGBuffer& lowGBuffer, const ReferenceGBuffer& gBuffer,
+                              const FrameData& frameData, bool drawSky, TaskScheduler& scheduler,
+                              const BilateralUpsampleSettings& settings = {});
+
+// Finishes irradiance that was gathered or accumulated for gBuffer like the gather would:
+// times albedo, with the sky where there is no geometry when drawSky is set
+ReferenceImage applyAlbedo(const ReferenceImage& irradiance, const ReferenceGBuffer& gBuffer, const FrameData& frameData, bool drawSky,
+                           TaskScheduler& scheduler);
+
+// Radiance of a cascade 0 probe projected to spherical harmonics and convolved with the
+// clamped cosine, scaled so evaluating it for a normal gives the cosine weighted average
+// the gather would otherwise sum over the rays of the probe. Order 1 fills the first 4
+// coefficients, order 2 all 9.
+struct ProbeIrradiance {
+    simd::float3    coefficients[9];
+};
+
+std::vector<ProbeIrradiance> projectProbeIrradiance(const ReferenceCascades& cascades, int order, TaskScheduler& scheduler);
+simd::float3 evaluateIrradiance(const ProbeIrradiance& irradiance, simd::float3 normal, int order);
+
+// referenceFinalGather with the same probes and weights, but one evaluation of the
+// projected irradiance per probe instead of the loop over its rays
+ReferenceImage referenceFinalGather(const ReferenceCascades& cascades, const std::vector<ProbeIrradiance>& irradiance, int order,
+                                    const ReferenceGBuffer& gBuffer, const FrameData& frameData, bool drawSky, TaskScheduler& scheduler);
@@ -0,0 +1,64 @@
+#include "referenceImage.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb/stb_image_write.h>
+
+namespace {
+
+float acesTonemap(float color) {
+    const float a = 2.51f, b = 0.03f, c = 2.43f, d = 0.59f, e = 0.14f;
+    return std::clamp((color * (a * color + b)) / (color * (c * color + d) + e), 0.0f, 1.0f);
+}
+
+}
+
+void ReferenceImage::resize(uint32_t newWidth, uint32_t newHeight) {
+    width = newWidth;
+    height = newHeight;
+    pixels.assign(size_t(width) * height, simd::float4{0.0f, 0.0f, 0.0f, 1.0f});
+}
+
+bool ReferenceImage::writePNG(const std::string& path) const {
+    std::vector<unsigned char> bytes(size_t(width) * height * 3);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        const float channels[3] = {pixels[i].x, pixels[i].y, pixels[i].z};
+        for (int c = 0; c < 3; c++) {
+            float value = std::pow(acesTonemap(std::max(channels[c], 0.0f)), 1.0f / 2.2f);
+            bytes[i * 3 + c] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+        }
+    }
+    return stbi_write_png(path.c_str(), int(width), int(height), 3, bytes.data(), int(width) * 3) != 0;
+}
+
+ReferenceImageError compareImages(const ReferenceImage& image, const ReferenceImage& reference, float threshold, const std::vector<uint8_t>* mask) {
+    ReferenceImageError error;
+    if (image.width != reference.width || image.height != reference.height) {
+        error.rmse = error.maxError = std::numeric_limits<double>::infinity();
+        error.badPixelFraction = 1.0;
+        return error;
+    }
+
+    double squared = 0.0;
+    size_t counted = 0;
+    size_t bad = 0;
+    for (size_t i = 0; i < image.pixels.size(); i++) {
+        if (mask && !(*mask)[i]) continue;
+
+        simd::float4 d = image.pixels[i] - reference.pixels[i];
+        double largest = std::max({std::abs(d.x), std::abs(d.y), std::abs(d.z)});
+        squared += double(d.x) * d.x + double(d.y) * d.y + double(d.z) * d.z;
+        error.maxError = std::max(error.maxError, largest);
+        bad += largest > threshold;
+        counted++;
+    }
+
+    if (counted == 0) return error;
+    error.rmse = std::sqrt(squared / (counted * 3.0));
+    error.psnr = error.rmse > 0.0 ? -20.0 * std::log10(error.rmse) : std::numeric_limits<double>::infinity();
+    error.badPixelFraction = double(bad) / counted;
+    return error;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <simd/simd.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Linear HDR image, rows from the top like the framebuffer
+struct ReferenceImage {
+    uint32_t                    width = 0;
+    uint32_t                    height = 0;
+    std::vector<simd::float4>   pixels;
+
+    void resize(uint32_t newWidth, uint32_t newHeight);
+    simd::float4& at(uint32_t x, uint32_t y) { return pixels[size_t(y) * width + x]; }
+    const simd::float4& at(uint32_t x, uint32_t y) const { return pixels[size_t(y) * width + x]; }
+
+    // Tonemapped and gamma corrected like postProcessColor in the final gather
+    bool writePNG(const std::string& path) const;
+};
+
+// Difference of the RGB channels of two images of the same size
+struct ReferenceImageError {
+    double  rmse = 0.0;
+    double  maxError = 0.0;
+    // From the RMSE with a peak of 1, infinite for identical images
+    double  psnr = 0.0;
+    // Pixels where any channel differs by more than the threshold given to compareImages
+    double  badPixelFraction = 0.0;
+};
+
+// Only pixels with a nonzero mask entry count when a mask is given
+ReferenceImageError compareImages(const ReferenceImage& image, const ReferenceImage& reference, float threshold = 0.05f,
+                                  const std::vector<uint8_t>* mask = nullptr);
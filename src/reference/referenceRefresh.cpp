@@ -0,0 +1,102 @@
+#include "referenceRefresh.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace reference;
+
+CascadeRefreshScheduler::CascadeRefreshScheduler(const ReferenceCascadeSettings& cascadeSettings, const CascadeRefreshSettings& settings)
+: cascadeSettings(cascadeSettings)
+, settings(settings)
+, levels(cascadeSettings.levels) {
+}
+
+void CascadeRefreshScheduler::invalidate() {
+    for (LevelState& level : levels) {
+        level.valid = false;
+    }
+}
+
+bool CascadeRefreshScheduler::needsTrace(int l, simd::float3 cameraPosition, simd::float3 cameraFront, uint64_t sceneRevision) const {
+    const LevelState& level = levels[l];
+    if (!level.valid || level.sceneRevision != sceneRevision) return true;
+
+    float cosMaxTurn = std::cos(settings.maxCameraTurnDegrees * float(M_PI) / 180.0f);
+    return simd::length(cameraPosition - level.cameraPosition) > settings.maxCameraMove
+        || simd::dot(cameraFront, level.cameraFront) < cosMaxTurn;
+}
+
+uint32_t CascadeRefreshScheduler::levelsToTrace(const FrameData& frameData, uint64_t sceneRevision) {
+    // Stored radiance belongs to the probe grids of the old size
+    if (frameData.framebuffer_width != width || frameData.framebuffer_height != height) {
+        width = frameData.framebuffer_width;
+        height = frameData.framebuffer_height;
+        invalidate();
+        liveRays.clear();
+    }
+
+    simd::float3 cameraPosition = xyz(frameData.view_matrix_inverse.columns[3]);
+    simd::float3 cameraFront = simd::normalize(-xyz(frameData.view_matrix_inverse.columns[2]));
+    const int levelCount = static_cast<int>(levels.size());
+
+    uint32_t mask = 1u;
+    for (int l = 1; l < levelCount; l++) {
+        if (settings.mode == CascadeRefreshMode::EveryFrame || needsTrace(l, cameraPosition, cameraFront, sceneRevision)) {
+            mask |= 1u << l;
+        }
+    }
+
+    if (settings.mode == CascadeRefreshMode::Interval) {
+        // Level N takes the frames with exactly N-1 trailing zero bits, every 2^N frames
+        // and never in the same frame as another level above 0
+        for (int l = 1; l < levelCount; l++) {
+            uint64_t period = uint64_t(1) << l;
+            if (frame % period == period / 2) mask |= 1u << l;
+        }
+    } else if (settings.mode == CascadeRefreshMode::Budget && msPerRay > 0.0) {
+        std::vector<double> cost(levelCount);
+        double spent = 0.0;
+        for (int l = 0; l < levelCount; l++) {
+            uint64_t rays = (size_t(l) < liveRays.size()) ? liveRays[l] : makeCascadeLevelLayout(l, width, height, cascadeSettings).rayCount();
+            cost[l] = double(rays) * msPerRay;
+            if (mask & (1u << l)) spent += cost[l];
+        }
+
+        // Most overdue first, where a level is due every 2^N frames like in Interval
+        std::vector<int> order(levelCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return double(levels[a].age) / double(1u << a) > double(levels[b].age) / double(1u << b);
+        });
+        for (int l : order) {
+            if ((mask & (1u << l)) || spent + cost[l] > settings.budgetMs) continue;
+            mask |= 1u << l;
+            spent += cost[l];
+        }
+    }
+
+    for (int l = 0; l < levelCount; l++) {
+        LevelState& level = levels[l];
+        if (mask & (1u << l)) {
+            level.valid = true;
+            level.age = 0;
+            level.cameraPosition = cameraPosition;
+            level.cameraFront = cameraFront;
+            level.sceneRevision = sceneRevision;
+        } else {
+            level.age++;
+        }
+    }
+    frame++;
+    return mask;
+}
+
+void CascadeRefreshScheduler::traced(const ReferenceCascadeStats& stats) {
+    liveRays = stats.liveRays;
+    if (stats.raysTraced == 0) return;
+
+    // Fused does not time the tracing alone
+    double ms = (stats.traceMs > 0.0) ? stats.traceMs : stats.totalMs;
+    double sample = ms / double(stats.raysTraced);
+    msPerRay = (msPerRay == 0.0) ? sample : msPerRay * 0.8 + sample * 0.2;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <simd/simd.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "referenceCascades.hpp"
+
+enum class CascadeRefreshMode {
+    // Every level is traced every frame, what dispatchRaytracing does today
+    EveryFrame,
+    // Level N is traced every 2^N frames. The frames are staggered so that besides level 0
+    // at most one level is traced per frame.
+    Interval,
+    // Level 0 every frame, then the most overdue levels that still fit into budgetMs
+    Budget,
+};
+
+struct CascadeRefreshSettings {
+    CascadeRefreshMode  mode = CascadeRefreshMode::Interval;
+    // Trace time per frame for Budget, estimated from the rays traced in earlier frames
+    double              budgetMs = 0.0;
+    // A level is traced no matter the mode once the camera moved or turned this far since
+    // it was last traced, its probes no longer sit where the stored rays started
+    float               maxCameraMove = 0.5f;
+    float               maxCameraTurnDegrees = 10.0f;
+};
+
+// Decides which cascade levels to trace in a frame. Far levels cover long intervals that
+// change slowly, so they can keep their traced radiance for a few frames while the near
+// levels follow the camera every frame.
+class CascadeRefreshScheduler {
+public:
+    explicit CascadeRefreshScheduler(const ReferenceCascadeSettings& cascadeSettings = {}, const CascadeRefreshSettings& settings = {});
+
+    // Mask of the levels to trace, for ReferenceCascades::render. Changing sceneRevision
+    // invalidates every level.
+    uint32_t levelsToTrace(const FrameData& frameData, uint64_t sceneRevision);
+    // Feeds the cost of the frame back into the budget estimate
+    void traced(const ReferenceCascadeStats& stats);
+    void invalidate();
+
+    const CascadeRefreshSettings& getSettings() const { return settings; }
+
+private:
+    struct LevelState {
+        bool            valid = false;
+        // Frames since the level was traced
+        uint32_t        age = 0;
+        simd::float3    cameraPosition;
+        simd::float3    cameraFront;
+        uint64_t        sceneRevision = 0;
+    };
+
+    bool needsTrace(int level, simd::float3 cameraPosition, simd::float3 cameraFront, uint64_t sceneRevision) const;
+
+    ReferenceCascadeSettings    cascadeSettings;
+    CascadeRefreshSettings      settings;
+    std::vector<LevelState>     levels;
+    uint64_t                    frame = 0;
+    uint32_t                    width = 0;
+    uint32_t                    height = 0;
+    // Running average of the trace time per ray, 0 until the first frame was traced
+    double                      msPerRay = 0.0;
+    // Live rays per level of the last frame, the rays the estimate was made from. Empty
+    // probes are not traced, so the full grid would overestimate every level.
+    std::vector<uint64_t>       liveRays;
+};
@@ -0,0 +1,319 @@
+#include "referenceScene.hpp"
+#include "../core/components/sceneDescription.hpp"
+#include "../core/fileReader.hpp"
+
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <tinyobjloader/tiny_obj_loader.h>
+
+namespace {
+
+// Binned SAH build, small leaves keep the traversal cheap for the short cascade intervals
+constexpr uint32_t BVH_BINS = 12;
+constexpr uint32_t BVH_LEAF_SIZE = 4;
+
+struct Bounds {
+    simd::float3 min{ std::numeric_limits<float>::max(),  std::numeric_limits<float>::max(),  std::numeric_limits<float>::max()};
+    simd::float3 max{-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()};
+
+    void grow(simd::float3 p) {
+        min = simd::min(min, p);
+        max = simd::max(max, p);
+    }
+    void grow(const Bounds& other) {
+        min = simd::min(min, other.min);
+        max = simd::max(max, other.max);
+    }
+    float area() const {
+        simd::float3 e = max - min;
+        if (e.x < 0.0f) return 0.0f;
+        return e.x * e.y + e.y * e.z + e.z * e.x;
+    }
+};
+
+float axis(simd::float3 v, int i) {
+    return i == 0 ? v.x : i == 1 ? v.y : v.z;
+}
+
+bool intersectBounds(simd::float3 boundsMin, simd::float3 boundsMax, simd::float3 origin, simd::float3 inverseDirection, float tMin, float tMax, float& tNear) {
+    simd::float3 t0 = (boundsMin - origin) * inverseDirection;
+    simd::float3 t1 = (boundsMax - origin) * inverseDirection;
+    simd::float3 lo = simd::min(t0, t1);
+    simd::float3 hi = simd::max(t0, t1);
+    tNear = std::max(std::max(lo.x, lo.y), std::max(lo.z, tMin));
+    float tFar = std::min(std::min(hi.x, hi.y), std::min(hi.z, tMax));
+    return tNear <= tFar;
+}
+
+}
+
+bool ReferenceScene::load(const std::string& scenePath) {
+    SceneDescription description;
+    if (!SceneReader::read(scenePath, description)) {
+        return false;
+    }
+
+    struct Geometry {
+        std::vector<simd::float3>   positions;
+        std::vector<uint32_t>       indices;
+        bool                        loaded = false;
+    };
+    std::vector<Geometry> geometries(description.meshPaths.size());
+
+    FileReader::shared().readAll(description.meshPaths, [&](size_t m, std::vector<unsigned char>& bytes, bool ok) {
+        const std::string& path = description.meshPaths[m];
+        if (!ok) {
+            std::cerr << "Failed to read " << path << std::endl;
+            return;
+        }
+
+        // Only the geometry is needed, so the material library is never read
+        std::istringstream stream(std::string(bytes.begin(), bytes.end()));
+        tinyobj::attrib_t vertexArrays;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string error;
+        if (!tinyobj::LoadObj(&vertexArrays, &shapes, &materials, &error, &stream, nullptr, true)) {
+            std::cerr << "Failed to parse " << path << ": " << error << std::endl;
+            return;
+        }
+
+        Geometry& geometry = geometries[m];
+        for (size_t i = 0; i + 2 < vertexArrays.vertices.size(); i += 3) {
+            geometry.positions.push_back(simd::float3{vertexArrays.vertices[i], vertexArrays.vertices[i + 1], vertexArrays.vertices[i + 2]});
+        }
+        for (const tinyobj::shape_t& shape : shapes) {
+            for (const tinyobj::index_t& index : shape.mesh.indices) {
+                geometry.indices.push_back(static_cast<uint32_t>(index.vertex_index));
+            }
+        }
+        geometry.loaded = true;
+    });
+
+    missing.clear();
+    for (size_t m = 0; m < geometries.size(); m++) {
+        if (!geometries[m].loaded) missing.push_back(description.meshPaths[m]);
+    }
+
+    for (size_t i = 0; i < description.instanceCount(); i++) {
+        const Geometry& geometry = geometries[description.instanceMeshes[i]];
+        if (geometry.loaded) {
+            addMesh(geometry.positions, geometry.indices, description.instances[i]);
+        }
+    }
+
+    if (triangles.empty()) {
+        std::cerr << "Error: No geometry loaded from " << scenePath << std::endl;
+        return false;
+    }
+
+    build();
+    return true;
+}
+
+void ReferenceScene::addMesh(const std::vector<simd::float3>& positions, const std::vector<uint32_t>& indices, const MeshInfo& info) {
+    simd::float4x4 transform = meshTransformMatrix(info);
+
+    uint32_t materialIndex = static_cast<uint32_t>(materials.size());
+    materials.push_back({info.isEmissive ? info.emissiveColor : info.color, info.isEmissive});
+
+    auto world = [&](uint32_t index) {
+        simd::float3 p = positions[index];
+        simd::float4 w = matrix_multiply(transform, simd::float4{p.x, p.y, p.z, 1.0f});
+        return simd::float3{w.x, w.y, w.z};
+    };
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        simd::float3 v0 = world(indices[i]);
+        simd::float3 v1 = world(indices[i + 1]);
+        simd::float3 v2 = world(indices[i + 2]);
+        triangles.push_back({v0, v1 - v0, v2 - v0});
+        triangleMaterials.push_back(materialIndex);
+    }
+}
+
+void ReferenceScene::build() {
+    nodes.clear();
+    if (triangles.empty()) return;
+
+    std::vector<simd::float3> centroids(triangles.size());
+    for (size_t i = 0; i < triangles.size(); i++) {
+        const Triangle& t = triangles[i];
+        centroids[i] = t.v0 + (t.edge1 + t.edge2) * (1.0f / 3.0f);
+    }
+
+    nodes.reserve(triangles.size() * 2 / BVH_LEAF_SIZE + 1);
+    nodes.push_back({});
+    buildNode(0, 0, static_cast<uint32_t>(triangles.size()), centroids);
+}
+
+void ReferenceScene::buildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, std::vector<simd::float3>& centroids) {
+    Bounds bounds, centroidBounds;
+    for (uint32_t i = begin; i < end; i++) {
+        const Triangle& t = triangles[i];
+        bounds.grow(t.v0);
+        bounds.grow(t.v0 + t.edge1);
+        bounds.grow(t.v0 + t.edge2);
+        centroidBounds.grow(centroids[i]);
+    }
+    nodes[nodeIndex].boundsMin = bounds.min;
+    nodes[nodeIndex].boundsMax = bounds.max;
+
+    uint32_t count = end - begin;
+    auto makeLeaf = [&]() {
+        nodes[nodeIndex].first = begin;
+        nodes[nodeIndex].count = count;
+    };
+    if (count <= BVH_LEAF_SIZE) {
+        makeLeaf();
+        return;
+    }
+
+    // Cheapest split over the bins of every axis
+    float bestCost = std::numeric_limits<float>::max();
+    int bestAxis = -1;
+    uint32_t bestBin = 0;
+    for (int a = 0; a < 3; a++) {
+        float lo = axis(centroidBounds.min, a);
+        float extent = axis(centroidBounds.max, a) - lo;
+        if (extent <= 0.0f) continue;
+
+        Bounds binBounds[BVH_BINS];
+        uint32_t binCounts[BVH_BINS] = {};
+        float scale = BVH_BINS / extent;
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t bin = std::min(static_cast<uint32_t>((axis(centroids[i], a) - lo) * scale), BVH_BINS - 1);
+            const Triangle& t = triangles[i];
+            binBounds[bin].grow(t.v0);
+            binBounds[bin].grow(t.v0 + t.edge1);
+            binBounds[bin].grow(t.v0 + t.edge2);
+            binCounts[bin]++;
+        }
+
+        float rightAreas[BVH_BINS];
+        uint32_t rightCounts[BVH_BINS];
+        Bounds right;
+        uint32_t rightCount = 0;
+        for (uint32_t b = BVH_BINS - 1; b > 0; b--) {
+            right.grow(binBounds[b]);
+            rightCount += binCounts[b];
+            rightAreas[b] = right.area();
+            rightCounts[b] = rightCount;
+        }
+
+        Bounds left;
+        uint32_t leftCount = 0;
+        for (uint32_t b = 1; b < BVH_BINS; b++) {
+            left.grow(binBounds[b - 1]);
+            leftCount += binCounts[b - 1];
+            if (leftCount == 0 || rightCounts[b] == 0) continue;
+            float cost = left.area() * leftCount + rightAreas[b] * rightCounts[b];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = a;
+                bestBin = b;
+            }
+        }
+    }
+
+    // Every centroid in the same spot, or a small node that does not pay off to split
+    if (bestAxis < 0 || (bestCost >= bounds.area() * count && count <= BVH_LEAF_SIZE * 4)) {
+        makeLeaf();
+        return;
+    }
+
+    float lo = axis(centroidBounds.min, bestAxis);
+    float scale = BVH_BINS / (axis(centroidBounds.max, bestAxis) - lo);
+    uint32_t mid = begin;
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t bin = std::min(static_cast<uint32_t>((axis(centroids[i], bestAxis) - lo) * scale), BVH_BINS - 1);
+        if (bin < bestBin) {
+            std::swap(triangles[i], triangles[mid]);
+            std::swap(triangleMaterials[i], triangleMaterials[mid]);
+            std::swap(centroids[i], centroids[mid]);
+            mid++;
+        }
+    }
+
+    uint32_t children = static_cast<uint32_t>(nodes.size());
+    nodes.push_back({});
+    nodes.push_back({});
+    nodes[nodeIndex].first = children;
+    nodes[nodeIndex].count = 0;
+    buildNode(children, begin, mid, centroids);
+    buildNode(children + 1, mid, end, centroids);
+}
+
+bool ReferenceScene::intersectTriangle(const Triangle& triangle, simd::float3 origin, simd::float3 direction, float tMin, float& t) const {
+    // Möller-Trumbore without culling, t is the current closest hit and only ever shrinks
+    simd::float3 p = simd::cross(direction, triangle.edge2);
+    float determinant = simd::dot(triangle.edge1, p);
+    if (std::abs(determinant) < 1e-12f) return false;
+
+    float inverseDeterminant = 1.0f / determinant;
+    simd::float3 s = origin - triangle.v0;
+    float u = simd::dot(s, p) * inverseDeterminant;
+    if (u < 0.0f || u > 1.0f) return false;
+
+    simd::float3 q = simd::cross(s, triangle.edge1);
+    float v = simd::dot(direction, q) * inverseDeterminant;
+    if (v < 0.0f || u + v > 1.0f) return false;
+
+    float distance = simd::dot(triangle.edge2, q) * inverseDeterminant;
+    if (distance < tMin || distance > t) return false;
+
+    t = distance;
+    return true;
+}
+
+bool ReferenceScene::intersect(simd::float3 origin, simd::float3 direction, float tMin, float tMax, ReferenceHit& hit) const {
+    if (nodes.empty() || tMax < tMin) return false;
+
+    simd::float3 inverseDirection{1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z};
+    float closest = tMax;
+    bool found = false;
+
+    uint32_t stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = nodes[stack[--stackSize]];
+        float tNear;
+        if (!intersectBounds(node.boundsMin, node.boundsMax, origin, inverseDirection, tMin, closest, tNear)) continue;
+
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                if (intersectTriangle(triangles[i], origin, direction, tMin, closest)) {
+                    hit.triangle = i;
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first so the farther one is usually culled by closest
+        float tLeft, tRight;
+        const Node& left = nodes[node.first];
+        const Node& right = nodes[node.first + 1];
+        bool hitLeft = intersectBounds(left.boundsMin, left.boundsMax, origin, inverseDirection, tMin, closest, tLeft);
+        bool hitRight = intersectBounds(right.boundsMin, right.boundsMax, origin, inverseDirection, tMin, closest, tRight);
+        if (hitLeft && hitRight) {
+            bool leftFirst = tLeft <= tRight;
+            stack[stackSize++] = leftFirst ? node.first + 1 : node.first;
+            stack[stackSize++] = leftFirst ? node.first : node.first + 1;
+        } else if (hitLeft) {
+            stack[stackSize++] = node.first;
+        } else if (hitRight) {
+            stack[stackSize++] = node.first + 1;
+        }
+    }
+
+    hit.distance = closest;
+    return found;
+}
+
+simd::float3 ReferenceScene::normal(uint32_t triangle) const {
+    return simd::normalize(simd::cross(triangles[triangle].edge1, triangles[triangle].edge2));
+}
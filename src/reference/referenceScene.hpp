@@ -0,0 +1,75 @@
+#pragma once
+
+#include <simd/simd.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../core/vertexData.hpp"
+
+// What the cascades need to know about a surface, the same data the ray tracing manager
+// puts into the triangle resources on the GPU
+struct ReferenceMaterial {
+    simd::float3    color;
+    bool            isEmissive;
+};
+
+struct ReferenceHit {
+    float           distance;
+    uint32_t        triangle;
+};
+
+// The scene on the CPU: world space triangles of every object and a BVH over them, so the
+// reference engine can trace the same rays the GPU kernels trace against the acceleration
+// structure. Triangles are hit from both sides, like the intersector with default options.
+class ReferenceScene {
+public:
+    // Reads a scene file and its OBJ meshes. Objects whose mesh fails to load are reported
+    // and skipped, false only if the scene file itself cannot be read or nothing loaded.
+    bool load(const std::string& scenePath);
+    // Meshes of the last load that could not be read or parsed. Measurements on a scene with
+    // missing meshes do not describe the scene.
+    const std::vector<std::string>& missingMeshes() const { return missing; }
+    bool isComplete() const { return missing.empty(); }
+
+    // Indices are triangles into positions, which are in object space
+    void addMesh(const std::vector<simd::float3>& positions, const std::vector<uint32_t>& indices, const MeshInfo& info);
+    // Must run after the last addMesh and before the first ray
+    void build();
+
+    // Closest hit with a distance in [tMin, tMax]
+    bool intersect(simd::float3 origin, simd::float3 direction, float tMin, float tMax, ReferenceHit& hit) const;
+
+    const ReferenceMaterial& material(uint32_t triangle) const { return materials[triangleMaterials[triangle]]; }
+    simd::float3 normal(uint32_t triangle) const;
+
+    size_t triangleCount() const { return triangles.size(); }
+    simd::float3 boundsMin() const { return nodes.empty() ? simd::float3{0.0f, 0.0f, 0.0f} : nodes[0].boundsMin; }
+    simd::float3 boundsMax() const { return nodes.empty() ? simd::float3{0.0f, 0.0f, 0.0f} : nodes[0].boundsMax; }
+
+private:
+    struct Triangle {
+        simd::float3    v0;
+        simd::float3    edge1;
+        simd::float3    edge2;
+    };
+
+    // Leaves hold count triangles from first, inner nodes have count 0 and their children
+    // at first and first + 1
+    struct Node {
+        simd::float3    boundsMin;
+        simd::float3    boundsMax;
+        uint32_t        first;
+        uint32_t        count;
+    };
+
+    void buildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, std::vector<simd::float3>& centroids);
+    bool intersectTriangle(const Triangle& triangle, simd::float3 origin, simd::float3 direction, float tMin, float& t) const;
+
+    std::vector<Triangle>           triangles;
+    std::vector<uint32_t>           triangleMaterials;
+    std::vector<ReferenceMaterial>  materials;
+    std::vector<Node>               nodes;
+    std::vector<std::string>        missing;
+};
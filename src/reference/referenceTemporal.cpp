@@ -0,0 +1,125 @@
+#include "referenceTemporal.hpp"
+#include "../core/taskScheduler.hpp"
+
+using namespace reference;
+
+TemporalAccumulator::TemporalAccumulator(const TemporalSettings& settings)
+: settings(settings) {
+}
+
+void TemporalAccumulator::reset() {
+    history = {};
+    previousGBuffer = {};
+}
+
+const ReferenceImage& TemporalAccumulator::accumulate(const ReferenceImage& irradiance, const ReferenceGBuffer& gBuffer, const FrameData& frameData,
+                                                      TaskScheduler& scheduler) {
+    if (history.width != gBuffer.width || history.height != gBuffer.height) {
+        reset();
+    }
+    accumulated.resize(gBuffer.width, gBuffer.height);
+
+    const bool hasHistory = !history.pixels.empty();
+    const int width = int(gBuffer.width);
+    const int height = int(gBuffer.height);
+
+    struct RowStats {
+        uint32_t    pixels = 0;
+        uint32_t    disoccluded = 0;
+        uint32_t    clamped = 0;
+    };
+    std::vector<RowStats> rowStats(gBuffer.height);
+
+    scheduler.parallelFor(gBuffer.height, [&](size_t row) {
+        const int y = int(row);
+        for (int x = 0; x < width; x++) {
+            size_t pixel = size_t(y) * width + x;
+            simd::float3 current = xyz(irradiance.pixels[pixel]);
+            if (gBuffer.isEmpty(uint32_t(x), uint32_t(y))) {
+                accumulated.pixels[pixel] = simd::float4{0.0f, 0.0f, 0.0f, 0.0f};
+                continue;
+            }
+            rowStats[row].pixels++;
+
+            // Back into the last frame
+            float depth = gBuffer.depth[pixel];
+            simd::float2 ndc{(x + 0.5f) / width * 2.0f - 1.0f, -((y + 0.5f) / height * 2.0f - 1.0f)};
+            simd::float3 world = reconstructWorldPositionFromLinearDepth(ndc, depth, frameData, 1.0f);
+            simd::float4 previousClip = matrix_multiply(frameData.previous_view_projection_matrix, simd::float4{world.x, world.y, world.z, 1.0f});
+            float previousDepth = previousClip.w;
+            float previousX = (previousClip.x / previousClip.w * 0.5f + 0.5f) * width - 0.5f;
+            float previousY = (0.5f - previousClip.y / previousClip.w * 0.5f) * height - 0.5f;
+
+            // Bilinear taps that saw the same surface
+            simd::float3 normal = xyz(gBuffer.normal[pixel]);
+            int baseX = int(std::floor(previousX));
+            int baseY = int(std::floor(previousY));
+            simd::float4 bilinear = bilinearWeights(simd::float2{fract(previousX), fract(previousY)});
+            simd::float3 previous{0.0f, 0.0f, 0.0f};
+            float previousLength = 0.0f;
+            float weightSum = 0.0f;
+
+            for (int i = 0; hasHistory && previousDepth > 0.0f && i < 4; i++) {
+                int tx = baseX + (i & 1);
+                int ty = baseY + (i >> 1);
+                if (tx < 0 || ty < 0 || tx >= width || ty >= height) continue;
+
+                size_t tap = size_t(ty) * width + tx;
+                if (previousGBuffer.isEmpty(uint32_t(tx), uint32_t(ty))) continue;
+                if (std::abs(previousGBuffer.depth[tap] - previousDepth) > settings.depthTolerance * previousDepth) continue;
+                if (simd::dot(xyz(previousGBuffer.normal[tap]), normal) < settings.minNormalCosine) continue;
+
+                float weight = component(bilinear, i);
+                previous += xyz(history.pixels[tap]) * weight;
+                previousLength += history.pixels[tap].w * weight;
+                weightSum += weight;
+            }
+
+            if (weightSum < 0.0001f) {
+                rowStats[row].disoccluded++;
+                accumulated.pixels[pixel] = simd::float4{current.x, current.y, current.z, 1.0f};
+                continue;
+            }
+            previous = previous / weightSum;
+            previousLength = previousLength / weightSum;
+
+            // Keeps history of lighting that has changed since from trailing behind
+            if (settings.varianceClamp > 0.0f) {
+                simd::float3 mean{0.0f, 0.0f, 0.0f};
+                simd::float3 meanSquared{0.0f, 0.0f, 0.0f};
+                float count = 0.0f;
+                for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, height - 1); ny++) {
+                    for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, width - 1); nx++) {
+                        if (gBuffer.isEmpty(uint32_t(nx), uint32_t(ny))) continue;
+                        simd::float3 sample = xyz(irradiance.pixels[size_t(ny) * width + nx]);
+                        mean += sample;
+                        meanSquared += sample * sample;
+                        count += 1.0f;
+                    }
+                }
+                mean = mean / count;
+                simd::float3 deviation = simd::sqrt(simd::max(meanSquared / count - mean * mean, simd::float3{0.0f, 0.0f, 0.0f}));
+                simd::float3 clamped = simd::clamp(previous, mean - deviation * settings.varianceClamp, mean + deviation * settings.varianceClamp);
+                if (simd::length(clamped - previous) > 0.0f) rowStats[row].clamped++;
+                previous = clamped;
+            }
+
+            // Past the point where minBlend takes over the length no longer matters
+            float length = std::min(previousLength + 1.0f, 1.0f / settings.minBlend);
+            float blend = std::max(1.0f / length, settings.minBlend);
+            simd::float3 result = lerp(previous, current, blend);
+            accumulated.pixels[pixel] = simd::float4{result.x, result.y, result.z, length};
+        }
+    });
+
+    stats = {};
+    for (const RowStats& row : rowStats) {
+        stats.pixels += row.pixels;
+        stats.disoccluded += row.disoccluded;
+        stats.clamped += row.clamped;
+    }
+
+    std::swap(history, accumulated);
+    previousGBuffer = gBuffer;
+    return history;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <simd/simd.h>
+
+#include <cstdint>
+
+#include "referenceFrame.hpp"
+#include "referenceImage.hpp"
+
+class TaskScheduler;
+
+struct TemporalSettings {
+    // Weight of the current frame once the history is long enough. Fresh history starts
+    // with the average of the frames it has seen.
+    float   minBlend = 0.1f;
+    // History is dropped where the reprojected depth differs from the depth stored last
+    // frame by more than this fraction, or where the normals turned further apart
+    float   depthTolerance = 0.05f;
+    float   minNormalCosine = 0.9f;
+    // History is clamped to the mean plus or minus this many standard deviations of the
+    // current 3x3 neighborhood, 0 turns the clamp off
+    float   varianceClamp = 1.0f;
+};
+
+struct TemporalStats {
+    // Pixels with geometry this frame
+    uint64_t    pixels = 0;
+    // Of those, the ones without usable history: off screen last frame or disoccluded
+    uint64_t    disoccluded = 0;
+    // History moved by the variance clamp
+    uint64_t    clamped = 0;
+};
+
+// Accumulates the gathered irradiance over frames. Every pixel is reprojected into the
+// last frame with FrameData::previous_view_projection_matrix and its linear depth, the
+// history is fetched with the bilinear taps that pass the depth and normal tests, clamped
+// to the current neighborhood and blended with the current frame.
+class TemporalAccumulator {
+public:
+    explicit TemporalAccumulator(const TemporalSettings& settings = {});
+
+    // irradiance comes from referenceGatherIrradiance for gBuffer. The result is the new
+    // history, before the albedo, with the number of frames accumulated in alpha.
+    const ReferenceImage& accumulate(const ReferenceImage& irradiance, const ReferenceGBuffer& gBuffer, const FrameData& frameData,
+                                     TaskScheduler& scheduler);
+    void reset();
+
+    const TemporalSettings& getSettings() const { return settings; }
+    const TemporalStats& getStats() const { return stats; }
+
+private:
+    TemporalSettings    settings;
+    ReferenceImage      history;
+    ReferenceImage      accumulated;
+    ReferenceGBuffer    previousGBuffer;
+    TemporalStats       stats;
+};
@@ -0,0 +1,814 @@
+// Experiments on the CPU reference of the radiance cascades, built next to the renderer.
+//
+//   cascadeReference split [options]    Fused trace and merge per level against tracing
+//                                       every level at once and merging afterwards
+//   cascadeReference amortize [options] Traces far levels less often than every frame
+//                                       along a camera path, against full updates
+//   cascadeReference probes [options]   Probe positions from a per-level table against
+//                                       reconstructing them for every ray
+//   cascadeReference prefilter [options] Merging from upper levels averaged to the rays of
+//                                       the level below against the 16 tap merge
+//   cascadeReference irradiance [options] Final gather from L1 and L2 probe irradiance
+//                                       against the loop over the probe rays
+//   cascadeReference density [options]  Coarse cascade 0 probes on flat blocks, rays saved
+//                                       against the error for a few thresholds
+//   cascadeReference upsample [options] Half and quarter resolution cascades and gather with
+//                                       joint bilateral upsampling, at 1080p, 1440p and 4K
+//                                       unless --size is given
+//   cascadeReference classify [options] Probes skipped on empty tiles in every bundled
+//                                       scene whose meshes all load, --scene is not used
+//   cascadeReference temporal [options] Reprojected and accumulated gather along a camera
+//                                       path with and without the variance clamp, against
+//                                       the gather of each frame alone
+//   cascadeReference jitter [options]   Rays jittered inside their octahedral cells with
+//                                       blue noise, accumulated at 4 and 2 rays per side
+//                                       of cascade 0, against the fixed cell centers
+//
+// Options:
+//   --scene <file>         Scene to render, cornellBox.json by default
+//   --size <W>x<H>         Framebuffer size, 640x360 by default
+//   --camera x,y,z,yaw,pitch
+//   --frame <n>            Frame number, moves the sun like in the renderer
+//   --runs <n>             Timings are the best of this many runs, 3 by default
+//   --threads <n>          Highest thread count to measure, the calling thread included
+//   --out <directory>      Writes the final gather of every variant as PNG
+//   --frames <n>           Length of the camera path, 32 by default
+//   --budget <ms>          Trace budget per frame, half of a full update by default
+//   --path <file>          Recorded camera path instead of the built in one, a line of
+//                          x y z yaw pitch per frame
+//
+// Timings include everything the schedule does but not the G-buffer, which is shared.
+
+#include "taskScheduler.hpp"
+#include "../src/reference/referenceCascades.hpp"
+#include "../src/reference/referenceFrame.hpp"
+#include "../src/reference/referenceGather.hpp"
+#include "../src/reference/referenceRefresh.hpp"
+#include "../src/reference/referenceScene.hpp"
+#include "../src/reference/referenceTemporal.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string     scenePath = std::string(SCENES_PATH) + "/cornellBox.json";
+    uint32_t        width = 640;
+    uint32_t        height = 360;
+    ReferenceCamera camera;
+    uint32_t        frame = 0;
+    int             runs = 3;
+    size_t          maxThreads = TaskScheduler::defaultThreadCount() + 1;
+    std::string     outDirectory;
+    bool            sizeGiven = false;
+    uint32_t        frames = 32;
+    double          budgetMs = 0.0;
+    // Replaces the built in path, frames is its length
+    std::vector<ReferenceCamera> path;
+};
+
+// Everything the experiments share: the scene and one frame of it
+struct Setup {
+    Options             options;
+    ReferenceScene      scene;
+    FrameData           frameData;
+    ReferenceGBuffer    gBuffer;
+};
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Best of several runs, the first one also pays for warming the caches
+template<typename Body>
+double bestOf(int runs, const Body& body) {
+    double best = 0.0;
+    for (int run = 0; run < runs; run++) {
+        auto start = Clock::now();
+        body();
+        double ms = elapsedMs(start);
+        if (run == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+void writeImage(const Setup& setup, const ReferenceImage& image, const std::string& name) {
+    if (setup.options.outDirectory.empty()) return;
+
+    std::filesystem::create_directories(setup.options.outDirectory);
+    std::string path = setup.options.outDirectory + "/" + name + ".png";
+    if (!image.writePNG(path)) {
+        std::fprintf(stderr, "Failed to write %s\n", path.c_str());
+    }
+}
+
+void printError(const char* label, const ReferenceImageError& error) {
+    std::printf("  %-28s rmse %.6f  max %.6f  psnr %6.2f dB  %5.2f%% pixels off\n",
+                label, error.rmse, error.maxError, error.psnr, error.badPixelFraction * 100.0);
+}
+
+size_t raysPerFrame(const Setup& setup, const ReferenceCascadeSettings& settings = {}) {
+    size_t rays = 0;
+    for (int l = 0; l < settings.levels; l++) {
+        rays += makeCascadeLevelLayout(l, setup.gBuffer.width, setup.gBuffer.height, settings).rayCount();
+    }
+    return rays;
+}
+
+float largestRadianceDifference(const ReferenceCascades& a, const ReferenceCascades& b) {
+    float largest = 0.0f;
+    for (int l = 0; l < a.levelCount(); l++) {
+        for (size_t i = 0; i < a.radiance(l).size(); i++) {
+            simd::float4 d = a.radiance(l)[i] - b.radiance(l)[i];
+            largest = std::max({largest, std::abs(d.x), std::abs(d.y), std::abs(d.z)});
+        }
+    }
+    return largest;
+}
+
+int commandSplit(Setup& setup) {
+    std::printf("fused against split schedule, %d levels, %zu rays per frame\n", MAX_CASCADE_LEVEL, raysPerFrame(setup));
+
+    double single = 0.0;
+    for (size_t threads = 1; threads <= setup.options.maxThreads; threads *= 2) {
+        TaskScheduler scheduler(threads - 1);
+        ReferenceCascades cascades(setup.scene, scheduler);
+
+        double fused = bestOf(setup.options.runs, [&]() {
+            cascades.render(setup.gBuffer, setup.frameData, CascadeSchedule::Fused);
+        });
+
+        ReferenceCascadeStats best;
+        double split = bestOf(setup.options.runs, [&]() {
+            cascades.render(setup.gBuffer, setup.frameData, CascadeSchedule::Split);
+            if (best.totalMs == 0.0 || cascades.getStats().totalMs < best.totalMs) best = cascades.getStats();
+        });
+
+        if (threads == 1) single = fused;
+        std::printf("  %2zu threads  fused %9.2f ms  split %9.2f ms (trace %9.2f, merge %8.2f)  %5.2fx over fused, fused %5.2fx over 1 thread\n",
+                    threads, fused, split, best.traceMs, best.mergeMs, fused / split, single / fused);
+    }
+
+    // Both schedules must produce the same radiance
+    ReferenceCascades fused(setup.scene, TaskScheduler::shared());
+    ReferenceCascades split(setup.scene, TaskScheduler::shared());
+    fused.render(setup.gBuffer, setup.frameData, CascadeSchedule::Fused);
+    split.render(setup.gBuffer, setup.frameData, CascadeSchedule::Split);
+
+    std::printf("  largest radiance difference between the schedules: %g\n", largestRadianceDifference(fused, split));
+
+    ReferenceImage fusedImage = referenceFinalGather(fused, setup.gBuffer, setup.frameData, true, TaskScheduler::shared());
+    ReferenceImage splitImage = referenceFinalGather(split, setup.gBuffer, setup.frameData, true, TaskScheduler::shared());
+    printError("split against fused", compareImages(splitImage, fusedImage));
+    writeImage(setup, fusedImage, "fused");
+    writeImage(setup, splitImage, "split");
+    return 0;
+}
+
+int commandProbes(Setup& setup) {
+    ReferenceCascadeSettings perRay;
+    perRay.probeTable = false;
+    ReferenceCascades table(setup.scene, TaskScheduler::shared());
+    ReferenceCascades noTable(setup.scene, TaskScheduler::shared(), perRay);
+
+    std::printf("probe table against positions per ray, %zu rays per frame\n", raysPerFrame(setup));
+    for (CascadeSchedule schedule : {CascadeSchedule::Fused, CascadeSchedule::Split}) {
+        const char* name = (schedule == CascadeSchedule::Fused) ? "fused" : "split";
+        double perRayMs = bestOf(setup.options.runs, [&]() { noTable.render(setup.gBuffer, setup.frameData, schedule); });
+        double tableMs = bestOf(setup.options.runs, [&]() { table.render(setup.gBuffer, setup.frameData, schedule); });
+        const ReferenceCascadeStats& before = noTable.getStats();
+        const ReferenceCascadeStats& after = table.getStats();
+
+        std::printf("  %s\n", name);
+        std::printf("    per ray  %9.2f ms  %10llu depth fetches  %10llu transforms\n", perRayMs,
+                    (unsigned long long)before.depthFetches, (unsigned long long)before.positionTransforms);
+        std::printf("    table    %9.2f ms  %10llu depth fetches  %10llu transforms  (%.2f ms building it)\n", tableMs,
+                    (unsigned long long)after.depthFetches, (unsigned long long)after.positionTransforms, after.probeMs);
+        std::printf("    %.2fx faster, %.0fx fewer depth fetches and transforms, largest radiance difference %g\n",
+                    perRayMs / tableMs, double(before.depthFetches) / double(after.depthFetches), largestRadianceDifference(table, noTable));
+    }
+
+    uint64_t probeCount = 0;
+    for (int l = 0; l < table.levelCount(); l++) {
+        probeCount += table.layout(l).probeCount();
+    }
+    std::printf("  %llu of %llu probes sit on the far plane\n", (unsigned long long)table.getStats().emptyProbes, (unsigned long long)probeCount);
+    return 0;
+}
+
+int commandPrefilter(Setup& setup) {
+    ReferenceCascadeSettings taps;
+    taps.prefilterUpper = false;
+    ReferenceCascades prefiltered(setup.scene, TaskScheduler::shared());
+    ReferenceCascades sixteenTaps(setup.scene, TaskScheduler::shared(), taps);
+
+    std::printf("prefiltered merge against 16 taps per ray, %zu rays per frame\n", raysPerFrame(setup));
+    for (ReferenceCascades* cascades : {&sixteenTaps, &prefiltered}) {
+        const char* name = (cascades == &prefiltered) ? "prefiltered" : "16 taps";
+        ReferenceCascadeStats best;
+        bestOf(setup.options.runs, [&]() {
+            cascades->render(setup.gBuffer, setup.frameData, CascadeSchedule::Split);
+            if (best.totalMs == 0.0 || cascades->getStats().mergeMs < best.mergeMs) best = cascades->getStats();
+        });
+        double fused = bestOf(setup.options.runs, [&]() { cascades->render(setup.gBuffer, setup.frameData, CascadeSchedule::Fused); });
+
+        std::printf("  %-12s merge %8.2f ms (prefilter %6.2f)  %10llu fetches  frame %8.2f ms split, %8.2f ms fused\n", name,
+                    best.mergeMs, best.prefilterMs, (unsigned long long)best.mergeFetches, best.totalMs, fused);
+    }
+
+    std::printf("  largest radiance difference %g\n", largestRadianceDifference(prefiltered, sixteenTaps));
+    ReferenceImage prefilteredImage = referenceFinalGather(prefiltered, setup.gBuffer, setup.frameData, true, TaskScheduler::shared());
+    ReferenceImage tapsImage = referenceFinalGather(sixteenTaps, setup.gBuffer, setup.frameData, true, TaskScheduler::shared());
+    printError("prefiltered against 16 taps", compareImages(prefilteredImage, tapsImage));
+    writeImage(setup, prefilteredImage, "prefiltered");
+    writeImage(setup, tapsImage, "taps");
+    return 0;
+}
+
+int commandIrradiance(Setup& setup) {
+    ReferenceCascades cascades(setup.scene, TaskScheduler::shared());
+    cascades.render(setup.gBuffer, setup.frameData, CascadeSchedule::Split);
+
+    ReferenceImage bruteForce;
+    double bruteForceMs = bestOf(setup.options.runs, [&]() {
+        bruteForce = referenceFinalGather(cascades, setup.gBuffer, setup.frameData, true, TaskScheduler::shared());
+    });
+    std::printf("final gather from probe irradiance, %u cascade 0 probes of %u rays\n", cascades.layout(0).probeCount(), cascades.layout(0).numRays);
+    std::printf("  %-12s gather %8.2f ms\n", "rays", bruteForceMs);
+    writeImage(setup, bruteForce, "gather_rays");
+
+    for (int order : {1, 2}) {
+        std::vector<ProbeIrradiance> irradiance;
+        double projectMs = bestOf(setup.options.runs, [&]() {
+            irradiance = projectProbeIrradiance(cascades, order, TaskScheduler::shared());
+        });
+        ReferenceImage image;
+        double gatherMs = bestOf(setup.options.runs, [&]() {
+            image = referenceFinalGather(cascades, irradiance, order, setup.gBuffer, setup.frameData, true, TaskScheduler::shared());
+        });
+
+        std::string name = "L" + std::to_string(order);
+        std::printf("  %-12s gather %8.2f ms  projection %6.2f ms  speedup %5.2fx\n", name.c_str(), gatherMs, projectMs,
+                    bruteForceMs / (gatherMs + projectMs));
+        printError((name + " against rays").c_str(), compareImages(image, bruteForce));
+        writeImage(setup, image, "gather_" + name);
+    }
+    return 0;
+}
+
+int commandDensity(Setup& setup) {
+    ReferenceCascades uniform(setup.scene, TaskScheduler::shared());
+    double uniformMs = bestOf(setup.options.runs, [&]() { uniform.render(setup.gBuffer, setup.frameData, CascadeSchedule::Split); });
+    ReferenceImage uniformImage = referenceFinalGather(uniform, setup.gBuffer, setup.frameData, true, TaskScheduler::shared());
+    const uint64_t uniformRays = uniform.getStats().raysTraced;
+
+    std::printf("adaptive cascade 0 density, uniform %llu rays in %.2f ms\n", (unsigned long long)uniformRays, uniformMs);
+    const std::pair<float, float> thresholds[] = {{0.005f, 0.001f}, {0.02f, 0.005f}, {0.05f, 0.02f}, {0.2f, 0.1f}};
+    for (auto [depthRatio, normalSpread] : thresholds) {
+        ReferenceCascadeSettings settings;
+        settings.adaptiveDensity = true;
+        settings.flatDepthRatio = depthRatio;
+        settings.flatNormalSpread = normalSpread;
+        ReferenceCascades adaptive(setup.scene, TaskScheduler::shared(), settings);
+        double adaptiveMs = bestOf(setup.options.runs, [&]() { adaptive.render(setup.gBuffer, setup.frameData, CascadeSchedule::Split); });
+
+        const CascadeDensityBlocks& blocks = adaptive.densityBlocks();
+        size_t coarseBlocks = std::count(blocks.coarse.begin(), blocks.coarse.end(), uint8_t(1));
+        uint64_t rays = adaptive.getStats().raysTraced;
+
+        std::printf("  depth %.3f normals %.3f: %5.1f%% blocks coarse, %5.1f%% of the rays saved, %8.2f ms, %5.2fx faster\n",
+                    depthRatio, normalSpread, 100.0 * double(coarseBlocks) / double(blocks.coarse.size()),
+                    100.0 * double(uniformRays - rays) / double(uniformRays), adaptiveMs, uniformMs / adaptiveMs);
+        ReferenceImage image = referenceFinalGather(adaptive, setup.gBuffer, setup.frameData, true, TaskScheduler::shared());
+        printError("against uniform", compareImages(image, uniformImage));
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "density_%.3f", depthRatio);
+        writeImage(setup, image, name);
+    }
+    return 0;
+}
+
+// Pixels next to a silhouette or a crease, where upsampling goes wrong first
+std::vector<uint8_t> edgeMask(const ReferenceGBuffer& gBuffer) {
+    std::vector<uint8_t> mask(gBuffer.depth.size(), 0);
+    auto differs = [&](size_t a, size_t b) {
+        bool emptyA = gBuffer.albedo[a].x == 0.0f && gBuffer.albedo[a].y == 0.0f && gBuffer.albedo[a].z == 0.0f;
+        bool emptyB = gBuffer.albedo[b].x == 0.0f && gBuffer.albedo[b].y == 0.0f && gBuffer.albedo[b].z == 0.0f;
+        if (emptyA || emptyB) return emptyA != emptyB;
+        return std::abs(gBuffer.depth[a] - gBuffer.depth[b]) > 0.05f * std::min(gBuffer.depth[a], gBuffer.depth[b])
+            || simd::dot(reference::xyz(gBuffer.normal[a]), reference::xyz(gBuffer.normal[b])) < 0.9f;
+    };
+    for (uint32_t y = 0; y < gBuffer.height; y++) {
+        for (uint32_t x = 0; x < gBuffer.width; x++) {
+            size_t pixel = size_t(y) * gBuffer.width + x;
+            if ((x + 1 < gBuffer.width && differs(pixel, pixel + 1)) || (y + 1 < gBuffer.height && differs(pixel, pixel + gBuffer.width))) {
+                mask[pixel] = 1;
+                if (x + 1 < gBuffer.width) mask[pixel + 1] = 1;
+                if (y + 1 < gBuffer.height) mask[pixel + gBuffer.width] = 1;
+            }
+        }
+    }
+    return mask;
+}
+
+int commandUpsample(Setup& setup) {
+    std::vector<std::pair<uint32_t, uint32_t>> sizes = {{1920, 1080}, {2560, 1440}, {3840, 2160}};
+    if (setup.options.sizeGiven) sizes = {{setup.options.width, setup.options.height}};
+
+    // Plain bilinear upsampling, to see what the bilateral weights are worth
+    BilateralUpsampleSettings bilinear;
+    bilinear.depthSigma = INFINITY;
+    bilinear.normalPower = 0.0f;
+
+    std::printf("lower resolution cascades and gather against full resolution\n");
+    for (auto [width, height] : sizes) {
+        FrameData frameData = makeReferenceFrameData(setup.options.camera, width, height, setup.options.frame);
+        ReferenceGBuffer gBuffer = renderReferenceGBuffer(setup.scene, frameData, TaskScheduler::shared());
+        std::vector<uint8_t> edges = edgeMask(gBuffer);
+        size_t edgeCount = std::count(edges.begin(), edges.end(), uint8_t(1));
+
+        ReferenceCascades full(setup.scene, TaskScheduler::shared());
+        ReferenceImage fullImage;
+        double fullMs = bestOf(setup.options.runs, [&]() {
+            full.render(gBuffer, frameData, CascadeSchedule::Split);
+            fullImage = referenceFinalGather(full, gBuffer, frameData, true, TaskScheduler::shared());
+        });
+        std::printf("  %ux%u, %.1f%% edge pixels\n", width, height, 100.0 * double(edgeCount) / double(edges.size()));
+        std::printf("    full       %9.2f ms\n", fullMs);
+        writeImage(setup, fullImage, "upsample_" + std::to_string(height) + "_full");
+
+        for (uint32_t factor : {2u, 4u}) {
+            ReferenceCascades low(setup.scene, TaskScheduler::shared());
+            ReferenceGBuffer lowGBuffer;
+            ReferenceImage lowIrradiance;
+            ReferenceImage image;
+            double lowMs = 0.0;
+            double upsampleMs = 0.0;
+            double totalMs = bestOf(setup.options.runs, [&]() {
+                auto start = Clock::now();
+                lowGBuffer = downsampleGBuffer(gBuffer, factor);
+                FrameData lowFrameData = frameData;
+                lowFrameData.framebuffer_width = lowGBuffer.width;
+                lowFrameData.framebuffer_height = lowGBuffer.height;
+                low.render(lowGBuffer, lowFrameData, CascadeSchedule::Split);
+                lowIrradiance = referenceGatherIrradiance(low, lowGBuffer, lowFrameData, TaskScheduler::shared());
+                lowMs = elapsedMs(start);
+
+                auto upsampleStart = Clock::now();
+                image = upsampleGather(lowIrradiance, lowGBuffer, gBuffer, frameData, true, TaskScheduler::shared());
+                upsampleMs = elapsedMs(upsampleStart);
+            });
+
+            ReferenceImage bilinearImage = upsampleGather(lowIrradiance, lowGBuffer, gBuffer, frameData, true, TaskScheduler::shared(), bilinear);
+            std::string name = "1/" + std::to_string(factor);
+            std::printf("    %-10s %9.2f ms (upsampling %7.2f ms)  %5.2fx faster\n", name.c_str(), totalMs, upsampleMs, fullMs / totalMs);
+            printError((name + " bilateral").c_str(), compareImages(image, fullImage));
+            printError((name + " bilateral, edges").c_str(), compareImages(image, fullImage, 0.05f, &edges));
+            printError((name + " bilinear, edges").c_str(), compareImages(bilinearImage, fullImage, 0.05f, &edges));
+            writeImage(setup, image, "upsample_" + std::to_string(height) + "_" + std::to_string(factor));
+        }
+    }
+    return 0;
+}
+
+int commandClassify(Setup& setup) {
+    std::vector<std::filesystem::path> scenePaths;
+    for (const auto& entry : std::filesystem::directory_iterator(SCENES_PATH)) {
+        if (entry.path().extension() == ".json") scenePaths.push_back(entry.path());
+    }
+    std::sort(scenePaths.begin(), scenePaths.end());
+
+    ReferenceCascadeSettings everyProbe;
+    everyProbe.skipEmptyProbes = false;
+
+    std::printf("empty probes resolved from the sky model instead of traced\n");
+    for (const std::filesystem::path& path : scenePaths) {
+        ReferenceScene scene;
+        if (!scene.load(path.string())) continue;
+        // Without its main mesh a scene is mostly empty tiles, which says nothing about it
+        if (!scene.isComplete()) {
+            std::printf("  %s: skipped, %zu mesh(es) missing\n", path.filename().string().c_str(), scene.missingMeshes().size());
+            continue;
+        }
+        ReferenceGBuffer gBuffer = renderReferenceGBuffer(scene, setup.frameData, TaskScheduler::shared());
+
+        ReferenceCascades skipping(scene, TaskScheduler::shared());
+        ReferenceCascades all(scene, TaskScheduler::shared(), everyProbe);
+        double allMs = bestOf(setup.options.runs, [&]() { all.render(gBuffer, setup.frameData, CascadeSchedule::Split); });
+        double skippingMs = bestOf(setup.options.runs, [&]() { skipping.render(gBuffer, setup.frameData, CascadeSchedule::Split); });
+
+        const ReferenceCascadeStats& stats = skipping.getStats();
+        std::string perLevel;
+        uint64_t probeCount = 0;
+        for (int l = 0; l < skipping.levelCount(); l++) {
+            const std::vector<ReferenceCascades::Probe>& probes = skipping.probes(l);
+            size_t empty = std::count_if(probes.begin(), probes.end(), [](const ReferenceCascades::Probe& probe) { return !probe.valid; });
+            char level[16];
+            std::snprintf(level, sizeof(level), " %5.1f%%", 100.0 * double(empty) / double(probes.size()));
+            perLevel += level;
+            probeCount += probes.size();
+        }
+
+        std::printf("  %s: %zu triangles\n", path.filename().string().c_str(), scene.triangleCount());
+        std::printf("    probes skipped %5.1f%%, per level%s\n", 100.0 * double(stats.skippedProbes) / double(probeCount), perLevel.c_str());
+        std::printf("    rays traced %5.1f%%, %8.2f ms against %8.2f ms, %5.2fx faster\n",
+                    100.0 * double(stats.raysTraced) / double(all.getStats().raysTraced), skippingMs, allMs, allMs / skippingMs);
+
+        ReferenceImage skippingImage = referenceFinalGather(skipping, gBuffer, setup.frameData, true, TaskScheduler::shared());
+        ReferenceImage allImage = referenceFinalGather(all, gBuffer, setup.frameData, true, TaskScheduler::shared());
+        printError("skipping against all", compareImages(skippingImage, allImage));
+        writeImage(setup, skippingImage, "classify_" + path.stem().string());
+    }
+    return 0;
+}
+
+// A slow pan and drift with one cut halfway through, which has to invalidate stored levels
+ReferenceCamera pathCamera(const Options& options, uint32_t frame) {
+    if (!options.path.empty()) return options.path[std::min<size_t>(frame, options.path.size() - 1)];
+
+    ReferenceCamera camera = options.camera;
+    camera.yaw += 0.25f * frame;
+    camera.position.z += 0.02f * frame;
+    if (frame >= options.frames / 2) camera.position.x -= 2.0f;
+    return camera;
+}
+
+std::string levelList(uint32_t mask, int levels) {
+    std::string list;
+    for (int l = 0; l < levels; l++) {
+        list += (mask & (1u << l)) ? char('0' + l) : '.';
+    }
+    return list;
+}
+
+int commandAmortize(Setup& setup) {
+    const Options& options = setup.options;
+    const ReferenceCascadeSettings cascadeSettings;
+    const size_t fullRays = raysPerFrame(setup, cascadeSettings);
+
+    ReferenceCascades full(setup.scene, TaskScheduler::shared(), cascadeSettings);
+    double budgetMs = options.budgetMs;
+    if (budgetMs <= 0.0) {
+        full.render(setup.gBuffer, setup.frameData, CascadeSchedule::Split);
+        budgetMs = full.getStats().traceMs * 0.5;
+    }
+
+    struct Variant {
+        const char*                 name;
+        CascadeRefreshScheduler     refresh;
+        ReferenceCascades           cascades;
+        uint64_t                    rays = 0;
+        double                      traceMs = 0.0;
+        double                      rmseSum = 0.0;
+        double                      rmseMax = 0.0;
+        double                      badPixelSum = 0.0;
+
+        Variant(const char* name, const Setup& setup, const ReferenceCascadeSettings& cascadeSettings, const CascadeRefreshSettings& settings)
+        : name(name), refresh(cascadeSettings, settings), cascades(setup.scene, TaskScheduler::shared(), cascadeSettings) {}
+    };
+
+    CascadeRefreshSettings interval;
+    interval.mode = CascadeRefreshMode::Interval;
+    CascadeRefreshSettings budget;
+    budget.mode = CascadeRefreshMode::Budget;
+    budget.budgetMs = budgetMs;
+
+    std::vector<std::unique_ptr<Variant>> variants;
+    variants.push_back(std::make_unique<Variant>("interval", setup, cascadeSettings, interval));
+    variants.push_back(std::make_unique<Variant>("budget", setup, cascadeSettings, budget));
+
+    std::printf("amortized updates over %u frames, %zu rays per full update, budget %.2f ms\n", options.frames, fullRays, budgetMs);
+    std::printf("  frame");
+    for (const auto& variant : variants) {
+        std::printf("  %-8s levels    rays      rmse", variant->name);
+    }
+    std::printf("\n");
+
+    for (uint32_t frame = 0; frame < options.frames; frame++) {
+        FrameData frameData = makeReferenceFrameData(pathCamera(options, frame), options.width, options.height, options.frame + frame);
+        ReferenceGBuffer gBuffer = renderReferenceGBuffer(setup.scene, frameData, TaskScheduler::shared());
+
+        full.render(gBuffer, frameData, CascadeSchedule::Split);
+        ReferenceImage fullImage = referenceFinalGather(full, gBuffer, frameData, true, TaskScheduler::shared());
+
+        std::printf("  %5u", frame);
+        for (auto& variant : variants) {
+            uint32_t mask = variant->refresh.levelsToTrace(frameData, 0);
+            variant->cascades.render(gBuffer, frameData, CascadeSchedule::Split, mask);
+            const ReferenceCascadeStats& stats = variant->cascades.getStats();
+            variant->refresh.traced(stats);
+
+            ReferenceImage image = referenceFinalGather(variant->cascades, gBuffer, frameData, true, TaskScheduler::shared());
+            ReferenceImageError error = compareImages(image, fullImage);
+            variant->rays += stats.raysTraced;
+            variant->traceMs += stats.traceMs;
+            variant->rmseSum += error.rmse;
+            variant->rmseMax = std::max(variant->rmseMax, error.rmse);
+            variant->badPixelSum += error.badPixelFraction;
+
+            std::printf("           %-6s  %5.1f%%  %.6f", levelList(stats.tracedLevels, variant->cascades.levelCount()).c_str(),
+                        100.0 * double(stats.raysTraced) / double(fullRays), error.rmse);
+            if (frame + 1 == options.frames) writeImage(setup, image, variant->name);
+        }
+        std::printf("\n");
+        if (frame + 1 == options.frames) writeImage(setup, fullImage, "full");
+    }
+
+    for (const auto& variant : variants) {
+        std::printf("  %-8s %5.1f%% of the rays, %8.2f ms tracing per frame, rmse mean %.6f max %.6f, %5.2f%% pixels off on average\n",
+                    variant->name, 100.0 * double(variant->rays) / (double(fullRays) * options.frames), variant->traceMs / options.frames,
+                    variant->rmseSum / options.frames, variant->rmseMax, 100.0 * variant->badPixelSum / options.frames);
+    }
+    return 0;
+}
+
+int commandTemporal(Setup& setup) {
+    const Options& options = setup.options;
+    const ReferenceCascadeSettings cascadeSettings;
+    ReferenceCascades cascades(setup.scene, TaskScheduler::shared(), cascadeSettings);
+
+    struct Variant {
+        const char*             name;
+        TemporalAccumulator     accumulator;
+        uint64_t                pixels = 0;
+        uint64_t                disoccluded = 0;
+        uint64_t                clamped = 0;
+        double                  rmseSum = 0.0;
+        double                  rmseMax = 0.0;
+        double                  accumulateMs = 0.0;
+    };
+
+    TemporalSettings unclamped;
+    unclamped.varianceClamp = 0.0f;
+    std::vector<std::unique_ptr<Variant>> variants;
+    variants.push_back(std::make_unique<Variant>(Variant{"clamped", TemporalAccumulator()}));
+    variants.push_back(std::make_unique<Variant>(Variant{"unclamped", TemporalAccumulator(unclamped)}));
+
+    // The difference to the frame's own gather is what the history drags along: lag behind
+    // the moving sun and ghosts of surfaces that are no longer there
+    std::printf("temporal accumulation over %u frames, error against the gather of each frame\n", options.frames);
+    std::printf("  frame  disoccluded");
+    for (const auto& variant : variants) {
+        std::printf("  %-9s clamped      rmse", variant->name);
+    }
+    std::printf("\n");
+
+    FrameData previousFrameData;
+    for (uint32_t frame = 0; frame < options.frames; frame++) {
+        FrameData frameData = makeReferenceFrameData(pathCamera(options, frame), options.width, options.height, options.frame + frame,
+                                                     (frame > 0) ? &previousFrameData : nullptr);
+        ReferenceGBuffer gBuffer = renderReferenceGBuffer(setup.scene, frameData, TaskScheduler::shared());
+
+        cascades.render(gBuffer, frameData, CascadeSchedule::Split);
+        ReferenceImage irradiance = referenceGatherIrradiance(cascades, gBuffer, frameData, TaskScheduler::shared());
+        ReferenceImage currentImage = applyAlbedo(irradiance, gBuffer, frameData, true, TaskScheduler::shared());
+
+        for (size_t v = 0; v < variants.size(); v++) {
+            Variant& variant = *variants[v];
+            auto start = Clock::now();
+            const ReferenceImage& accumulated = variant.accumulator.accumulate(irradiance, gBuffer, frameData, TaskScheduler::shared());
+            variant.accumulateMs += elapsedMs(start);
+
+            ReferenceImage image = applyAlbedo(accumulated, gBuffer, frameData, true, TaskScheduler::shared());
+            ReferenceImageError error = compareImages(image, currentImage);
+            const TemporalStats& stats = variant.accumulator.getStats();
+            variant.pixels += stats.pixels;
+            variant.disoccluded += stats.disoccluded;
+            variant.clamped += stats.clamped;
+            variant.rmseSum += error.rmse;
+            variant.rmseMax = std::max(variant.rmseMax, error.rmse);
+
+            // Both reject the same pixels, the clamp only changes what happens to the rest
+            if (v == 0) std::printf("  %5u  %10.1f%%", frame, 100.0 * double(stats.disoccluded) / double(std::max<uint64_t>(stats.pixels, 1)));
+            std::printf("            %6.1f%%  %.6f", 100.0 * double(stats.clamped) / double(std::max<uint64_t>(stats.pixels, 1)), error.rmse);
+            if (frame + 1 == options.frames) writeImage(setup, image, std::string("temporal_") + variant.name);
+        }
+        std::printf("\n");
+        if (frame + 1 == options.frames) writeImage(setup, currentImage, "temporal_current");
+        previousFrameData = frameData;
+    }
+
+    for (const auto& variant : variants) {
+        std::printf("  %-9s %5.2f%% disoccluded, %5.2f%% clamped, rmse mean %.6f max %.6f, %.2f ms per frame\n", variant->name,
+                    100.0 * double(variant->disoccluded) / double(std::max<uint64_t>(variant->pixels, 1)),
+                    100.0 * double(variant->clamped) / double(std::max<uint64_t>(variant->pixels, 1)),
+                    variant->rmseSum / options.frames, variant->rmseMax, variant->accumulateMs / options.frames);
+    }
+    return 0;
+}
+
+int commandJitter(Setup& setup) {
+    const Options& options = setup.options;
+
+    struct Variant {
+        std::string                 name;
+        ReferenceCascadeSettings    settings;
+        ReferenceCascades           cascades;
+        TemporalAccumulator         accumulator;
+
+        Variant(const std::string& name, const Setup& setup, const ReferenceCascadeSettings& settings, const TemporalSettings& temporal = {})
+        : name(name), settings(settings), cascades(setup.scene, TaskScheduler::shared(), settings), accumulator(temporal) {}
+
+        // The camera and the sun stay put and only the jitter moves, so the history is never
+        // rejected and the accumulation shows how far each variant converges
+        ReferenceImage render(const Setup& setup, uint32_t frame) {
+            FrameData frameData = setup.frameData;
+            frameData.frame_index = frame;
+            cascades.render(setup.gBuffer, frameData, CascadeSchedule::Split);
+            ReferenceImage irradiance = referenceGatherIrradiance(cascades, setup.gBuffer, frameData, TaskScheduler::shared());
+            const ReferenceImage& accumulated = accumulator.accumulate(irradiance, setup.gBuffer, frameData, TaskScheduler::shared());
+            return applyAlbedo(accumulated, setup.gBuffer, frameData, true, TaskScheduler::shared());
+        }
+    };
+
+    // What the others converge to: twice the rays per side, jittered, and a plain average
+    // over all frames. The variants average the same way, the variance clamp would hold a
+    // still image at the current frame since the gather is too smooth for the neighborhood
+    // to show the noise.
+    ReferenceCascadeSettings referenceSettings;
+    referenceSettings.baseRaysPerDim = 8;
+    referenceSettings.jitterRays = true;
+    TemporalSettings average;
+    average.minBlend = 0.0f;
+    average.varianceClamp = 0.0f;
+    Variant reference("reference", setup, referenceSettings, average);
+    ReferenceImage referenceImage;
+    for (uint32_t frame = 0; frame < options.frames; frame++) {
+        referenceImage = reference.render(setup, frame);
+    }
+    writeImage(setup, referenceImage, "jitter_reference");
+
+    std::vector<std::unique_ptr<Variant>> variants;
+    for (uint32_t raysPerDim : {4u, 2u}) {
+        for (bool jitter : {false, true}) {
+            ReferenceCascadeSettings settings;
+            settings.baseRaysPerDim = raysPerDim;
+            settings.jitterRays = jitter;
+            variants.push_back(std::make_unique<Variant>(std::to_string(raysPerDim) + (jitter ? " jittered" : " fixed"), setup, settings, average));
+        }
+    }
+
+    std::printf("ray jitter over %u frames with accumulation, against %u rays per side jittered and averaged\n",
+                options.frames, referenceSettings.baseRaysPerDim);
+    std::printf("  rays per frame:");
+    for (const auto& variant : variants) {
+        std::printf("  %s %zu", variant->name.c_str(), raysPerFrame(setup, variant->settings));
+    }
+    std::printf("\n  frame");
+    for (const auto& variant : variants) {
+        std::printf("  %11s", variant->name.c_str());
+    }
+    std::printf("   psnr in dB\n");
+
+    for (uint32_t frame = 0; frame < options.frames; frame++) {
+        std::vector<ReferenceImageError> errors;
+        for (auto& variant : variants) {
+            ReferenceImage image = variant->render(setup, frame);
+            errors.push_back(compareImages(image, referenceImage));
+            if (frame + 1 == options.frames) {
+                std::string name = variant->name;
+                std::replace(name.begin(), name.end(), ' ', '_');
+                writeImage(setup, image, "jitter_" + name);
+            }
+        }
+
+        // Powers of two and the last frame are enough to see the convergence
+        if ((frame & (frame + 1)) != 0 && frame + 1 != options.frames) continue;
+        std::printf("  %5u", frame + 1);
+        for (const ReferenceImageError& error : errors) {
+            std::printf("  %11.2f", error.psnr);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
+
+// One camera per line as x y z yaw pitch
+bool loadCameraPath(const char* path, const ReferenceCamera& base, std::vector<ReferenceCamera>& cameras) {
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "Failed to open %s\n", path);
+        return false;
+    }
+
+    ReferenceCamera camera = base;
+    while (file >> camera.position.x >> camera.position.y >> camera.position.z >> camera.yaw >> camera.pitch) {
+        cameras.push_back(camera);
+    }
+    return !cameras.empty();
+}
+
+bool parseOptions(int argc, char** argv, int first, Options& options) {
+    for (int i = first; i < argc; i++) {
+        std::string argument = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if (argument == "--scene") {
+            options.scenePath = value;
+        } else if (argument == "--size") {
+            if (std::sscanf(value, "%ux%u", &options.width, &options.height) != 2) return false;
+            options.sizeGiven = true;
+        } else if (argument == "--camera") {
+            ReferenceCamera& camera = options.camera;
+            if (std::sscanf(value, "%f,%f,%f,%f,%f", &camera.position.x, &camera.position.y, &camera.position.z,
+                            &camera.yaw, &camera.pitch) != 5) return false;
+        } else if (argument == "--frame") {
+            options.frame = uint32_t(std::strtoul(value, nullptr, 10));
+        } else if (argument == "--runs") {
+            options.runs = std::atoi(value);
+        } else if (argument == "--threads") {
+            options.maxThreads = std::strtoul(value, nullptr, 10);
+        } else if (argument == "--out") {
+            options.outDirectory = value;
+        } else if (argument == "--frames") {
+            options.frames = uint32_t(std::strtoul(value, nullptr, 10));
+        } else if (argument == "--budget") {
+            options.budgetMs = std::atof(value);
+        } else if (argument == "--path") {
+            if (!loadCameraPath(value, options.camera, options.path)) return false;
+            options.frames = uint32_t(options.path.size());
+        } else {
+            return false;
+        }
+    }
+    return options.width > 0 && options.height > 0 && options.runs > 0 && options.maxThreads > 0 && options.frames > 0;
+}
+
+void printUsage() {
+    std::fprintf(stderr,
+        "Usage: cascadeReference <command> [options]\n"
+        "  split     Fused trace and merge against tracing all levels at once\n"
+        "  amortize  Per-level refresh rates along a camera path against full updates\n"
+        "  probes    Per-level probe tables against positions reconstructed per ray\n"
+        "  prefilter Merging from prefiltered upper levels against the 16 tap merge\n"
+        "  irradiance Final gather from SH probe irradiance against the ray loop\n"
+        "  density   Coarse cascade 0 probes on flat blocks against uniform probes\n"
+        "  upsample  Half and quarter resolution cascades with joint bilateral upsampling\n"
+        "  classify  Probes skipped on empty tiles in every bundled scene\n"
+        "  temporal  Reprojected and accumulated gather along a camera path\n"
+        "  jitter    Blue noise jittered rays against cell centers, with accumulation\n"
+        "Options: --scene <file> --size <W>x<H> --camera x,y,z,yaw,pitch --frame <n>\n"
+        "         --runs <n> --threads <n> --out <directory> --frames <n> --budget <ms>\n"
+        "         --path <file>\n");
+}
+
+}
+
+int main(int argc, char** argv) {
+    using Command = std::function<int(Setup&)>;
+    const std::vector<std::pair<const char*, Command>> commands = {
+        {"split", commandSplit},
+        {"amortize", commandAmortize},
+        {"probes", commandProbes},
+        {"prefilter", commandPrefilter},
+        {"irradiance", commandIrradiance},
+        {"density", commandDensity},
+        {"upsample", commandUpsample},
+        {"classify", commandClassify},
+        {"temporal", commandTemporal},
+        {"jitter", commandJitter},
+    };
+
+    Setup setup;
+    if (argc < 2 || !parseOptions(argc, argv, 2, setup.options)) {
+        printUsage();
+        return 1;
+    }
+
+    const Command* command = nullptr;
+    for (const auto& [name, body] : commands) {
+        if (std::strcmp(argv[1], name) == 0) command = &body;
+    }
+    if (!command) {
+        printUsage();
+        return 1;
+    }
+
+    auto loadStart = Clock::now();
+    if (!setup.scene.load(setup.options.scenePath)) {
+        return 1;
+    }
+    setup.frameData = makeReferenceFrameData(setup.options.camera, setup.options.width, setup.options.height, setup.options.frame);
+    setup.gBuffer = renderReferenceGBuffer(setup.scene, setup.frameData, TaskScheduler::shared());
+    std::printf("%s: %zu triangles, %ux%u, set up in %.1f ms\n", setup.options.scenePath.c_str(), setup.scene.triangleCount(),
+                setup.options.width, setup.options.height, elapsedMs(loadStart));
+    if (!setup.scene.isComplete()) {
+        std::printf("warning: %zu mesh(es) missing, the results do not describe the full scene\n", setup.scene.missingMeshes().size());
+    }
+
+    return (*command)(setup);
+}
@@ -0,0 +1,82 @@
+// File read benchmark for the loaders' file reader, built next to the renderer.
+//
+//   readBench [--runs N] <file or directory>...
+//
+// Reads every file given, directories recursively, as one batch with io_uring and with the
+// pread fallback, and prints throughput and queue depth for each. Every file gets a cheap
+// checksum as a stand-in for decoding, so callbacks overlap the remaining reads like they
+// do in the loaders. Only the first run of the first backend may come from the device, the
+// rest usually hit the page cache. Drop it between runs to measure the device every time:
+//
+//   sync && echo 3 | sudo tee /proc/sys/vm/drop_caches
+
+#include "fileReader.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+void collectFiles(const std::filesystem::path& path, std::vector<std::string>& files) {
+    if (std::filesystem::is_directory(path)) {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path().string());
+            }
+        }
+    } else if (std::filesystem::is_regular_file(path)) {
+        files.push_back(path.string());
+    }
+}
+
+void bench(FileReader& reader, const std::vector<std::string>& files, int runs) {
+    for (int run = 0; run < runs; run++) {
+        std::atomic<uint64_t> checksum{0};
+        reader.takeStats();
+
+        auto start = std::chrono::steady_clock::now();
+        reader.readAll(files, [&](size_t, std::vector<unsigned char>& bytes, bool) {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < bytes.size(); i += 64) sum += bytes[i];
+            checksum += sum;
+        });
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        FileReadStats stats = reader.takeStats();
+        double MB = stats.bytes / (1024.0 * 1024.0);
+        std::printf("  %-8s run %d  %8.1f MB  %8.1f ms  %8.1f MB/s  depth %5.1f avg %3zu max  %zu failed  checksum %llu\n",
+                    stats.backend, run, MB, ms, MB / (ms / 1000.0), stats.averageQueueDepth, stats.maxQueueDepth,
+                    stats.failed, static_cast<unsigned long long>(checksum.load()));
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    int runs = 3;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--runs" && i + 1 < argc) {
+            runs = std::atoi(argv[++i]);
+        } else {
+            collectFiles(argument, files);
+        }
+    }
+    if (files.empty() || runs <= 0) {
+        std::fprintf(stderr, "Usage: readBench [--runs N] <file or directory>...\n");
+        return 1;
+    }
+
+    std::printf("%zu files\n", files.size());
+
+    FileReader uring(true);
+    bench(uring, files, runs);
+
+    FileReader pread(false);
+    bench(pread, files, runs);
+    return 0;
+}
@@ -0,0 +1,338 @@
+// Command line helpers for scene files, built next to the renderer.
+//
+//   sceneTool bench-parse [runs]        Times the scene readers on generated scenes
+//   sceneTool convert <input> <output>  Converts between JSON and binary scenes
+//   sceneTool diff <old> <new>          Shows what a hot reload from old to new would do
+//   sceneTool generate <output> [...]   Writes a synthetic scene for scaling tests
+
+#include "components/sceneDescription.hpp"
+#include "components/sceneBinary.hpp"
+#include "components/sceneDiff.hpp"
+#include "components/sceneGenerator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Heap usage is tracked through the global allocation operators so both readers can be
+// compared on peak memory, not just time
+std::atomic<size_t> currentHeapBytes{0};
+std::atomic<size_t> peakHeapBytes{0};
+
+constexpr size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+
+void* trackedAllocate(size_t size) {
+    void* block = std::malloc(size + ALLOCATION_HEADER);
+    if (!block) throw std::bad_alloc();
+    *static_cast<size_t*>(block) = size;
+
+    size_t current = currentHeapBytes.fetch_add(size) + size;
+    size_t peak = peakHeapBytes.load();
+    while (current > peak && !peakHeapBytes.compare_exchange_weak(peak, current)) {}
+
+    return static_cast<char*>(block) + ALLOCATION_HEADER;
+}
+
+void trackedFree(void* pointer) {
+    if (!pointer) return;
+    void* block = static_cast<char*>(pointer) - ALLOCATION_HEADER;
+    currentHeapBytes.fetch_sub(*static_cast<size_t*>(block));
+    std::free(block);
+}
+
+}
+
+void* operator new(size_t size) { return trackedAllocate(size); }
+void* operator new[](size_t size) { return trackedAllocate(size); }
+void operator delete(void* pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { trackedFree(pointer); }
+
+namespace {
+
+// Same scenes for every run so the timings can be compared
+void writeBenchmarkScene(const std::filesystem::path& path, size_t objectCount) {
+    SceneGeneratorSettings settings;
+    settings.count = objectCount;
+    settings.jitter = 0.5f;
+
+    SceneDescription scene;
+    generateScene(settings, scene);
+    SceneWriter::writeJSON(path.string(), scene);
+}
+
+struct ParseResult {
+    double  bestMilliseconds = 0.0;
+    size_t  peakBytes = 0;
+    size_t  instances = 0;
+};
+
+ParseResult timeReader(bool (*reader)(const std::string&, SceneDescription&), const std::string& path, int runs) {
+    ParseResult result;
+    for (int run = 0; run < runs; run++) {
+        SceneDescription scene;
+        size_t baseline = currentHeapBytes.load();
+        peakHeapBytes = baseline;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        bool ok = reader(path, scene);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        if (!ok) {
+            std::cerr << "Failed to read " << path << std::endl;
+            std::exit(1);
+        }
+
+        double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+        if (run == 0 || milliseconds < result.bestMilliseconds) {
+            result.bestMilliseconds = milliseconds;
+        }
+        result.peakBytes = std::max(result.peakBytes, peakHeapBytes.load() - baseline);
+        result.instances = scene.instanceCount();
+    }
+    return result;
+}
+
+int benchParse(int runs) {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "sceneToolBench";
+    std::filesystem::create_directories(directory);
+
+    const size_t MB = 1024 * 1024;
+    std::printf("%10s %10s %12s %12s %12s %12s %12s %8s\n",
+                "objects", "file MB", "DOM ms", "SAX ms", "binary ms", "DOM peak MB", "SAX peak MB", "speedup");
+
+    for (size_t objectCount : {size_t(1000), size_t(10000), size_t(100000)}) {
+        std::filesystem::path path = directory / ("scene_" + std::to_string(objectCount) + ".json");
+        writeBenchmarkScene(path, objectCount);
+
+        ParseResult dom = timeReader(&SceneReader::readJSONDom, path.string(), runs);
+        ParseResult sax = timeReader(&SceneReader::readJSON, path.string(), runs);
+
+        SceneDescription scene;
+        SceneReader::readJSON(path.string(), scene);
+        std::filesystem::path binaryPath = path;
+        binaryPath.replace_extension(SCENE_BINARY_EXTENSION);
+        SceneWriter::writeBinary(binaryPath.string(), scene);
+        ParseResult binary = timeReader(&SceneReader::readBinary, binaryPath.string(), runs);
+
+        if (dom.instances != sax.instances || dom.instances != binary.instances) {
+            std::cerr << "Readers disagree: " << dom.instances << " vs " << sax.instances
+                      << " vs " << binary.instances << " instances" << std::endl;
+            return 1;
+        }
+
+        std::printf("%10zu %10.2f %12.2f %12.2f %12.2f %12.2f %12.2f %7.2fx\n",
+                    objectCount,
+                    std::filesystem::file_size(path) / double(MB),
+                    dom.bestMilliseconds, sax.bestMilliseconds, binary.bestMilliseconds,
+                    dom.peakBytes / double(MB), sax.peakBytes / double(MB),
+                    dom.bestMilliseconds / sax.bestMilliseconds);
+    }
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
+
+bool sameVector(simd::float3 a, simd::float3 b) {
+    return std::memcmp(&a, &b, sizeof(float) * 3) == 0;
+}
+
+bool sameScene(const SceneDescription& a, const SceneDescription& b) {
+    if (a.meshNames != b.meshNames || a.meshFiles != b.meshFiles ||
+        a.instanceMeshes != b.instanceMeshes || a.instanceCount() != b.instanceCount()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.instanceCount(); i++) {
+        const MeshInfo& x = a.instances[i];
+        const MeshInfo& y = b.instances[i];
+        if (x.hasTextures != y.hasTextures || x.isEmissive != y.isEmissive ||
+            !sameVector(x.position, y.position) || !sameVector(x.rotation, y.rotation) ||
+            !sameVector(x.scale, y.scale) || !sameVector(x.color, y.color) ||
+            !sameVector(x.emissiveColor, y.emissiveColor)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The output format follows its extension. The result is read back and compared so a
+// conversion that would lose anything fails instead of silently writing a different scene.
+int convert(const std::string& inputPath, const std::string& outputPath) {
+    SceneDescription scene;
+    if (!SceneReader::read(inputPath, scene) || !SceneWriter::write(outputPath, scene)) {
+        return 1;
+    }
+
+    SceneDescription written;
+    if (!SceneReader::read(outputPath, written) || !sameScene(scene, written)) {
+        std::cerr << "Converted scene does not match " << inputPath << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << outputPath << ": " << scene.meshNames.size() << " meshes, "
+              << scene.instanceCount() << " instances" << std::endl;
+    return 0;
+}
+
+// Runs the same diff the engine runs on a hot reload, without a GPU
+int diff(const std::string& previousPath, const std::string& nextPath) {
+    SceneDescription previous;
+    SceneDescription next;
+    if (!SceneReader::read(previousPath, previous) || !SceneReader::read(nextPath, next)) {
+        return 1;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    SceneDiff sceneDiff = SceneDiff::compute(previous, next);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    for (size_t i = 0; i < next.instanceCount(); i++) {
+        uint8_t changes = sceneDiff.changes[i];
+        if (changes == SceneObjectUnchanged) continue;
+
+        std::cout << "  object " << i << " (" << next.meshNames[next.instanceMeshes[i]] << "):";
+        if (changes & SceneObjectAdded)     std::cout << " added";
+        if (changes & SceneObjectRecreated) std::cout << " recreated";
+        if (changes & SceneObjectMoved)     std::cout << " moved";
+        if (changes & SceneObjectRestyled)  std::cout << " restyled";
+        if (sceneDiff.reuseFrom[i] >= 0)    std::cout << ", geometry from object " << sceneDiff.reuseFrom[i];
+        else if (sceneDiff.needsMesh(i))    std::cout << ", geometry loaded from file";
+        std::cout << "\n";
+    }
+    for (uint32_t index : sceneDiff.removed) {
+        std::cout << "  object " << index << " of the old scene (" << previous.meshNames[previous.instanceMeshes[index]]
+                  << "): removed\n";
+    }
+
+    std::cout << sceneDiff.movedCount << " moved, " << sceneDiff.restyledCount << " restyled, "
+              << sceneDiff.createdCount << " created (" << sceneDiff.reusedCount << " from loaded geometry), "
+              << sceneDiff.removed.size() << " removed\n"
+              << "Acceleration structure: "
+              << (sceneDiff.empty() ? "unchanged" : sceneDiff.canRefit() ? "refit" : "rebuild") << "\n"
+              << "Diffed " << next.instanceCount() << " objects in "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    return 0;
+}
+
+void printUsage();
+
+int generate(int argc, char** argv) {
+    std::string outputPath = argv[2];
+    SceneGeneratorSettings settings;
+    bool customMeshes = false;
+
+    for (int i = 3; i < argc; i++) {
+        std::string option = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (option == "--ground") {
+            settings.groundPlane = true;
+        } else if (option == "--count" && hasValue) {
+            settings.count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (option == "--layout" && hasValue) {
+            if (!parseSceneLayout(argv[++i], settings.layout)) {
+                std::cerr << "Unknown layout: " << argv[i] << ", expected grid, cluster or city" << std::endl;
+                return 1;
+            }
+        } else if (option == "--spacing" && hasValue) {
+            settings.spacing = std::strtof(argv[++i], nullptr);
+        } else if (option == "--emissive" && hasValue) {
+            settings.emissiveFraction = std::strtof(argv[++i], nullptr);
+        } else if (option == "--jitter" && hasValue) {
+            settings.jitter = std::strtof(argv[++i], nullptr);
+        } else if (option == "--seed" && hasValue) {
+            settings.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (option == "--mesh" && hasValue) {
+            // name=file, the first --mesh replaces the default cube
+            std::string mesh = argv[++i];
+            size_t separator = mesh.find('=');
+            if (separator == std::string::npos || separator == 0) {
+                std::cerr << "Expected --mesh name=file, got " << mesh << std::endl;
+                return 1;
+            }
+            if (!customMeshes) {
+                settings.meshes.clear();
+                customMeshes = true;
+            }
+            settings.meshes.push_back({mesh.substr(0, separator), mesh.substr(separator + 1)});
+        } else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    SceneDescription scene;
+    generateScene(settings, scene);
+    if (!SceneWriter::write(outputPath, scene)) {
+        return 1;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    size_t emissive = 0;
+    for (const MeshInfo& info : scene.instances) {
+        emissive += info.isEmissive ? 1 : 0;
+    }
+    std::cout << "Wrote " << outputPath << ": " << scene.instanceCount() << " instances in a "
+              << sceneLayoutName(settings.layout) << " layout, " << emissive << " emissive, seed "
+              << settings.seed << " (" << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms)" << std::endl;
+    return 0;
+}
+
+void printUsage() {
+    std::cerr << "Usage: sceneTool <command> [options]\n"
+              << "  bench-parse [runs]        Compare the scene readers (best of runs, default 5)\n"
+              << "  convert <input> <output>  Convert between .json and " << SCENE_BINARY_EXTENSION << " scenes\n"
+              << "  diff <old> <new>          Show what a hot reload from old to new would rebuild\n"
+              << "  generate <output> [options]\n"
+              << "      --count N             Objects to place (default 1000)\n"
+              << "      --layout L            grid, cluster or city (default grid)\n"
+              << "      --spacing S           Distance between neighbours (default 3)\n"
+              << "      --emissive F          Fraction of emissive objects (default 0.05)\n"
+              << "      --jitter J            0 for an exact layout, up to 1 for random offsets, rotation and scale\n"
+              << "      --seed S              Same seed and options give the same scene (default 1)\n"
+              << "      --mesh name=file      Mesh to use, repeat for several (default the bundled cube)\n"
+              << "      --ground              Add a ground quad under the scene\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    std::string command = argv[1];
+    if (command == "bench-parse") {
+        int runs = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+        return benchParse(runs);
+    }
+    if (command == "convert" && argc == 4) {
+        return convert(argv[2], argv[3]);
+    }
+    if (command == "diff" && argc == 4) {
+        return diff(argv[2], argv[3]);
+    }
+    if (command == "generate" && argc >= 3) {
+        return generate(argc, argv);
+    }
+
+    printUsage();
+    return 1;
+}
@@ -0,0 +1,140 @@
+// Microbenchmarks for the task scheduler, built next to the renderer.
+//
+//   schedulerBench [maxThreads] [runs]
+//
+// Measures the cost of spawning empty tasks from outside and from inside the scheduler,
+// the overhead of parallelFor at different grain sizes, and how a compute bound
+// parallelReduce scales from one thread up to maxThreads (64 by default). Thread counts
+// include the calling thread, which takes part in parallelFor and parallelReduce.
+
+#include "taskScheduler.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t SPAWN_COUNT = 200000;
+constexpr size_t FOR_COUNT = 1 << 20;
+constexpr size_t REDUCE_COUNT = 1 << 22;
+constexpr size_t REDUCE_GRAIN = 4096;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Best of several runs, the first one also pays for waking the workers
+template<typename Body>
+double bestOf(int runs, const Body& body) {
+    double best = 0.0;
+    for (int run = 0; run < runs; run++) {
+        auto start = Clock::now();
+        body();
+        double ms = elapsedMs(start);
+        if (run == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+// Enough math per item that the work, not the scheduling, dominates
+double work(size_t i) {
+    double x = static_cast<double>(i) * 1e-6;
+    double sum = 0.0;
+    for (int k = 1; k <= 16; k++) {
+        sum += std::sin(x * k) / k;
+    }
+    return sum;
+}
+
+void benchSpawn(TaskScheduler& scheduler, int runs) {
+    std::vector<TaskHandle> tasks(SPAWN_COUNT);
+
+    double outside = bestOf(runs, [&]() {
+        for (size_t i = 0; i < SPAWN_COUNT; i++) {
+            tasks[i] = scheduler.spawn([]() {});
+        }
+        scheduler.wait(tasks);
+    });
+
+    // One task fans out, its children land on its own deque and get stolen from there
+    double inside = bestOf(runs, [&]() {
+        TaskHandle root = scheduler.spawn([&]() {
+            for (size_t i = 0; i < SPAWN_COUNT; i++) {
+                tasks[i] = scheduler.spawn([]() {});
+            }
+            scheduler.wait(tasks);
+        });
+        scheduler.wait(root);
+    });
+
+    // A chain where every task depends on the previous one
+    double chained = bestOf(runs, [&]() {
+        TaskHandle previous;
+        for (size_t i = 0; i < SPAWN_COUNT; i++) {
+            previous = scheduler.spawn([]() {}, {previous});
+        }
+        scheduler.wait(previous);
+    });
+
+    std::printf("spawn (%zu empty tasks, %zu workers)\n", SPAWN_COUNT, scheduler.threadCount());
+    std::printf("  from outside    %8.1f ns/task\n", outside * 1e6 / SPAWN_COUNT);
+    std::printf("  from a worker   %8.1f ns/task\n", inside * 1e6 / SPAWN_COUNT);
+    std::printf("  dependency chain%8.1f ns/task\n", chained * 1e6 / SPAWN_COUNT);
+}
+
+void benchParallelFor(TaskScheduler& scheduler, int runs) {
+    std::vector<unsigned char> touched(FOR_COUNT);
+
+    std::printf("parallelFor (%zu indices)\n", FOR_COUNT);
+    for (size_t grain : {size_t(1), size_t(64), size_t(1024), size_t(16384)}) {
+        double ms = bestOf(runs, [&]() {
+            scheduler.parallelFor(FOR_COUNT, [&](size_t i) { touched[i] = 1; }, grain);
+        });
+        std::printf("  grain %-6zu     %8.2f ms  %6.1f ns/index\n", grain, ms, ms * 1e6 / FOR_COUNT);
+    }
+}
+
+void benchScaling(size_t maxThreads, int runs) {
+    std::printf("parallelReduce scaling (%zu items, grain %zu)\n", REDUCE_COUNT, REDUCE_GRAIN);
+
+    double single = 0.0;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        TaskScheduler scheduler(threads - 1);
+
+        double result = 0.0;
+        double ms = bestOf(runs, [&]() {
+            result = scheduler.parallelReduce(REDUCE_COUNT, REDUCE_GRAIN, 0.0, [](size_t begin, size_t end) {
+                double sum = 0.0;
+                for (size_t i = begin; i < end; i++) sum += work(i);
+                return sum;
+            }, [](double a, double b) { return a + b; });
+        });
+        if (threads == 1) single = ms;
+
+        // The result is printed in full to show it does not change with the thread count
+        std::printf("  %2zu threads      %8.2f ms  %5.2fx  result %.17g\n", threads, ms, single / ms, result);
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    size_t maxThreads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    int runs = argc > 2 ? std::atoi(argv[2]) : 5;
+    if (maxThreads == 0 || runs <= 0) {
+        std::fprintf(stderr, "Usage: schedulerBench [maxThreads] [runs]\n");
+        return 1;
+    }
+
+    TaskScheduler& scheduler = TaskScheduler::shared();
+    benchSpawn(scheduler, runs);
+    benchParallelFor(scheduler, runs);
+    benchScaling(maxThreads, runs);
+    return 0;
+}